@@ -33,6 +33,8 @@ ifneq ($(firstword $(filter i686-%,$(DUMPMACHINE))),)
   XLDFLAGS += -Wl,--large-address-aware
 endif
 else
+  XCFLAGS += -pthread
+  XLDFLAGS += -pthread
 ifneq ($(findstring -apple-darwin,$(DUMPMACHINE)),)
   DLL_LDFLAGS = -dynamiclib
   DLL_SUFFIX := .dylib
@@ -44,6 +44,143 @@ HASHSET_API const char *const HASHSET_BUILD_TIME;
 
 #endif /*_LIBHASHSET_GLOBALS_DEFINED*/
 
+/* ------------------------------------------------- */
+/* Options                                           */
+/* ------------------------------------------------- */
+
+#ifndef _LIBHASHSET_OPTIONS_DEFINED
+#define _LIBHASHSET_OPTIONS_DEFINED
+
+typedef enum
+{
+	HASHSET_HASH_DEFAULT = 0,
+	HASHSET_HASH_FNV1A = 1,
+	HASHSET_HASH_MIX64 = 2,
+	HASHSET_HASH_SIPHASH13 = 3,
+	HASHSET_HASH_CRC32C = 4,
+	HASHSET_HASH_AESNI = 5
+}
+hash_function_t;
+
+typedef enum
+{
+	HASHSET_PROBE_DEFAULT = 0,
+	HASHSET_PROBE_DOUBLE = 1,
+	HASHSET_PROBE_LINEAR = 2,
+	HASHSET_PROBE_QUADRATIC = 3
+}
+hash_probe_t;
+
+typedef enum
+{
+	HASHSET_ENGINE_DEFAULT = 0,
+	HASHSET_ENGINE_BITMAP = 1,
+	HASHSET_ENGINE_SWISS = 2,
+	HASHSET_ENGINE_ROBINHOOD = 3,
+	HASHSET_ENGINE_CUCKOO = 4,
+	HASHSET_ENGINE_SENTINEL = 5
+}
+hash_engine_t;
+
+typedef enum
+{
+	HASHSET_LAYOUT_DEFAULT = 0,
+	HASHSET_LAYOUT_AOS = 1,
+	HASHSET_LAYOUT_SOA = 2
+}
+hash_layout_t;
+
+typedef enum
+{
+	HASHSET_DUPLICATES_IGNORE = 0,
+	HASHSET_DUPLICATES_UPDATE = 1,
+	HASHSET_DUPLICATES_FAIL = 2
+}
+hash_duplicates_t;
+
+typedef enum
+{
+	HASHSET_RESIZE_DEFAULT = 0,
+	HASHSET_RESIZE_BLOCKING = 1,
+	HASHSET_RESIZE_INCREMENTAL = 2
+}
+hash_resize_t;
+
+typedef enum
+{
+	HASHSET_SHRINK_DEFAULT = 0,
+	HASHSET_SHRINK_AUTO = 1,
+	HASHSET_SHRINK_KEEP_ON_CLEAR = 2,
+	HASHSET_SHRINK_NEVER = 3
+}
+hash_shrink_t;
+
+typedef enum
+{
+	HASHSET_MEMORY_DEFAULT = 0,
+	HASHSET_MEMORY_HEAP = 1,
+	HASHSET_MEMORY_MMAP = 2,
+	HASHSET_MEMORY_HUGEPAGES = 3
+}
+hash_memory_t;
+
+typedef enum
+{
+	HASHSET_NUMA_DEFAULT = 0,
+	HASHSET_NUMA_INTERLEAVE = 1,
+	HASHSET_NUMA_BIND = 2,
+	HASHSET_NUMA_FIRST_TOUCH = 3
+}
+hash_numa_t;
+
+typedef enum
+{
+	HASHSET_CONCURRENCY_DEFAULT = 0,
+	HASHSET_CONCURRENCY_NONE = 1,
+	HASHSET_CONCURRENCY_READERS = 2
+}
+hash_concurrency_t;
+
+typedef enum
+{
+	HASHSET_LOAD_DEFAULT = 0,
+	HASHSET_LOAD_READ = 1,
+	HASHSET_LOAD_MMAP = 2
+}
+hash_load_t;
+
+typedef struct
+{
+	void *(*alloc)(void *const context, const size_t size);
+	void *(*zero_alloc)(void *const context, const size_t count, const size_t size);
+	void (*free)(void *const context, void *const addr);
+	void *context;
+}
+hash_allocator_t;
+
+typedef struct
+{
+	hash_function_t hash_function;
+	hash_probe_t probe_strategy;
+	hash_engine_t engine;
+	hash_layout_t layout;
+	size_t thread_count;
+	hash_resize_t resize;
+	double growth_factor;
+	hash_shrink_t shrink;
+	double shrink_threshold;
+	hash_memory_t memory;
+	int prefault;
+	const hash_allocator_t *allocator;
+	hash_numa_t numa;
+	size_t numa_node;
+	hash_concurrency_t concurrency;
+	size_t shard_count;
+}
+hash_options_t;
+
+#endif /*_LIBHASHSET_OPTIONS_DEFINED*/
+
 /* ------------------------------------------------- */
 /* Types                                             */
 /* ------------------------------------------------- */
@@ -56,10 +193,38 @@ typedef struct _hash_set16 hash_set16_t;
 typedef struct _hash_set32 hash_set32_t;
 typedef struct _hash_set64 hash_set64_t;
 
+struct _hash_set_reader16;
+struct _hash_set_reader32;
+struct _hash_set_reader64;
+
+typedef struct _hash_set_reader16 hash_set_reader16_t;
+typedef struct _hash_set_reader32 hash_set_reader32_t;
+typedef struct _hash_set_reader64 hash_set_reader64_t;
+
+struct _hash_set_concurrent16;
+struct _hash_set_concurrent32;
+struct _hash_set_concurrent64;
+
+typedef struct _hash_set_concurrent16 hash_set_concurrent16_t;
+typedef struct _hash_set_concurrent32 hash_set_concurrent32_t;
+typedef struct _hash_set_concurrent64 hash_set_concurrent64_t;
+
+struct _hash_set_lockfree16;
+struct _hash_set_lockfree32;
+struct _hash_set_lockfree64;
+
+typedef struct _hash_set_lockfree16 hash_set_lockfree16_t;
+typedef struct _hash_set_lockfree32 hash_set_lockfree32_t;
+typedef struct _hash_set_lockfree64 hash_set_lockfree64_t;
+
 typedef int (*hash_set_callback16_t)(const size_t index, const char status, const uint16_t item);
 typedef int (*hash_set_callback32_t)(const size_t index, const char status, const uint32_t item);
 typedef int (*hash_set_callback64_t)(const size_t index, const char status, const uint64_t item);
 
+typedef int (*hash_set_worker16_t)(const uint16_t *const items, const size_t count, const size_t part, void *const context);
+typedef int (*hash_set_worker32_t)(const uint32_t *const items, const size_t count, const size_t part, void *const context);
+typedef int (*hash_set_worker64_t)(const uint64_t *const items, const size_t count, const size_t part, void *const context);
+
 /* ------------------------------------------------- */
 /* Functions                                         */
 /* ------------------------------------------------- */
@@ -68,6 +233,18 @@ HASHSET_API hash_set16_t *hash_set_create16(const size_t initial_capacity, const
 HASHSET_API hash_set32_t *hash_set_create32(const size_t initial_capacity, const double load_factor, const uint64_t seed);
 HASHSET_API hash_set64_t *hash_set_create64(const size_t initial_capacity, const double load_factor, const uint64_t seed);
 
+HASHSET_API hash_set16_t *hash_set_create_ex16(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set32_t *hash_set_create_ex32(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set64_t *hash_set_create_ex64(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+
+HASHSET_API hash_set16_t *hash_set_create_from_array16(const uint16_t *const items, const size_t count, const double load_factor, const uint64_t seed, const hash_options_t *const options, const hash_duplicates_t duplicates);
+HASHSET_API hash_set32_t *hash_set_create_from_array32(const uint32_t *const items, const size_t count, const double load_factor, const uint64_t seed, const hash_options_t *const options, const hash_duplicates_t duplicates);
+HASHSET_API hash_set64_t *hash_set_create_from_array64(const uint64_t *const items, const size_t count, const double load_factor, const uint64_t seed, const hash_options_t *const options, const hash_duplicates_t duplicates);
+
+HASHSET_API hash_set16_t *hash_set_init_in_buffer16(void *const buffer, const size_t size, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set32_t *hash_set_init_in_buffer32(void *const buffer, const size_t size, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set64_t *hash_set_init_in_buffer64(void *const buffer, const size_t size, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+
 HASHSET_API void hash_set_destroy16(hash_set16_t *const instance);
 HASHSET_API void hash_set_destroy32(hash_set32_t *const instance);
 HASHSET_API void hash_set_destroy64(hash_set64_t *const instance);
@@ -76,22 +253,62 @@ HASHSET_API errno_t hash_set_insert16(hash_set16_t *const instance, const uint16
 HASHSET_API errno_t hash_set_insert32(hash_set32_t *const instance, const uint32_t item);
 HASHSET_API errno_t hash_set_insert64(hash_set64_t *const instance, const uint64_t item);
 
+HASHSET_API errno_t hash_set_insert_batch16(hash_set16_t *const instance, const uint16_t *const items, const size_t count, uint8_t *const inserted);
+HASHSET_API errno_t hash_set_insert_batch32(hash_set32_t *const instance, const uint32_t *const items, const size_t count, uint8_t *const inserted);
+HASHSET_API errno_t hash_set_insert_batch64(hash_set64_t *const instance, const uint64_t *const items, const size_t count, uint8_t *const inserted);
+
 HASHSET_API errno_t hash_set_remove16(hash_set16_t *const instance, const uint16_t item);
 HASHSET_API errno_t hash_set_remove32(hash_set32_t *const instance, const uint32_t item);
 HASHSET_API errno_t hash_set_remove64(hash_set64_t *const instance, const uint64_t item);
 
+HASHSET_API errno_t hash_set_remove_batch16(hash_set16_t *const instance, const uint16_t *const items, const size_t count, uint8_t *const removed);
+HASHSET_API errno_t hash_set_remove_batch32(hash_set32_t *const instance, const uint32_t *const items, const size_t count, uint8_t *const removed);
+HASHSET_API errno_t hash_set_remove_batch64(hash_set64_t *const instance, const uint64_t *const items, const size_t count, uint8_t *const removed);
+
 HASHSET_API errno_t hash_set_clear16(hash_set16_t *const instance);
 HASHSET_API errno_t hash_set_clear32(hash_set32_t *const instance);
 HASHSET_API errno_t hash_set_clear64(hash_set64_t *const instance);
 
+HASHSET_API errno_t hash_set_reserve16(hash_set16_t *const instance, const size_t count);
+HASHSET_API errno_t hash_set_reserve32(hash_set32_t *const instance, const size_t count);
+HASHSET_API errno_t hash_set_reserve64(hash_set64_t *const instance, const size_t count);
+
+HASHSET_API errno_t hash_set_shrink_to_fit16(hash_set16_t *const instance);
+HASHSET_API errno_t hash_set_shrink_to_fit32(hash_set32_t *const instance);
+HASHSET_API errno_t hash_set_shrink_to_fit64(hash_set64_t *const instance);
+
 HASHSET_API errno_t hash_set_contains16(const hash_set16_t *const instance, const uint16_t item);
 HASHSET_API errno_t hash_set_contains32(const hash_set32_t *const instance, const uint32_t item);
 HASHSET_API errno_t hash_set_contains64(const hash_set64_t *const instance, const uint64_t item);
 
+HASHSET_API errno_t hash_set_contains_batch16(const hash_set16_t *const instance, const uint16_t *const items, const size_t count, uint8_t *const found);
+HASHSET_API errno_t hash_set_contains_batch32(const hash_set32_t *const instance, const uint32_t *const items, const size_t count, uint8_t *const found);
+HASHSET_API errno_t hash_set_contains_batch64(const hash_set64_t *const instance, const uint64_t *const items, const size_t count, uint8_t *const found);
+
+HASHSET_API void hash_set_prefetch16(const hash_set16_t *const instance, const uint16_t item);
+HASHSET_API void hash_set_prefetch32(const hash_set32_t *const instance, const uint32_t item);
+HASHSET_API void hash_set_prefetch64(const hash_set64_t *const instance, const uint64_t item);
+
 HASHSET_API errno_t hash_set_iterate16(const hash_set16_t *const instance, size_t *const cursor, uint16_t *const item);
 HASHSET_API errno_t hash_set_iterate32(const hash_set32_t *const instance, size_t *const cursor, uint32_t *const item);
 HASHSET_API errno_t hash_set_iterate64(const hash_set64_t *const instance, size_t *const cursor, uint64_t *const item);
 
+HASHSET_API errno_t hash_set_iterate_batch16(const hash_set16_t *const instance, size_t *const cursor, uint16_t *const items, const size_t capacity, size_t *const count);
+HASHSET_API errno_t hash_set_iterate_batch32(const hash_set32_t *const instance, size_t *const cursor, uint32_t *const items, const size_t capacity, size_t *const count);
+HASHSET_API errno_t hash_set_iterate_batch64(const hash_set64_t *const instance, size_t *const cursor, uint64_t *const items, const size_t capacity, size_t *const count);
+
+HASHSET_API errno_t hash_set_split16(const hash_set16_t *const instance, const size_t parts, size_t *const bounds);
+HASHSET_API errno_t hash_set_split32(const hash_set32_t *const instance, const size_t parts, size_t *const bounds);
+HASHSET_API errno_t hash_set_split64(const hash_set64_t *const instance, const size_t parts, size_t *const bounds);
+
+HASHSET_API errno_t hash_set_iterate_range16(const hash_set16_t *const instance, size_t *const cursor, const size_t end, uint16_t *const items, const size_t capacity, size_t *const count);
+HASHSET_API errno_t hash_set_iterate_range32(const hash_set32_t *const instance, size_t *const cursor, const size_t end, uint32_t *const items, const size_t capacity, size_t *const count);
+HASHSET_API errno_t hash_set_iterate_range64(const hash_set64_t *const instance, size_t *const cursor, const size_t end, uint64_t *const items, const size_t capacity, size_t *const count);
+
+HASHSET_API errno_t hash_set_parallel_for16(const hash_set16_t *const instance, const size_t threads, const hash_set_worker16_t callback, void *const context);
+HASHSET_API errno_t hash_set_parallel_for32(const hash_set32_t *const instance, const size_t threads, const hash_set_worker32_t callback, void *const context);
+HASHSET_API errno_t hash_set_parallel_for64(const hash_set64_t *const instance, const size_t threads, const hash_set_worker64_t callback, void *const context);
+
 HASHSET_API size_t hash_set_size16(const hash_set16_t *const instance);
 HASHSET_API size_t hash_set_size32(const hash_set32_t *const instance);
 HASHSET_API size_t hash_set_size64(const hash_set64_t *const instance);
@@ -104,6 +321,74 @@ HASHSET_API errno_t hash_set_dump16(const hash_set16_t *const instance, const ha
 HASHSET_API errno_t hash_set_dump32(const hash_set32_t *const instance, const hash_set_callback32_t callback);
 HASHSET_API errno_t hash_set_dump64(const hash_set64_t *const instance, const hash_set_callback64_t callback);
 
+HASHSET_API errno_t hash_set_save16(hash_set16_t *const instance, const int fd);
+HASHSET_API errno_t hash_set_save32(hash_set32_t *const instance, const int fd);
+HASHSET_API errno_t hash_set_save64(hash_set64_t *const instance, const int fd);
+
+HASHSET_API hash_set16_t *hash_set_load16(const int fd, const hash_load_t mode, const hash_options_t *const options);
+HASHSET_API hash_set32_t *hash_set_load32(const int fd, const hash_load_t mode, const hash_options_t *const options);
+HASHSET_API hash_set64_t *hash_set_load64(const int fd, const hash_load_t mode, const hash_options_t *const options);
+
+HASHSET_API hash_set_reader16_t *hash_set_reader_attach16(hash_set16_t *const instance);
+HASHSET_API hash_set_reader32_t *hash_set_reader_attach32(hash_set32_t *const instance);
+HASHSET_API hash_set_reader64_t *hash_set_reader_attach64(hash_set64_t *const instance);
+
+HASHSET_API void hash_set_reader_detach16(hash_set_reader16_t *const reader);
+HASHSET_API void hash_set_reader_detach32(hash_set_reader32_t *const reader);
+HASHSET_API void hash_set_reader_detach64(hash_set_reader64_t *const reader);
+
+HASHSET_API errno_t hash_set_reader_contains16(hash_set_reader16_t *const reader, const uint16_t item);
+HASHSET_API errno_t hash_set_reader_contains32(hash_set_reader32_t *const reader, const uint32_t item);
+HASHSET_API errno_t hash_set_reader_contains64(hash_set_reader64_t *const reader, const uint64_t item);
+
+HASHSET_API hash_set_concurrent16_t *hash_set_concurrent_create16(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set_concurrent32_t *hash_set_concurrent_create32(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set_concurrent64_t *hash_set_concurrent_create64(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+
+HASHSET_API void hash_set_concurrent_destroy16(hash_set_concurrent16_t *const instance);
+HASHSET_API void hash_set_concurrent_destroy32(hash_set_concurrent32_t *const instance);
+HASHSET_API void hash_set_concurrent_destroy64(hash_set_concurrent64_t *const instance);
+
+HASHSET_API errno_t hash_set_concurrent_insert16(hash_set_concurrent16_t *const instance, const uint16_t item);
+HASHSET_API errno_t hash_set_concurrent_insert32(hash_set_concurrent32_t *const instance, const uint32_t item);
+HASHSET_API errno_t hash_set_concurrent_insert64(hash_set_concurrent64_t *const instance, const uint64_t item);
+
+HASHSET_API errno_t hash_set_concurrent_remove16(hash_set_concurrent16_t *const instance, const uint16_t item);
+HASHSET_API errno_t hash_set_concurrent_remove32(hash_set_concurrent32_t *const instance, const uint32_t item);
+HASHSET_API errno_t hash_set_concurrent_remove64(hash_set_concurrent64_t *const instance, const uint64_t item);
+
+HASHSET_API errno_t hash_set_concurrent_contains16(hash_set_concurrent16_t *const instance, const uint16_t item);
+HASHSET_API errno_t hash_set_concurrent_contains32(hash_set_concurrent32_t *const instance, const uint32_t item);
+HASHSET_API errno_t hash_set_concurrent_contains64(hash_set_concurrent64_t *const instance, const uint64_t item);
+
+HASHSET_API errno_t hash_set_concurrent_clear16(hash_set_concurrent16_t *const instance);
+HASHSET_API errno_t hash_set_concurrent_clear32(hash_set_concurrent32_t *const instance);
+HASHSET_API errno_t hash_set_concurrent_clear64(hash_set_concurrent64_t *const instance);
+
+HASHSET_API size_t hash_set_concurrent_size16(hash_set_concurrent16_t *const instance);
+HASHSET_API size_t hash_set_concurrent_size32(hash_set_concurrent32_t *const instance);
+HASHSET_API size_t hash_set_concurrent_size64(hash_set_concurrent64_t *const instance);
+
+HASHSET_API hash_set_lockfree16_t *hash_set_lockfree_create16(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set_lockfree32_t *hash_set_lockfree_create32(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+HASHSET_API hash_set_lockfree64_t *hash_set_lockfree_create64(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options);
+
+HASHSET_API void hash_set_lockfree_destroy16(hash_set_lockfree16_t *const instance);
+HASHSET_API void hash_set_lockfree_destroy32(hash_set_lockfree32_t *const instance);
+HASHSET_API void hash_set_lockfree_destroy64(hash_set_lockfree64_t *const instance);
+
+HASHSET_API errno_t hash_set_lockfree_insert16(hash_set_lockfree16_t *const instance, const uint16_t item);
+HASHSET_API errno_t hash_set_lockfree_insert32(hash_set_lockfree32_t *const instance, const uint32_t item);
+HASHSET_API errno_t hash_set_lockfree_insert64(hash_set_lockfree64_t *const instance, const uint64_t item);
+
+HASHSET_API errno_t hash_set_lockfree_contains16(const hash_set_lockfree16_t *const instance, const uint16_t item);
+HASHSET_API errno_t hash_set_lockfree_contains32(const hash_set_lockfree32_t *const instance, const uint32_t item);
+HASHSET_API errno_t hash_set_lockfree_contains64(const hash_set_lockfree64_t *const instance, const uint64_t item);
+
+HASHSET_API size_t hash_set_lockfree_size16(const hash_set_lockfree16_t *const instance);
+HASHSET_API size_t hash_set_lockfree_size32(const hash_set_lockfree32_t *const instance);
+HASHSET_API size_t hash_set_lockfree_size64(const hash_set_lockfree64_t *const instance);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,7 @@
 #define _LIBHASHSET_COMMON_INCLUDED
 
 /* CRT */
+#include <stdio.h>
 #include <string.h>
 #include <errno.h>
 #include <math.h>
@@ -14,6 +15,20 @@
 #include <float.h>
 #include <assert.h>
 
+/* Platform */
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#  include <io.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  if defined(__linux__)
+#    include <sys/syscall.h>
+#  endif
+#endif
+
 typedef int bool_t;
 #define TRUE  1
 #define FALSE 0
@@ -49,6 +64,15 @@ static const double DEFAULT_LOADFCTR =  0.75;
 #define _CONCAT(X,Y) X##Y
 #define CONCAT(X,Y) _CONCAT(X,Y)
 
+#if defined(__GNUC__)
+#  define PREFETCH(X) __builtin_prefetch((X))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <xmmintrin.h>
+#  define PREFETCH(X) _mm_prefetch((const char*)(X), _MM_HINT_T0)
+#else
+#  define PREFETCH(X) ((void)0)
+#endif
+
 /* ------------------------------------------------- */
 /* Math                                              */
 /* ------------------------------------------------- */
@@ -102,10 +126,49 @@ static FORCE_INLINE size_t next_pow2(const size_t target)
 	return result;
 }
 
+/* capacities are powers of two, so the growth factor is rounded up to the next power of two */
+static INLINE size_t growth_multiplier(const double factor)
+{
+	const double bounded = (factor > DBL_EPSILON) ? BOUND(2.0, factor, 65536.0) : 2.0;
+	size_t result = 2U;
+
+	while (((double)result) < bounded)
+	{
+		result *= 2U;
+	}
+
+	return result;
+}
+
 /* ------------------------------------------------- */
-/* Hash function                                     */
+/* Hash functions                                    */
 /* ------------------------------------------------- */
 
+#if (defined(__GNUC__) || defined(_MSC_VER)) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#  define HAVE_X86_HASH 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define TARGET_SSE42
+#    define TARGET_AESNI
+#  else
+#    include <nmmintrin.h>
+#    include <wmmintrin.h>
+#    define TARGET_SSE42 __attribute__((target("sse4.2")))
+#    define TARGET_AESNI __attribute__((target("sse2,aes")))
+#  endif
+#endif
+
+#define ROTL64(X,N) (((X) << (N)) | ((X) >> (64 - (N))))
+
+typedef struct
+{
+	hash_function_t function;
+	hash_probe_t probe;
+	uint64_t basis, key;
+}
+hash_param_t;
+
+/* FNV-1a, processes one byte at a time (legacy) */
 static FORCE_INLINE void hash_update(uint64_t *const hash, uint64_t value)
 {
 	do
@@ -116,46 +179,1800 @@ static FORCE_INLINE void hash_update(uint64_t *const hash, uint64_t value)
 	while (value >>= CHAR_BIT);
 }
 
-static INLINE uint64_t hash_initialize(const uint64_t seed)
+static FORCE_INLINE uint64_t hash_fnv1a(const uint64_t basis, const uint64_t value)
 {
-	uint64_t hash = UINT64_C(14695981039346656037);
-	hash_update(&hash, seed);
+	uint64_t hash = basis;
+	hash_update(&hash, value);
 	return hash;
 }
 
-static INLINE uint64_t hash_compute(uint64_t hash, const uint64_t i, const uint64_t value)
+/* "rrmxmx" finalizer by Pelle Evensen, processes one word at a time */
+static FORCE_INLINE uint64_t hash_mix(uint64_t value)
 {
-	hash_update(&hash, i);
-	hash_update(&hash, value);
-	return hash;
+	value ^= ROTL64(value, 15) ^ ROTL64(value, 40);
+	value *= UINT64_C(0x9FB21C651E98DF25);
+	value ^= value >> 35;
+	value *= UINT64_C(0x9FB21C651E98DF25);
+	return value ^ (value >> 28);
+}
+
+static FORCE_INLINE uint64_t hash_mix64(const uint64_t basis, const uint64_t value)
+{
+	return hash_mix(value ^ basis);
+}
+
+/* SipHash-1-3, for resistance against "hash flooding" attacks; both halves of its key (k0, k1) are derived from the 64-Bit seed, so the effective key size is 64-Bit */
+#define SIPROUND(V0,V1,V2,V3) do \
+{ \
+	V0 += V1; V1 = ROTL64(V1, 13); V1 ^= V0; V0 = ROTL64(V0, 32); \
+	V2 += V3; V3 = ROTL64(V3, 16); V3 ^= V2; \
+	V0 += V3; V3 = ROTL64(V3, 21); V3 ^= V0; \
+	V2 += V1; V1 = ROTL64(V1, 17); V1 ^= V2; V2 = ROTL64(V2, 32); \
+} \
+while(0)
+
+static FORCE_INLINE uint64_t hash_siphash13(const uint64_t k0, const uint64_t k1, const uint64_t value)
+{
+	uint64_t v0 = k0 ^ UINT64_C(0x736F6D6570736575), v1 = k1 ^ UINT64_C(0x646F72616E646F6D);
+	uint64_t v2 = k0 ^ UINT64_C(0x6C7967656E657261), v3 = k1 ^ UINT64_C(0x7465646279746573);
+	const uint64_t last = UINT64_C(8) << 56;
+
+	v3 ^= value; SIPROUND(v0, v1, v2, v3); v0 ^= value;
+	v3 ^= last;  SIPROUND(v0, v1, v2, v3); v0 ^= last;
+
+	v2 ^= 0xFF;
+	SIPROUND(v0, v1, v2, v3);
+	SIPROUND(v0, v1, v2, v3);
+	SIPROUND(v0, v1, v2, v3);
+
+	return v0 ^ v1 ^ v2 ^ v3;
+}
+
+#ifdef HAVE_X86_HASH
+
+/* CRC-32C, requires SSE 4.2 support */
+static TARGET_SSE42 INLINE uint64_t hash_crc32c(const uint64_t basis, const uint64_t key, const uint64_t value)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	const uint64_t lo = _mm_crc32_u64(basis, value);
+	const uint64_t hi = _mm_crc32_u64(key, ROTL64(value, 32));
+#else
+	const uint64_t lo = _mm_crc32_u32(_mm_crc32_u32((uint32_t)basis, (uint32_t)value), (uint32_t)(value >> 32));
+	const uint64_t hi = _mm_crc32_u32(_mm_crc32_u32((uint32_t)key, (uint32_t)(value >> 32)), (uint32_t)value);
+#endif
+	return ((hi << 32) | (lo & UINT32_MAX)) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+/* Two AES rounds, requires AES-NI support */
+static TARGET_AESNI INLINE uint64_t hash_aesni(const uint64_t basis, const uint64_t key, const uint64_t value)
+{
+	const __m128i round_key = _mm_set_epi32((int)(key >> 32), (int)key, (int)(basis >> 32), (int)basis);
+	__m128i state = _mm_set_epi32((int)(value >> 32), (int)value, (int)(value >> 32), (int)value);
+	state = _mm_aesenc_si128(_mm_xor_si128(state, round_key), round_key);
+	state = _mm_aesenc_si128(state, round_key);
+	return ((uint64_t)(uint32_t)_mm_cvtsi128_si32(state)) | (((uint64_t)(uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(state, 4))) << 32);
+}
+
+#endif /*HAVE_X86_HASH*/
+
+static INLINE bool_t hash_supported(const hash_function_t function)
+{
+	switch (function)
+	{
+	case HASHSET_HASH_FNV1A:
+	case HASHSET_HASH_MIX64:
+	case HASHSET_HASH_SIPHASH13:
+		return TRUE;
+#ifdef HAVE_X86_HASH
+#if defined(_MSC_VER)
+	case HASHSET_HASH_CRC32C:
+	case HASHSET_HASH_AESNI:
+		{
+			int info[4U];
+			__cpuid(info, 1);
+			return (info[2U] >> ((function == HASHSET_HASH_CRC32C) ? 20U : 25U)) & 1;
+		}
+#else
+	case HASHSET_HASH_CRC32C:
+		return __builtin_cpu_supports("sse4.2") ? TRUE : FALSE;
+	case HASHSET_HASH_AESNI:
+		return __builtin_cpu_supports("aes") ? TRUE : FALSE;
+#endif
+#endif
+	default:
+		return FALSE;
+	}
+}
+
+static INLINE void hash_initialize(hash_param_t *const param, const hash_function_t function, const hash_probe_t probe, const uint64_t seed)
+{
+	param->function = ((function != HASHSET_HASH_DEFAULT) && hash_supported(function)) ? function : HASHSET_HASH_MIX64;
+	param->probe = ((probe > HASHSET_PROBE_DEFAULT) && (probe <= HASHSET_PROBE_QUADRATIC)) ? probe : HASHSET_PROBE_DOUBLE;
+	param->basis = UINT64_C(14695981039346656037);
+	hash_update(&param->basis, seed);
+	param->key = hash_mix(param->basis ^ SEED);
+}
+
+static FORCE_INLINE uint64_t hash_compute(const hash_param_t *const param, const uint64_t value)
+{
+	switch (param->function)
+	{
+	case HASHSET_HASH_FNV1A:
+		return hash_fnv1a(param->basis, value);
+	case HASHSET_HASH_SIPHASH13:
+		return hash_siphash13(param->basis, param->key, value);
+#ifdef HAVE_X86_HASH
+	case HASHSET_HASH_CRC32C:
+		return hash_crc32c(param->basis, param->key, value);
+	case HASHSET_HASH_AESNI:
+		return hash_aesni(param->basis, param->key, value);
+#endif
+	default:
+		return hash_mix64(param->basis, value);
+	}
+}
+
+/* ------------------------------------------------- */
+/* Probing                                           */
+/* ------------------------------------------------- */
+
+typedef struct
+{
+	size_t index, step, delta;
+}
+probe_t;
+
+/* capacity must be a power of two, so that the probe sequence visits every slot */
+static FORCE_INLINE void probe_init(probe_t *const probe, const hash_param_t *const param, const uint64_t hash, const size_t capacity)
+{
+	probe->index = ((size_t)hash) & (capacity - 1U);
+
+	switch (param->probe)
+	{
+	case HASHSET_PROBE_LINEAR:
+		probe->step = 1U;
+		probe->delta = 0U;
+		break;
+	case HASHSET_PROBE_QUADRATIC:
+		probe->step = 1U;
+		probe->delta = 1U;
+		break;
+	default:
+		probe->step = ((size_t)ROTL64(hash, 32)) | 1U;
+		probe->delta = 0U;
+	}
+}
+
+static FORCE_INLINE size_t probe_peek(const probe_t *const probe, const size_t capacity)
+{
+	return (probe->index + probe->step) & (capacity - 1U);
+}
+
+static FORCE_INLINE void probe_next(probe_t *const probe, const size_t capacity)
+{
+	probe->index = (probe->index + probe->step) & (capacity - 1U);
+	probe->step += probe->delta;
+}
+
+/* same as calling probe_next() the given number of times */
+static FORCE_INLINE void probe_skip(probe_t *const probe, const size_t steps, const size_t capacity)
+{
+	probe->index = (probe->index + (steps * probe->step) + (probe->delta * ((steps * (steps - 1U)) / 2U))) & (capacity - 1U);
+	probe->step += steps * probe->delta;
+}
+
+/* number of items whose slots are prefetched ahead of the current item by the batch functions */
+#define PREFETCH_DISTANCE 16U
+
+/* number of slots of the old table that are migrated by each insert or remove operation, while an incremental resize is in progress */
+#define MIGRATE_SLOTS 64U
+
+/* ------------------------------------------------- */
+/* Threads                                           */
+/* ------------------------------------------------- */
+
+#if defined(_WIN32)
+#  define TASK_ENTRY DWORD WINAPI
+#  define TASK_RESULT 0U
+typedef HANDLE thread_t;
+#else
+#  include <pthread.h>
+#  include <sched.h>
+#  define TASK_ENTRY void*
+#  define TASK_RESULT NULL
+typedef pthread_t thread_t;
+#endif
+
+#define MAX_THREADS 64U
+
+/* minimum number of items per worker thread, and minimum number of slots per table region */
+#define PARALLEL_MIN_ITEMS 65536U
+#define PARALLEL_MIN_SLOTS 64U
+
+/* a partitioned build runs another round of threads on the deferred items, as long as at least this many of them can be resumed */
+#define PARALLEL_MIN_DEFERRED 4096U
+
+/* a partitioned build processes the input in chunks of at most this many positions, which bounds the size of its scratch buffer */
+#define PARALLEL_CHUNK 1048576U
+
+typedef void (*task_func_t)(void *const context);
+
+typedef struct
+{
+	task_func_t func;
+	void *context;
+}
+task_t;
+
+static TASK_ENTRY task_entry(void *const param)
+{
+	const task_t *const task = (const task_t*) param;
+	task->func(task->context);
+	return TASK_RESULT;
+}
+
+static INLINE size_t cpu_count(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0U) ? (size_t)info.dwNumberOfProcessors : 1U;
+#else
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0L) ? (size_t)count : 1U;
+#endif
+}
+
+/* gives up the remainder of the time slice, while waiting for another thread */
+static INLINE void thread_yield(void)
+{
+#if defined(_WIN32)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+static INLINE size_t thread_count(const size_t requested)
+{
+	const size_t count = requested ? requested : cpu_count();
+	return BOUND(1U, count, MAX_THREADS);
+}
+
+/* number of threads to be used for processing "count" items, which is 1, if the input is too small to benefit from multiple threads */
+static INLINE size_t parallel_threads(const size_t threads, const size_t count)
+{
+	const size_t max_threads = count / PARALLEL_MIN_ITEMS;
+	return (count >= 2U * PARALLEL_MIN_ITEMS) ? ((threads < max_threads) ? threads : max_threads) : 1U;
+}
+
+/* start of the k-th of "parts" ranges that the given number of slots is divided into, aligned to PARALLEL_MIN_SLOTS */
+static INLINE size_t range_begin(const size_t slots, const size_t k, const size_t parts)
+{
+	return (size_t)((((uint64_t)(slots / PARALLEL_MIN_SLOTS)) * k) / parts) * PARALLEL_MIN_SLOTS;
+}
+
+/* runs "func" for each of the "count" contexts concurrently; the first task, as well as any task whose thread could not be created, runs on the calling thread */
+static INLINE void run_tasks(const task_func_t func, void *const contexts, const size_t context_size, const size_t count)
+{
+	task_t tasks[MAX_THREADS];
+	thread_t threads[MAX_THREADS];
+	bool_t started[MAX_THREADS];
+	size_t k;
+
+	assert((count > 0U) && (count <= MAX_THREADS));
+
+	for (k = 1U; k < count; ++k)
+	{
+		tasks[k].func = func;
+		tasks[k].context = ((uint8_t*)contexts) + (k * context_size);
+#if defined(_WIN32)
+		started[k] = ((threads[k] = CreateThread(NULL, 0U, task_entry, &tasks[k], 0U, NULL)) != NULL);
+#else
+		started[k] = (pthread_create(&threads[k], NULL, task_entry, &tasks[k]) == 0);
+#endif
+	}
+
+	func(contexts);
+
+	for (k = 1U; k < count; ++k)
+	{
+		if (!started[k])
+		{
+			func(tasks[k].context);
+			continue;
+		}
+#if defined(_WIN32)
+		WaitForSingleObject(threads[k], INFINITE);
+		CloseHandle(threads[k]);
+#else
+		pthread_join(threads[k], NULL);
+#endif
+	}
 }
 
 /* ------------------------------------------------- */
 /* Memory                                            */
 /* ------------------------------------------------- */
 
+#define CACHE_LINE_SIZE 64U
+
 static INLINE void zero_memory(void *const addr, const size_t count, const size_t size)
 {
 	memset(addr, 0, safe_mult(count, size));
 }
 
-/* ------------------------------------------------- */
-/* Flags                                             */
-/* ------------------------------------------------- */
+static FORCE_INLINE size_t align_size(const size_t size)
+{
+	return (size <= SIZE_MAX - (CACHE_LINE_SIZE - 1U)) ? (((size + (CACHE_LINE_SIZE - 1U)) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE) : SIZE_MAX;
+}
 
-static FORCE_INLINE bool_t get_flag(const uint8_t *const flags, const size_t index)
+#define PAGE_SIZE_MIN ((size_t)4096U)
+#define HUGE_PAGE_SIZE ((size_t)2097152U)
+
+typedef struct
 {
-	return (flags[index / 8U] >> (index % 8U)) & UINT8_C(1);
+	hash_memory_t type;
+	bool_t prefault;
+	const hash_allocator_t *allocator; /*heap memory only*/
+	hash_numa_t numa;
+	size_t numa_node, threads;
 }
+memory_t;
 
-static FORCE_INLINE void set_flag(uint8_t *const flags, const size_t index)
+typedef struct
 {
-	flags[index / 8U] |= UINT8_C(1) << (index % 8U);
+	void *addr;
+	size_t mapped; /*size of the mapping, or zero, if the block was allocated on the heap*/
+	bool_t view; /*the mapping is a view of a file*/
+	memory_t memory;
 }
+block_t;
 
-static FORCE_INLINE void clear_flag(uint8_t *const flags, const size_t index)
+static INLINE memory_t memory_config(const hash_options_t *const options, const hash_memory_t type, const hash_allocator_t *const allocator)
 {
-	flags[index / 8U] &= ~(UINT8_C(1) << (index % 8U));
+	memory_t memory;
+	memory.type = type;
+	memory.prefault = options && (options->prefault != 0);
+	memory.allocator = allocator;
+	memory.numa = options ? options->numa : HASHSET_NUMA_DEFAULT;
+	memory.numa_node = options ? options->numa_node : 0U;
+	memory.threads = options ? options->thread_count : 0U;
+	return memory;
+}
+
+/* an allocator must provide "free" and at least one of "alloc" or "zero_alloc" */
+static INLINE bool_t allocator_valid(const hash_allocator_t *const allocator)
+{
+	return (!allocator) || (allocator->free && (allocator->alloc || allocator->zero_alloc));
+}
+
+/* heap allocations are routed through the user-supplied allocator, if any, or go to malloc() otherwise */
+static INLINE void *heap_alloc(const hash_allocator_t *const allocator, const size_t size)
+{
+	if (allocator && allocator->alloc)
+	{
+		return allocator->alloc(allocator->context, size);
+	}
+
+	if (allocator && allocator->zero_alloc)
+	{
+		return allocator->zero_alloc(allocator->context, 1U, size);
+	}
+
+	return malloc(size);
+}
+
+static INLINE void *heap_calloc(const hash_allocator_t *const allocator, const size_t count, const size_t size)
+{
+	void *addr;
+
+	if (allocator && allocator->zero_alloc)
+	{
+		return allocator->zero_alloc(allocator->context, count, size);
+	}
+
+	if (allocator && allocator->alloc)
+	{
+		const size_t total = safe_mult(count, size);
+		addr = (total < SIZE_MAX) ? allocator->alloc(allocator->context, total) : NULL;
+		if (addr)
+		{
+			memset(addr, 0, total);
+		}
+		return addr;
+	}
+
+	return calloc(count, size);
+}
+
+static INLINE void heap_free(const hash_allocator_t *const allocator, void *const addr)
+{
+	if (allocator && allocator->free)
+	{
+		allocator->free(allocator->context, addr);
+	}
+	else
+	{
+		free(addr);
+	}
+}
+
+#define HEAP_FREE(A,X) do { if ((X)) { heap_free((A), (X)); (X) = NULL; } } while(0)
+
+/* allocator for instances that live in a caller-provided buffer: memory is handed out from the buffer front to back, and only the most recent allocation can be given back */
+typedef struct
+{
+	uint8_t *next, *last, *end;
+}
+arena_t;
+
+#define ARENA_ALIGN 16U
+
+static INLINE void arena_init(arena_t *const arena, uint8_t *const begin, uint8_t *const end)
+{
+	arena->next = begin + (ARENA_ALIGN - (((uintptr_t)begin) % ARENA_ALIGN)) % ARENA_ALIGN;
+	arena->next = (arena->next < end) ? arena->next : end;
+	arena->last = NULL;
+	arena->end = end;
+}
+
+static INLINE void *arena_alloc(void *const context, const size_t size)
+{
+	arena_t *const arena = (arena_t*) context;
+	const size_t available = (size_t)(arena->end - arena->next);
+	const size_t padded = (size <= SIZE_MAX - (ARENA_ALIGN - 1U)) ? (((size + (ARENA_ALIGN - 1U)) / ARENA_ALIGN) * ARENA_ALIGN) : SIZE_MAX;
+
+	if (padded > available)
+	{
+		return NULL;
+	}
+
+	arena->last = arena->next;
+	arena->next += padded;
+	return arena->last;
+}
+
+static INLINE void arena_free(void *const context, void *const addr)
+{
+	arena_t *const arena = (arena_t*) context;
+
+	if (addr && (addr == arena->last))
+	{
+		arena->next = arena->last;
+		arena->last = NULL;
+	}
+}
+
+static INLINE size_t round_up(const size_t size, const size_t granularity)
+{
+	return (size <= SIZE_MAX - (granularity - 1U)) ? (((size + (granularity - 1U)) / granularity) * granularity) : SIZE_MAX;
+}
+
+/* writes to one byte of each page, so that all pages are faulted in right away */
+static INLINE void prefault_pages(uint8_t *const addr, const size_t size)
+{
+	size_t offset;
+	for (offset = 0U; offset < size; offset += PAGE_SIZE_MIN)
+	{
+		((volatile uint8_t*)addr)[offset] = 0U;
+	}
+}
+
+typedef struct
+{
+	uint8_t *addr;
+	size_t length;
+}
+touch_task_t;
+
+static void touch_task(void *const context)
+{
+	const touch_task_t *const task = (const touch_task_t*) context;
+	prefault_pages(task->addr, task->length);
+}
+
+/* faults in all pages by multiple threads, so that the "first touch" places each part of the table on the node of the thread that touched it */
+static INLINE void prefault_parallel(uint8_t *const addr, const size_t length, const size_t threads)
+{
+	touch_task_t tasks[MAX_THREADS];
+	const size_t count = BOUND(1U, length / HUGE_PAGE_SIZE, thread_count(threads));
+	const size_t chunk = round_up((length + (count - 1U)) / count, HUGE_PAGE_SIZE);
+	size_t k, offset = 0U;
+
+	for (k = 0U; k < count; ++k)
+	{
+		tasks[k].addr = addr + offset;
+		tasks[k].length = (offset < length) ? (((length - offset) < chunk) ? (length - offset) : chunk) : 0U;
+		offset += tasks[k].length;
+	}
+
+	run_tasks(touch_task, tasks, sizeof(touch_task_t), count);
+}
+
+#define NUMA_MAX_NODES 64U
+
+#if defined(__linux__) && defined(SYS_mbind)
+#  define HAVE_NUMA 1
+#  define NUMA_MPOL_BIND 2
+#  define NUMA_MPOL_INTERLEAVE 3
+#endif
+
+/* bit mask of the online NUMA nodes, parsed from a list such as "0-1,4"; returns zero, if unknown */
+static INLINE uint64_t numa_online_nodes(void)
+{
+#if defined(HAVE_NUMA)
+	uint64_t nodes = 0U;
+	unsigned int first, last;
+	int separator = ',';
+	FILE *const file = fopen("/sys/devices/system/node/online", "r");
+
+	if (!file)
+	{
+		return 0U;
+	}
+
+	while ((separator == ',') && (fscanf(file, "%u", &first) == 1))
+	{
+		last = first;
+		separator = fgetc(file);
+		if ((separator == '-') && (fscanf(file, "%u", &last) == 1))
+		{
+			separator = fgetc(file);
+		}
+		for (; (first <= last) && (first < NUMA_MAX_NODES); ++first)
+		{
+			nodes |= UINT64_C(1) << first;
+		}
+	}
+
+	fclose(file);
+	return nodes;
+#else
+	return 0U;
+#endif
+}
+
+/* nodes that the table is to be spread across, or zero, if no NUMA policy applies, e.g. on single-node machines */
+static INLINE uint64_t numa_nodes(const memory_t *const memory)
+{
+	const uint64_t nodes = (memory->numa != HASHSET_NUMA_DEFAULT) ? numa_online_nodes() : 0U;
+	return (nodes & (nodes - 1U)) ? nodes : 0U;
+}
+
+/* applies the memory policy to a range whose pages have not been touched yet; a policy that can not be applied is silently ignored */
+static INLINE void numa_place(void *const addr, const size_t length, const memory_t memory, const uint64_t nodes)
+{
+#if defined(HAVE_NUMA)
+	unsigned long mask[NUMA_MAX_NODES / (CHAR_BIT * sizeof(unsigned long))];
+	uint64_t selected = nodes;
+	int mode = NUMA_MPOL_INTERLEAVE;
+	size_t k;
+
+	switch (memory.numa)
+	{
+	case HASHSET_NUMA_INTERLEAVE:
+		break;
+	case HASHSET_NUMA_BIND:
+		selected = (memory.numa_node < NUMA_MAX_NODES) ? (nodes & (UINT64_C(1) << memory.numa_node)) : 0U;
+		mode = NUMA_MPOL_BIND;
+		break;
+	default:
+		return; /*first-touch: the pages are placed by the threads that fault them in*/
+	}
+
+	if (!selected)
+	{
+		return;
+	}
+
+	for (k = 0U; k < sizeof(mask) / sizeof(mask[0U]); ++k)
+	{
+		mask[k] = (unsigned long)(selected >> (k * CHAR_BIT * sizeof(unsigned long)));
+	}
+
+	syscall(SYS_mbind, addr, (unsigned long)length, mode, mask, (unsigned long)(NUMA_MAX_NODES + 1U), 0U);
+#else
+	(void)addr; (void)length; (void)memory; (void)nodes;
+#endif
+}
+
+/* maps zero-initialized pages, trying huge pages first, if requested; a NUMA policy is applied, if "nodes" is non-zero; returns NULL, if no pages could be mapped at all */
+static INLINE uint8_t *map_pages(const size_t size, const memory_t memory, const uint64_t nodes, size_t *const mapped_out)
+{
+	uint8_t *addr;
+	size_t length;
+	bool_t populated = FALSE;
+#if defined(_WIN32)
+	(void)nodes;
+	if (memory.type == HASHSET_MEMORY_HUGEPAGES)
+	{
+		const SIZE_T large_page = GetLargePageMinimum(); /*requires the "lock pages in memory" privilege*/
+		if (large_page > 0U)
+		{
+			length = round_up(size, (size_t)large_page);
+			addr = (uint8_t*) VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (addr)
+			{
+				*mapped_out = length;
+				return addr;
+			}
+		}
+	}
+
+	length = round_up(size, PAGE_SIZE_MIN);
+	addr = (uint8_t*) VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!addr)
+	{
+		return NULL;
+	}
+#else
+	const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+	const int populate = (memory.prefault && (!nodes)) ? MAP_POPULATE : 0; /*the NUMA policy must be applied before the pages are touched*/
+#else
+	const int populate = 0;
+#endif
+	addr = (uint8_t*) MAP_FAILED;
+	length = 0U;
+#if defined(MAP_HUGETLB)
+	if (memory.type == HASHSET_MEMORY_HUGEPAGES)
+	{
+		length = round_up(size, HUGE_PAGE_SIZE);
+		addr = (uint8_t*) mmap(NULL, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | populate, -1, 0);
+		populated = (populate != 0);
+	}
+#endif
+
+	if (addr == (uint8_t*)MAP_FAILED)
+	{
+		populated = (populate != 0) && (memory.type != HASHSET_MEMORY_HUGEPAGES); /*transparent huge pages: populate only after madvise()*/
+		length = round_up(size, (memory.type == HASHSET_MEMORY_HUGEPAGES) ? HUGE_PAGE_SIZE : PAGE_SIZE_MIN);
+		addr = (uint8_t*) mmap(NULL, length, PROT_READ | PROT_WRITE, flags | (populated ? populate : 0), -1, 0);
+		if (addr == (uint8_t*)MAP_FAILED)
+		{
+			return NULL;
+		}
+#if defined(MADV_HUGEPAGE)
+		if (memory.type == HASHSET_MEMORY_HUGEPAGES)
+		{
+			madvise(addr, length, MADV_HUGEPAGE); /*transparent huge pages are merely a hint*/
+		}
+#endif
+	}
+
+	if (nodes)
+	{
+		numa_place(addr, length, memory, nodes);
+	}
+#endif
+	if (nodes && (memory.numa == HASHSET_NUMA_FIRST_TOUCH))
+	{
+		prefault_parallel(addr, length, memory.threads);
+	}
+	else if (memory.prefault && (!populated))
+	{
+		prefault_pages(addr, length);
+	}
+
+	*mapped_out = length;
+	return addr;
+}
+
+static INLINE void unmap_pages(void *const addr, const size_t length)
+{
+#if defined(_WIN32)
+	(void)length;
+	VirtualFree(addr, 0U, MEM_RELEASE);
+#else
+	munmap(addr, length);
+#endif
+}
+
+/* maps "size" bytes of the file, starting at "offset", as a private copy-on-write view; the pages are shared with the page cache, until they are written to */
+static INLINE uint8_t *map_file(const int fd, const uint64_t offset, const size_t size, block_t *const block)
+{
+	uint8_t *addr;
+	size_t granularity, delta;
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	HANDLE mapping;
+	GetSystemInfo(&info);
+	granularity = (size_t) info.dwAllocationGranularity;
+	delta = (size_t) (offset % granularity);
+	if (size > SIZE_MAX - delta)
+	{
+		return NULL;
+	}
+	mapping = CreateFileMappingW((HANDLE) _get_osfhandle(fd), NULL, PAGE_WRITECOPY, 0U, 0U, NULL);
+	if (!mapping)
+	{
+		return NULL;
+	}
+	addr = (uint8_t*) MapViewOfFile(mapping, FILE_MAP_COPY, (DWORD) ((offset - delta) >> 32), (DWORD) (offset - delta), delta + size);
+	CloseHandle(mapping); /*the view keeps the mapping alive*/
+	if (!addr)
+	{
+		return NULL;
+	}
+#else
+	struct stat status;
+	off_t position;
+	granularity = (size_t) sysconf(_SC_PAGESIZE);
+	delta = (size_t) (offset % granularity);
+	position = (off_t) (offset - delta);
+	if ((size > SIZE_MAX - delta) || (position < 0) || (((uint64_t)position) != offset - delta))
+	{
+		return NULL;
+	}
+	if ((fstat(fd, &status) != 0) || (status.st_size < 0) || (((uint64_t)status.st_size) < offset + size)) /*pages beyond the end of the file can not be accessed*/
+	{
+		return NULL;
+	}
+	addr = (uint8_t*) mmap(NULL, delta + size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, position);
+	if (addr == (uint8_t*)MAP_FAILED)
+	{
+		return NULL;
+	}
+#if defined(MADV_WILLNEED)
+	if (block->memory.prefault)
+	{
+		madvise(addr, delta + size, MADV_WILLNEED); /*read ahead, but leave the pages shared*/
+	}
+#endif
+#endif
+	block->addr = addr;
+	block->mapped = delta + size;
+	block->view = TRUE;
+	return addr + delta;
+}
+
+static INLINE void unmap_view(void *const addr, const size_t length)
+{
+#if defined(_WIN32)
+	(void)length;
+	UnmapViewOfFile(addr);
+#else
+	munmap(addr, length);
+#endif
+}
+
+/* allocates a zero-initialized block; returns the first cache-line-aligned address, the address that needs to be released is stored in "block" */
+static INLINE uint8_t *alloc_block(const size_t size, block_t *const block)
+{
+	uint8_t *addr;
+	uint64_t nodes;
+
+	if (size >= SIZE_MAX - CACHE_LINE_SIZE)
+	{
+		return NULL;
+	}
+
+	nodes = numa_nodes(&block->memory);
+	if ((block->memory.type == HASHSET_MEMORY_MMAP) || (block->memory.type == HASHSET_MEMORY_HUGEPAGES) || nodes) /*a NUMA policy requires page-aligned memory*/
+	{
+		addr = map_pages(size, block->memory, nodes, &block->mapped);
+		if (addr)
+		{
+			block->addr = addr;
+			block->view = FALSE;
+			return addr; /*page-aligned*/
+		}
+	}
+
+	addr = (uint8_t*) heap_calloc(block->memory.allocator, size + CACHE_LINE_SIZE, sizeof(uint8_t)); /*fall back to the heap*/
+	if (!addr)
+	{
+		return NULL;
+	}
+
+	if (block->memory.prefault)
+	{
+		prefault_pages(addr, size + CACHE_LINE_SIZE);
+	}
+
+	block->addr = addr;
+	block->mapped = 0U;
+	block->view = FALSE;
+	return addr + (CACHE_LINE_SIZE - (((uintptr_t)addr) % CACHE_LINE_SIZE)) % CACHE_LINE_SIZE;
+}
+
+static INLINE void free_block(block_t *const block)
+{
+	if (block->addr)
+	{
+		if (block->view)
+		{
+			unmap_view(block->addr, block->mapped);
+		}
+		else if (block->mapped)
+		{
+			unmap_pages(block->addr, block->mapped);
+		}
+		else
+		{
+			heap_free(block->memory.allocator, block->addr);
+		}
+		block->addr = NULL;
+		block->mapped = 0U;
+		block->view = FALSE;
+	}
+}
+
+/* ------------------------------------------------- */
+/* Files                                             */
+/* ------------------------------------------------- */
+
+#define FILE_VERSION 1U
+#define FILE_ENDIAN UINT32_C(0x01020304) /*reads as 0x04030201, if the file was written on a machine with the opposite byte order*/
+#define FILE_HEADER_SIZE ((size_t)4096U) /*the table starts on a page boundary of the file*/
+#define FILE_CHUNK ((size_t)1073741824U)
+#define FILE_TABLE_MAX ((uint64_t)(SIZE_MAX / 2U))
+
+typedef enum
+{
+	ARRAY_ITEMS, /*the items of a set, or the keys and values of a map*/
+	ARRAY_USED,
+	ARRAY_DELETED,
+	ARRAY_CTRL,
+	ARRAY_DIST,
+	ARRAY_COUNT
+}
+array_t;
+
+typedef struct
+{
+	char magic[8U];
+	uint32_t version, endian;
+	uint32_t value_size, engine, layout, escape;
+	uint32_t hash_function, hash_probe;
+	uint64_t hash_basis, hash_key;
+	uint64_t capacity, valid, deleted;
+	double load_factor;
+	uint64_t size[ARRAY_COUNT], offset[ARRAY_COUNT]; /*zero size, if the engine does not use the array; offsets are relative to the end of the header*/
+	uint64_t table_size;
+}
+file_header_t;
+
+typedef union
+{
+	file_header_t header;
+	uint8_t padding[FILE_HEADER_SIZE];
+}
+file_page_t;
+
+static FORCE_INLINE uint64_t align_offset(const uint64_t offset)
+{
+	return ((offset + (CACHE_LINE_SIZE - 1U)) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE;
+}
+
+/* the arrays are stored one after another, each array starts on a cache line boundary; returns FALSE, if the table is too large */
+static INLINE bool_t layout_arrays(file_header_t *const header)
+{
+	size_t array;
+	header->table_size = 0U;
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		if ((header->table_size > FILE_TABLE_MAX) || (header->size[array] > FILE_TABLE_MAX - header->table_size))
+		{
+			return FALSE;
+		}
+		header->offset[array] = header->size[array] ? header->table_size : 0U;
+		header->table_size = align_offset(header->table_size + header->size[array]);
+	}
+
+	return (header->table_size <= FILE_TABLE_MAX);
+}
+
+/* returns TRUE, if the file was written by a compatible version, on a machine with the same byte order, and the table can be used as-is */
+static INLINE bool_t check_header(const file_header_t *const header, const char *const magic, const size_t value_size)
+{
+	file_header_t expected = *header;
+
+	if (memcmp(header->magic, magic, sizeof(header->magic)) || (header->version != FILE_VERSION) || (header->endian != FILE_ENDIAN) || (header->value_size != value_size))
+	{
+		return FALSE;
+	}
+
+	if ((header->engine > HASHSET_ENGINE_SENTINEL) || (header->layout > HASHSET_LAYOUT_SOA) || (!header->hash_function) || (header->hash_function > HASHSET_HASH_AESNI) || (!hash_supported((hash_function_t)header->hash_function)) || (!header->hash_probe) || (header->hash_probe > HASHSET_PROBE_QUADRATIC))
+	{
+		return FALSE;
+	}
+
+	if ((header->capacity < MINIMUM_CAPACITY) || (header->capacity > (uint64_t)(SIZE_MAX / 64U)) || (header->capacity & (header->capacity - 1U)) || (!(header->load_factor >= 0.125)) || (!(header->load_factor <= 1.0)))
+	{
+		return FALSE;
+	}
+
+	return layout_arrays(&expected) && (!memcmp(expected.offset, header->offset, sizeof(expected.offset))) && (expected.table_size == header->table_size);
+}
+
+/* returns the current position in the file, or UINT64_MAX, if the file is not seekable */
+static INLINE uint64_t file_position(const int fd)
+{
+#if defined(_WIN32)
+	const __int64 position = _lseeki64(fd, 0, SEEK_CUR);
+#else
+	const off_t position = lseek(fd, 0, SEEK_CUR);
+#endif
+	return (position >= 0) ? ((uint64_t)position) : UINT64_MAX;
+}
+
+static INLINE bool_t skip_file(const int fd, const uint64_t size)
+{
+#if defined(_WIN32)
+	return (size <= (uint64_t)INT64_MAX) && (_lseeki64(fd, (__int64)size, SEEK_CUR) >= 0);
+#else
+	return (((uint64_t)(off_t)size) == size) && ((off_t)size >= 0) && (lseek(fd, (off_t)size, SEEK_CUR) >= 0);
+#endif
+}
+
+/* writes the whole buffer, an interrupted or partial write is continued */
+static INLINE errno_t write_file(const int fd, const void *const buffer, size_t size)
+{
+	const uint8_t *next = (const uint8_t*) buffer;
+
+	while (size > 0U)
+	{
+#if defined(_WIN32)
+		const int done = _write(fd, next, (unsigned int) ((size < FILE_CHUNK) ? size : FILE_CHUNK));
+#else
+		const ssize_t done = write(fd, next, (size < FILE_CHUNK) ? size : FILE_CHUNK);
+#endif
+		if (done > 0)
+		{
+			next += done;
+			size -= (size_t) done;
+		}
+		else if ((done == 0) || (errno != EINTR))
+		{
+			return (done < 0) ? errno : EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* reads until the buffer is full; returns EIO, if the end of the file was reached before */
+static INLINE errno_t read_file(const int fd, void *const buffer, size_t size)
+{
+	uint8_t *next = (uint8_t*) buffer;
+
+	while (size > 0U)
+	{
+#if defined(_WIN32)
+		const int done = _read(fd, next, (unsigned int) ((size < FILE_CHUNK) ? size : FILE_CHUNK));
+#else
+		const ssize_t done = read(fd, next, (size < FILE_CHUNK) ? size : FILE_CHUNK);
+#endif
+		if (done > 0)
+		{
+			next += done;
+			size -= (size_t) done;
+		}
+		else if ((done == 0) || (errno != EINTR))
+		{
+			return (done < 0) ? errno : EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* writes the header, followed by the arrays of the table, each array is padded to the next cache line boundary */
+static INLINE errno_t write_table(const int fd, const file_page_t *const page, uint8_t *const *const arrays)
+{
+	static const uint8_t zeros[CACHE_LINE_SIZE] = { 0U };
+	size_t array;
+	errno_t error;
+
+	if ((error = write_file(fd, page, sizeof(file_page_t))) != 0)
+	{
+		return error;
+	}
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		if (page->header.size[array])
+		{
+			if (((error = write_file(fd, arrays[array], (size_t)page->header.size[array])) != 0) || ((error = write_file(fd, zeros, (size_t)(align_offset(page->header.size[array]) - page->header.size[array]))) != 0))
+			{
+				return error;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* reads the arrays of the table, which follow the header, into the given buffers */
+static INLINE errno_t read_table(const int fd, const file_header_t *const header, uint8_t *const *const arrays)
+{
+	uint8_t padding[CACHE_LINE_SIZE];
+	size_t array;
+	errno_t error;
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		if (header->size[array])
+		{
+			if (((error = read_file(fd, arrays[array], (size_t)header->size[array])) != 0) || ((error = read_file(fd, padding, (size_t)(align_offset(header->size[array]) - header->size[array]))) != 0))
+			{
+				return error;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------- */
+/* Flags                                             */
+/* ------------------------------------------------- */
+
+static FORCE_INLINE bool_t get_flag(const uint8_t *const flags, const size_t index)
+{
+	return (flags[index / 8U] >> (index % 8U)) & UINT8_C(1);
+}
+
+static FORCE_INLINE void set_flag(uint8_t *const flags, const size_t index)
+{
+	flags[index / 8U] |= UINT8_C(1) << (index % 8U);
+}
+
+static FORCE_INLINE void clear_flag(uint8_t *const flags, const size_t index)
+{
+	flags[index / 8U] &= ~(UINT8_C(1) << (index % 8U));
+}
+
+/* ------------------------------------------------- */
+/* Bit manipulation                                  */
+/* ------------------------------------------------- */
+
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+#  include <intrin.h>
+#endif
+
+static FORCE_INLINE size_t count_trailing_zeros(const uint32_t value)
+{
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctz(value);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return (size_t)index;
+#else
+	size_t count = 0U;
+	while (!((value >> count) & 1U))
+	{
+		++count;
+	}
+	return count;
+#endif
+}
+
+static FORCE_INLINE size_t count_trailing_zeros64(const uint64_t value)
+{
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctzll(value);
+#else
+	return ((uint32_t)value) ? count_trailing_zeros((uint32_t)value) : (32U + count_trailing_zeros((uint32_t)(value >> 32)));
+#endif
+}
+
+/* assembles up to eight bytes, starting at the given offset, in little-endian order; bytes at or beyond the limit are read as zero */
+static FORCE_INLINE uint64_t load_word64(const uint8_t *const bytes, const size_t offset, const size_t limit)
+{
+	uint64_t word = 0U;
+	size_t i;
+
+	if (offset + 8U <= limit)
+	{
+		return ((uint64_t)bytes[offset]) | (((uint64_t)bytes[offset + 1U]) << 8) | (((uint64_t)bytes[offset + 2U]) << 16) | (((uint64_t)bytes[offset + 3U]) << 24) |
+			(((uint64_t)bytes[offset + 4U]) << 32) | (((uint64_t)bytes[offset + 5U]) << 40) | (((uint64_t)bytes[offset + 6U]) << 48) | (((uint64_t)bytes[offset + 7U]) << 56);
+	}
+
+	for (i = 0U; offset + i < limit; ++i)
+	{
+		word |= ((uint64_t)bytes[offset + i]) << (8U * i);
+	}
+
+	return word;
+}
+
+/* returns the index of the first flag at or after the given index that is set in 'flags', but not in 'ignore' (optional), or the count, if there is none; 64 flags are tested at a time */
+static INLINE size_t next_flag(const uint8_t *const flags, const uint8_t *const ignore, size_t index, const size_t count)
+{
+	const size_t limit = div_ceil(count, 8U);
+	size_t offset;
+	uint64_t word;
+
+	while (index < count)
+	{
+		offset = (index / 64U) * 8U;
+		word = load_word64(flags, offset, limit);
+		if (ignore)
+		{
+			word &= ~load_word64(ignore, offset, limit);
+		}
+		if ((word &= (~UINT64_C(0)) << (index % 64U)) != 0U)
+		{
+			index = (offset * 8U) + count_trailing_zeros64(word);
+			return (index < count) ? index : count;
+		}
+		index = (offset + 8U) * 8U;
+	}
+
+	return count;
+}
+
+/* returns the index of the first non-zero byte at or after the given index, or the count, if there is none; 8 bytes are tested at a time */
+static INLINE size_t next_nonzero(const uint8_t *const bytes, size_t index, const size_t count)
+{
+	uint64_t word;
+
+	for (; index < count; index += 8U)
+	{
+		if ((word = load_word64(bytes, index, count)) != 0U)
+		{
+			return index + (count_trailing_zeros64(word) / 8U);
+		}
+	}
+
+	return count;
+}
+
+/* ------------------------------------------------- */
+/* Control groups                                    */
+/* ------------------------------------------------- */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  include <emmintrin.h>
+#  define HAVE_GROUP_SSE2 1
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_NEON) || defined(_MSC_VER))
+#  include <arm_neon.h>
+#  define HAVE_GROUP_NEON 1
+#endif
+
+#define GROUP_SIZE 16U
+
+#define CTRL_EMPTY   UINT8_C(0x80)
+#define CTRL_DELETED UINT8_C(0xFE)
+
+#define CTRL_TAG(X) ((uint8_t)((X) & UINT64_C(0x7F)))
+#define IS_FULL(X) (!((X) & UINT8_C(0x80)))
+
+/* returns a mask with bit #i set, if control byte #i of the group equals the given value */
+static FORCE_INLINE uint32_t group_match(const uint8_t *const group, const uint8_t value)
+{
+#if defined(HAVE_GROUP_SSE2)
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)group), _mm_set1_epi8((char)value)));
+#elif defined(HAVE_GROUP_NEON)
+	static const uint8_t WEIGHTS[GROUP_SIZE] = { 1U, 2U, 4U, 8U, 16U, 32U, 64U, 128U, 1U, 2U, 4U, 8U, 16U, 32U, 64U, 128U };
+	const uint8x16_t bits = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(value)), vld1q_u8(WEIGHTS));
+	return ((uint32_t)vaddv_u8(vget_low_u8(bits))) | (((uint32_t)vaddv_u8(vget_high_u8(bits))) << 8);
+#else
+	uint32_t mask = 0U, i;
+	for (i = 0U; i < GROUP_SIZE; ++i)
+	{
+		mask |= ((uint32_t)(group[i] == value)) << i;
+	}
+	return mask;
+#endif
+}
+
+/* returns a mask with bit #i set, if control byte #i of the group is *not* full (i.e., empty or deleted) */
+static FORCE_INLINE uint32_t group_match_available(const uint8_t *const group)
+{
+#if defined(HAVE_GROUP_SSE2)
+	return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#elif defined(HAVE_GROUP_NEON)
+	static const uint8_t WEIGHTS[GROUP_SIZE] = { 1U, 2U, 4U, 8U, 16U, 32U, 64U, 128U, 1U, 2U, 4U, 8U, 16U, 32U, 64U, 128U };
+	const uint8x16_t bits = vandq_u8(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(group))), vld1q_u8(WEIGHTS));
+	return ((uint32_t)vaddv_u8(vget_low_u8(bits))) | (((uint32_t)vaddv_u8(vget_high_u8(bits))) << 8);
+#else
+	uint32_t mask = 0U, i;
+	for (i = 0U; i < GROUP_SIZE; ++i)
+	{
+		mask |= ((uint32_t)(!IS_FULL(group[i]))) << i;
+	}
+	return mask;
+#endif
+}
+
+/* returns the index of the first full slot at or after the given index, or the count, if there is none; a whole group is tested at a time */
+static INLINE size_t next_full(const uint8_t *const ctrl, size_t index, const size_t count)
+{
+	uint32_t mask;
+
+	for (; index + GROUP_SIZE <= count; index += GROUP_SIZE)
+	{
+		if ((mask = (~group_match_available(ctrl + index)) & ((UINT32_C(1) << GROUP_SIZE) - 1U)) != 0U)
+		{
+			return index + count_trailing_zeros(mask);
+		}
+	}
+
+	for (; index < count; ++index)
+	{
+		if (IS_FULL(ctrl[index]))
+		{
+			return index;
+		}
+	}
+
+	return count;
+}
+
+/* ------------------------------------------------- */
+/* Probe distances                                   */
+/* ------------------------------------------------- */
+
+#define DIST_EMPTY UINT8_C(0)
+#define DIST_MAX   UINT8_MAX
+
+/* ------------------------------------------------- */
+/* Buckets                                           */
+/* ------------------------------------------------- */
+
+#define BUCKET_SIZE 4U
+#define STASH_SIZE 8U
+
+#define CUCKOO_MAX_DEPTH 5U
+#define CUCKOO_MAX_NODES 256U
+
+typedef struct
+{
+	size_t bucket;
+	uint16_t parent;
+	uint8_t slot, depth;
+}
+cuckoo_node_t;
+
+/* returns FALSE, if the displacement path that ends at the given node would move any slot more than once */
+static INLINE bool_t cuckoo_check_path(const cuckoo_node_t *const queue, size_t current)
+{
+	size_t path[CUCKOO_MAX_DEPTH + 1U], length = 0U, k;
+
+	for (; queue[current].parent != UINT16_MAX; current = queue[current].parent)
+	{
+		const size_t source = (queue[queue[current].parent].bucket * BUCKET_SIZE) + queue[current].slot;
+		for (k = 0U; k < length; ++k)
+		{
+			if (path[k] == source)
+			{
+				return FALSE;
+			}
+		}
+		path[length++] = source;
+	}
+
+	return TRUE;
+}
+
+static FORCE_INLINE size_t bucket_first(const uint64_t hash, const size_t bucket_count)
+{
+	return ((size_t)hash) & (bucket_count - 1U);
+}
+
+/* the alternative bucket is an involution, i.e. bucket_other(bucket_other(b)) == b */
+static FORCE_INLINE size_t bucket_other(const uint64_t hash, const size_t bucket, const size_t bucket_count)
+{
+	return (bucket ^ ((size_t)(ROTL64(hash, 32) | UINT64_C(1)))) & (bucket_count - 1U);
+}
+
+/* ------------------------------------------------- */
+/* Bulk construction                                 */
+/* ------------------------------------------------- */
+
+/* PLACE_DEFER: the probe sequence continues in another region, PLACE_SERIAL: the item has to be inserted sequentially */
+typedef enum
+{
+	PLACE_DONE = 0,
+	PLACE_EXISTS = 1,
+	PLACE_DEFER = 2,
+	PLACE_SERIAL = 3
+}
+place_t;
+
+/* an item that is waiting to be placed, and the number of probe steps that have been taken already; STEPS_SERIAL, if the item has to be inserted sequentially */
+typedef struct
+{
+	size_t index, steps;
+}
+build_ref_t;
+
+#define STEPS_SERIAL SIZE_MAX
+
+/* the region of the table that is owned by one of the threads */
+typedef struct
+{
+	size_t id, count, unit_shift;
+}
+region_t;
+
+/* region of the table that the given slot belongs to, regions are aligned to PARALLEL_MIN_SLOTS */
+static FORCE_INLINE size_t region_of(const size_t index, const size_t region_count, const size_t unit_shift)
+{
+	return (size_t)((((uint64_t)(index / PARALLEL_MIN_SLOTS)) * region_count) >> unit_shift);
+}
+
+static FORCE_INLINE bool_t in_region(const region_t *const region, const size_t index)
+{
+	return region_of(index, region->count, region->unit_shift) == region->id;
+}
+
+static INLINE size_t log2_pow2(size_t value)
+{
+	size_t result = 0U;
+	while (value > 1U)
+	{
+		value >>= 1;
+		++result;
+	}
+	return result;
+}
+
+/* ------------------------------------------------- */
+/* Concurrent readers                                */
+/* ------------------------------------------------- */
+
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+#  if defined(_M_X64) || defined(_M_IX86)
+#    define ACQUIRE_FENCE() _ReadWriteBarrier()
+#    define RELEASE_FENCE() _ReadWriteBarrier()
+#  else
+#    define ACQUIRE_FENCE() MemoryBarrier()
+#    define RELEASE_FENCE() MemoryBarrier()
+#  endif
+#else
+#  define ACQUIRE_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#  define RELEASE_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+#define MAX_READERS 64U
+
+static FORCE_INLINE uint64_t atomic_load64(const volatile uint64_t *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+#  if defined(_M_IX86)
+	return (uint64_t) InterlockedCompareExchange64((volatile LONG64*)addr, 0, 0);
+#  else
+	return *addr;
+#  endif
+#else
+	return __atomic_load_n(addr, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE void atomic_store64(volatile uint64_t *const addr, const uint64_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	InterlockedExchange64((volatile LONG64*)addr, (LONG64)value);
+#else
+	__atomic_store_n(addr, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE void atomic_release64(volatile uint64_t *const addr, const uint64_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	RELEASE_FENCE();
+	*addr = value;
+#else
+	__atomic_store_n(addr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static FORCE_INLINE uint64_t atomic_increment64(volatile uint64_t *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	return (uint64_t) InterlockedIncrement64((volatile LONG64*)addr);
+#else
+	return __atomic_add_fetch(addr, 1U, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE bool_t atomic_acquire32(volatile uint32_t *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	return (InterlockedCompareExchange((volatile LONG*)addr, 1, 0) == 0);
+#else
+	uint32_t expected = 0U;
+	return __atomic_compare_exchange_n(addr, &expected, 1U, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE void atomic_release32(volatile uint32_t *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	RELEASE_FENCE();
+	*addr = 0U;
+#else
+	__atomic_store_n(addr, 0U, __ATOMIC_RELEASE);
+#endif
+}
+
+static FORCE_INLINE void *atomic_load_ptr(void *const volatile *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	void *const value = *addr;
+	ACQUIRE_FENCE();
+	return value;
+#else
+	return __atomic_load_n(addr, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE void atomic_store_ptr(void *volatile *const addr, void *const value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	InterlockedExchangePointer(addr, value);
+#else
+	__atomic_store_n(addr, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* each reader owns a separate cache line, so that lookups never write to memory that is shared with another thread */
+typedef union
+{
+	struct
+	{
+		volatile uint64_t epoch; /*epoch in which the running lookup has started, or zero, if the reader is idle*/
+		volatile uint32_t attached;
+		void *owner;
+	}
+	state;
+	uint8_t padding[CACHE_LINE_SIZE];
+}
+reader_slot_t;
+
+typedef struct
+{
+	reader_slot_t readers[MAX_READERS];
+	volatile uint64_t current;
+}
+epoch_t;
+
+static INLINE void epoch_init(epoch_t *const epoch)
+{
+	zero_memory(epoch, 1U, sizeof(epoch_t));
+	epoch->current = 1U;
+}
+
+/* claims an unused reader slot; returns NULL, if all slots are taken */
+static INLINE reader_slot_t *epoch_attach(epoch_t *const epoch, void *const owner)
+{
+	size_t i;
+	for (i = 0U; i < MAX_READERS; ++i)
+	{
+		if ((!epoch->readers[i].state.attached) && atomic_acquire32(&epoch->readers[i].state.attached))
+		{
+			epoch->readers[i].state.owner = owner;
+			return &epoch->readers[i];
+		}
+	}
+	return NULL;
+}
+
+static INLINE void epoch_detach(reader_slot_t *const slot)
+{
+	atomic_release64(&slot->state.epoch, 0U);
+	atomic_release32(&slot->state.attached);
+}
+
+/* the store (with a full barrier) must be visible before the reader loads the current table; it only touches the reader's own cache line */
+static FORCE_INLINE void epoch_enter(epoch_t *const epoch, reader_slot_t *const slot)
+{
+	atomic_store64(&slot->state.epoch, atomic_load64(&epoch->current));
+}
+
+/* an idle reader does not hold back the release of any retired table */
+static FORCE_INLINE void epoch_exit(reader_slot_t *const slot)
+{
+	atomic_release64(&slot->state.epoch, 0U);
+}
+
+/* starts a new epoch and returns its number; readers that start a lookup from now on can not see a table that was replaced before */
+static INLINE uint64_t epoch_advance(epoch_t *const epoch)
+{
+	return atomic_increment64(&epoch->current);
+}
+
+/* returns the oldest epoch in which any of the readers has started its running lookup, or UINT64_MAX */
+static INLINE uint64_t epoch_oldest(epoch_t *const epoch)
+{
+	uint64_t oldest = UINT64_MAX;
+	size_t i;
+	for (i = 0U; i < MAX_READERS; ++i)
+	{
+		const uint64_t value = atomic_load64(&epoch->readers[i].state.epoch);
+		if (value && (value < oldest))
+		{
+			oldest = value;
+		}
+	}
+	return oldest;
+}
+
+/* ------------------------------------------------- */
+/* Sharding                                          */
+/* ------------------------------------------------- */
+
+#define MAX_SHARDS 1024U
+#define SHARD_SHIFT 54U /*the shard is selected by the highest bits of the remixed hash value, because the engines use the high bits of the original hash value for probing*/
+
+/* size of a structure that has been padded to a multiple of the cache line size */
+#define PADDED_SIZE(X) ((((X) + CACHE_LINE_SIZE - 1U) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE)
+
+#if defined(_WIN32)
+typedef SRWLOCK lock_t;
+#else
+typedef pthread_mutex_t lock_t;
+#endif
+
+static INLINE bool_t lock_init(lock_t *const lock)
+{
+#if defined(_WIN32)
+	InitializeSRWLock(lock);
+	return TRUE;
+#else
+	return (pthread_mutex_init(lock, NULL) == 0);
+#endif
+}
+
+static INLINE void lock_destroy(lock_t *const lock)
+{
+#if defined(_WIN32)
+	(void)lock; /*slim reader/writer locks do not need to be destroyed*/
+#else
+	pthread_mutex_destroy(lock);
+#endif
+}
+
+static FORCE_INLINE void lock_acquire(lock_t *const lock)
+{
+#if defined(_WIN32)
+	AcquireSRWLockExclusive(lock);
+#else
+	pthread_mutex_lock(lock);
+#endif
+}
+
+static FORCE_INLINE void lock_release(lock_t *const lock)
+{
+#if defined(_WIN32)
+	ReleaseSRWLockExclusive(lock);
+#else
+	pthread_mutex_unlock(lock);
+#endif
+}
+
+/* the requested number of shards, rounded up to a power of two; by default, there are four shards per CPU */
+static INLINE size_t shard_count(const size_t requested)
+{
+	const size_t target = requested ? requested : (4U * cpu_count());
+	size_t count = 1U;
+
+	while ((count < target) && (count < MAX_SHARDS))
+	{
+		count *= 2U;
+	}
+
+	return count;
+}
+
+static FORCE_INLINE size_t shard_index(const uint64_t hash, const size_t count)
+{
+	return ((size_t)(hash_mix(hash) >> SHARD_SHIFT)) & (count - 1U);
+}
+
+/* ------------------------------------------------- */
+/* Lock-free tables                                  */
+/* ------------------------------------------------- */
+
+#define MAX_STRIPES 64U
+#define STRIPE_SLOTS 4096U
+
+/* compare-and-swap on a 16, 32 or 64 bit word; returns the value that was found, which equals "expected", if the swap was successful */
+static FORCE_INLINE uint64_t atomic_cas_word(volatile void *const addr, const size_t size, const uint64_t expected, const uint64_t desired)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	switch (size)
+	{
+	case 2U:
+		return (uint16_t) InterlockedCompareExchange16((volatile SHORT*)addr, (SHORT)desired, (SHORT)expected);
+	case 4U:
+		return (uint32_t) InterlockedCompareExchange((volatile LONG*)addr, (LONG)desired, (LONG)expected);
+	default:
+		return (uint64_t) InterlockedCompareExchange64((volatile LONG64*)addr, (LONG64)desired, (LONG64)expected);
+	}
+#else
+	switch (size)
+	{
+	case 2U:
+		{
+			uint16_t value = (uint16_t)expected;
+			__atomic_compare_exchange_n((volatile uint16_t*)addr, &value, (uint16_t)desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			return value;
+		}
+	case 4U:
+		{
+			uint32_t value = (uint32_t)expected;
+			__atomic_compare_exchange_n((volatile uint32_t*)addr, &value, (uint32_t)desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			return value;
+		}
+	default:
+		{
+			uint64_t value = expected;
+			__atomic_compare_exchange_n((volatile uint64_t*)addr, &value, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+			return value;
+		}
+	}
+#endif
+}
+
+static FORCE_INLINE uint64_t atomic_load_word(const volatile void *const addr, const size_t size)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	uint64_t value;
+	switch (size)
+	{
+	case 2U:
+		value = *((const volatile uint16_t*)addr);
+		break;
+	case 4U:
+		value = *((const volatile uint32_t*)addr);
+		break;
+	default:
+		value = atomic_load64((const volatile uint64_t*)addr);
+	}
+	ACQUIRE_FENCE();
+	return value;
+#else
+	switch (size)
+	{
+	case 2U:
+		return __atomic_load_n((const volatile uint16_t*)addr, __ATOMIC_ACQUIRE);
+	case 4U:
+		return __atomic_load_n((const volatile uint32_t*)addr, __ATOMIC_ACQUIRE);
+	default:
+		return __atomic_load_n((const volatile uint64_t*)addr, __ATOMIC_ACQUIRE);
+	}
+#endif
+}
+
+/* the following read-modify-write operations return the value that was found, before the operation was applied */
+static FORCE_INLINE uint64_t atomic_swap_word(volatile void *const addr, const size_t size, const uint64_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	switch (size)
+	{
+	case 2U:
+		return (uint16_t) InterlockedExchange16((volatile SHORT*)addr, (SHORT)value);
+	case 4U:
+		return (uint32_t) InterlockedExchange((volatile LONG*)addr, (LONG)value);
+	default:
+		return (uint64_t) InterlockedExchange64((volatile LONG64*)addr, (LONG64)value);
+	}
+#else
+	switch (size)
+	{
+	case 2U:
+		return __atomic_exchange_n((volatile uint16_t*)addr, (uint16_t)value, __ATOMIC_SEQ_CST);
+	case 4U:
+		return __atomic_exchange_n((volatile uint32_t*)addr, (uint32_t)value, __ATOMIC_SEQ_CST);
+	default:
+		return __atomic_exchange_n((volatile uint64_t*)addr, value, __ATOMIC_SEQ_CST);
+	}
+#endif
+}
+
+static FORCE_INLINE uint64_t atomic_add_word(volatile void *const addr, const size_t size, const uint64_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	switch (size)
+	{
+	case 2U:
+		return (uint16_t) _InterlockedExchangeAdd16((volatile SHORT*)addr, (SHORT)value);
+	case 4U:
+		return (uint32_t) InterlockedExchangeAdd((volatile LONG*)addr, (LONG)value);
+	default:
+		return (uint64_t) InterlockedExchangeAdd64((volatile LONG64*)addr, (LONG64)value);
+	}
+#else
+	switch (size)
+	{
+	case 2U:
+		return __atomic_fetch_add((volatile uint16_t*)addr, (uint16_t)value, __ATOMIC_SEQ_CST);
+	case 4U:
+		return __atomic_fetch_add((volatile uint32_t*)addr, (uint32_t)value, __ATOMIC_SEQ_CST);
+	default:
+		return __atomic_fetch_add((volatile uint64_t*)addr, value, __ATOMIC_SEQ_CST);
+	}
+#endif
+}
+
+static FORCE_INLINE uint64_t atomic_or_word(volatile void *const addr, const size_t size, const uint64_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	switch (size)
+	{
+	case 2U:
+		return (uint16_t) _InterlockedOr16((volatile SHORT*)addr, (SHORT)value);
+	case 4U:
+		return (uint32_t) _InterlockedOr((volatile LONG*)addr, (LONG)value);
+	default:
+		return (uint64_t) InterlockedOr64((volatile LONG64*)addr, (LONG64)value);
+	}
+#else
+	switch (size)
+	{
+	case 2U:
+		return __atomic_fetch_or((volatile uint16_t*)addr, (uint16_t)value, __ATOMIC_SEQ_CST);
+	case 4U:
+		return __atomic_fetch_or((volatile uint32_t*)addr, (uint32_t)value, __ATOMIC_SEQ_CST);
+	default:
+		return __atomic_fetch_or((volatile uint64_t*)addr, value, __ATOMIC_SEQ_CST);
+	}
+#endif
+}
+
+/* returns the new value */
+static FORCE_INLINE size_t atomic_add_size(volatile size_t *const addr, const size_t value)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+#  if defined(_WIN64)
+	return (size_t) InterlockedExchangeAdd64((volatile LONG64*)addr, (LONG64)value) + value;
+#  else
+	return (size_t) InterlockedExchangeAdd((volatile LONG*)addr, (LONG)value) + value;
+#  endif
+#else
+	return __atomic_add_fetch(addr, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static FORCE_INLINE size_t atomic_load_size(const volatile size_t *const addr)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	const size_t value = *addr;
+	ACQUIRE_FENCE();
+	return value;
+#else
+	return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static FORCE_INLINE bool_t atomic_cas_ptr(void *volatile *const addr, void *const expected, void *const desired)
+{
+#if defined(_MSC_VER) && (!defined(__GNUC__))
+	return (InterlockedCompareExchangePointer(addr, desired, expected) == expected);
+#else
+	void *value = expected;
+	return __atomic_compare_exchange_n(addr, &value, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* each counter owns a separate cache line, so that threads which update different counters do not contend */
+typedef union
+{
+	volatile size_t value;
+	uint8_t padding[CACHE_LINE_SIZE];
+}
+counter_t;
+
+/* the number of counters that the occupancy of a table with the given capacity is spread over, so that each counter covers at least STRIPE_SLOTS slots */
+static INLINE size_t stripe_count(const size_t capacity)
+{
+	size_t count = 1U;
+
+	while ((count < MAX_STRIPES) && (capacity / (2U * count) >= STRIPE_SLOTS))
+	{
+		count *= 2U;
+	}
+
+	return count;
 }
 
 #endif /* _LIBHASHSET_COMMON_INCLUDED */
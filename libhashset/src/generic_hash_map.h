@@ -18,101 +18,210 @@
 /* Data types                                        */
 /* ------------------------------------------------- */
 
-typedef struct
-{
-	value_t key;
-	value_t value;
-}
-entry_t;
-
 typedef struct DECLARE(_hash_map_data)
 {
-	entry_t *entries;
-	uint8_t *used, *deleted;
+	value_t *keys, *values;
+	size_t shift; /*1 = interleaved keys and values, 0 = separate arrays*/
+	hash_layout_t layout;
+	uint8_t *used, *deleted; /*bitmap engine, cuckoo engine*/
+	uint8_t *ctrl; /*swiss engine*/
+	uint8_t *dist; /*robinhood engine*/
+	uint8_t escape; /*sentinel engine*/
+	block_t block;
+	hash_engine_t engine;
 	size_t capacity;
 }
 hash_data_t;
 
+typedef struct DECLARE(_hash_map_snapshot)
+{
+	hash_data_t data;
+	uint64_t retired; /*epoch in which the table was replaced*/
+	struct DECLARE(_hash_map_snapshot) *next;
+}
+snapshot_t;
+
+/* the state that concurrent readers access, it is modified only when the writer publishes a new table */
+typedef struct
+{
+	epoch_t epoch;
+	snapshot_t *volatile current;
+	snapshot_t *retired;
+	hash_param_t hash;
+}
+shared_t;
+
 struct DECLARE(_hash_map)
 {
 	double load_factor;
-	size_t valid, deleted, limit;
-	uint64_t basis;
-	hash_data_t data;
+	size_t valid, deleted, limit, threads;
+	size_t pending, migrated; /*incremental resize*/
+	bool_t incremental;
+	size_t growth;
+	hash_shrink_t shrink;
+	double shrink_threshold;
+	hash_allocator_t allocator;
+	arena_t arena; /*instances that live in a caller-provided buffer*/
+	hash_param_t hash;
+	hash_data_t data, old;
+	shared_t *shared; /*concurrent readers, NULL otherwise*/
+	block_t shared_block;
+	size_t collect;
+};
+
+typedef struct
+{
+	lock_t lock;
+	hash_map_t *instance;
+}
+shard_state_t;
+
+/* each shard owns a separate cache line, so that threads working on different shards never write to the same cache line */
+typedef union
+{
+	shard_state_t state;
+	uint8_t padding[PADDED_SIZE(sizeof(shard_state_t))];
+}
+shard_t;
+
+struct DECLARE(_hash_map_concurrent)
+{
+	hash_param_t hash;
+	size_t shard_count;
+	hash_allocator_t allocator;
+	block_t block;
+	shard_t *shards;
+};
+
+typedef struct DECLARE(_hash_map_lockfree_table)
+{
+	counter_t used[MAX_STRIPES]; /*the first member, so that the counters are aligned to the cache lines*/
+	volatile value_t *entries; /*interleaved keys and values, so that an update touches a single cache line*/
+	volatile uint64_t *states; /*two bits per entry, for the migration*/
+	size_t capacity, limit, stripes, chunks;
+	volatile size_t claimed, migrated; /*resize progress, in chunks*/
+	struct DECLARE(_hash_map_lockfree_table) *volatile next;
+	struct DECLARE(_hash_map_lockfree_table) *previous;
+	block_t block;
+}
+lockfree_table_t;
+
+struct DECLARE(_hash_map_lockfree)
+{
+	lockfree_table_t *volatile current;
+	hash_param_t hash;
+	double load_factor;
+	size_t growth;
+	memory_t memory;
+	hash_allocator_t allocator;
+	volatile uint32_t escape[2U]; /*the keys that are equal to one of the sentinel values*/
+	volatile value_t escape_value[2U];
+	counter_t *size;
+	block_t size_block;
 };
 
 /* ------------------------------------------------- */
-/* Allocation                                        */
+/* Entries                                           */
 /* ------------------------------------------------- */
 
-static INLINE bool_t alloc_data(hash_data_t *const data, const size_t capacity)
+#define KEY(D,I) ((D)->keys[(I) << (D)->shift])
+#define VALUE(D,I) ((D)->values[(I) << (D)->shift])
+
+static INLINE size_t entries_size(const hash_layout_t layout, const size_t slots)
 {
-	zero_memory(data, 1U, sizeof(hash_data_t));
+	const size_t array_size = safe_mult(slots, sizeof(value_t));
+	return (layout == HASHSET_LAYOUT_SOA) ? safe_times2(align_size(array_size)) : safe_times2(array_size);
+}
 
-	data->entries = (entry_t*) calloc(capacity, sizeof(entry_t));
-	if (!data->entries)
-	{
-		return FALSE;
-	}
+static INLINE void setup_entries(hash_data_t *const data, uint8_t *const addr, const size_t slots)
+{
+	data->keys = (value_t*) addr;
 
-	data->used = (uint8_t*) calloc(div_ceil(capacity, 8U), sizeof(uint8_t));
-	if (!data->used)
+	if (data->layout == HASHSET_LAYOUT_SOA)
 	{
-		SAFE_FREE(data->entries);
-		return FALSE;
+		data->values = (value_t*) (addr + align_size(slots * sizeof(value_t)));
+		data->shift = 0U;
 	}
-
-	data->deleted = (uint8_t*) calloc(div_ceil(capacity, 8U), sizeof(uint8_t));
-	if (!data->deleted)
+	else
 	{
-		SAFE_FREE(data->used);
-		SAFE_FREE(data->entries);
-		return FALSE;
+		data->values = data->keys + 1U;
+		data->shift = 1U;
 	}
+}
 
-	data->capacity = capacity;
-	return TRUE;
+static FORCE_INLINE void set_entry(hash_data_t *const data, const size_t index, const value_t key, const value_t value)
+{
+	KEY(data, index) = key;
+	VALUE(data, index) = value;
 }
 
-static INLINE void free_data(hash_data_t *const data)
+static FORCE_INLINE void prefetch_entry(const hash_data_t *const data, const size_t index)
 {
-	if (data)
+	PREFETCH(&KEY(data, index));
+	if (!data->shift)
 	{
-		SAFE_FREE(data->entries);
-		SAFE_FREE(data->used);
-		SAFE_FREE(data->deleted);
-		data->capacity = 0U;
+		PREFETCH(&VALUE(data, index));
 	}
 }
 
+static FORCE_INLINE void move_entry(hash_data_t *const data, const size_t target, const size_t source)
+{
+	KEY(data, target) = KEY(data, source);
+	VALUE(data, target) = VALUE(data, source);
+}
+
 /* ------------------------------------------------- */
-/* Set functions                                     */
+/* Bitmap engine                                     */
 /* ------------------------------------------------- */
 
-#define INDEX(X) ((size_t)((X) % data->capacity))
+static INLINE bool_t bitmap_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t array_size = align_size(entries_size(data->layout, capacity)), flags_size = align_size(div_ceil(capacity, 8U));
+	uint8_t *const block = alloc_block(safe_add(array_size, safe_times2(flags_size)), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	setup_entries(data, block, capacity);
+	data->used = block + array_size;
+	data->deleted = data->used + flags_size;
+	return TRUE;
+}
 
-static INLINE bool_t find_slot(const hash_data_t *const data, const uint64_t basis, const value_t key, size_t *const index_out, bool_t *const reused_out)
+static FORCE_INLINE void bitmap_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
 {
-	size_t index;
+	const size_t index = ((size_t)hash) & (data->capacity - 1U);
+	PREFETCH(&data->used[index / 8U]);
+	PREFETCH(&data->deleted[index / 8U]);
+	prefetch_entry(data, index);
+}
+
+static INLINE bool_t bitmap_find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
+{
+	probe_t probe;
 	bool_t is_saved = FALSE;
-	uint64_t loop = 0U;
 
-	for (index = INDEX(hash_compute(basis, loop, key)); get_flag(data->used, index); index = INDEX(hash_compute(basis, ++loop, key)))
+	for (probe_init(&probe, param, hash, data->capacity); get_flag(data->used, probe.index); probe_next(&probe, data->capacity))
 	{
-		if (get_flag(data->deleted, index))
+		const size_t next = probe_peek(&probe, data->capacity);
+		PREFETCH(&data->used[next / 8U]);
+		PREFETCH(&KEY(data, next));
+
+		if (get_flag(data->deleted, probe.index))
 		{
 			if (!is_saved)
 			{
-				SAFE_SET(index_out, index);
+				SAFE_SET(index_out, probe.index);
 				SAFE_SET(reused_out, TRUE);
 				is_saved = TRUE;
 			}
 		}
 		else
 		{
-			if (data->entries[index].key == key)
+			if (KEY(data, probe.index) == key)
 			{
-				SAFE_SET(index_out, index);
+				SAFE_SET(index_out, probe.index);
 				SAFE_SET(reused_out, FALSE);
 				return TRUE;
 			}
@@ -121,18 +230,17 @@ static INLINE bool_t find_slot(const hash_data_t *const data, const uint64_t bas
 
 	if (!is_saved)
 	{
-		SAFE_SET(index_out, index);
+		SAFE_SET(index_out, probe.index);
 		SAFE_SET(reused_out, FALSE);
 	}
 
 	return FALSE;
 }
 
-static INLINE void put_entry(hash_data_t *const data, const size_t index, const value_t key, const value_t value, const bool_t reusing)
+static INLINE void bitmap_put_entry(hash_data_t *const data, const size_t index, const value_t key, const value_t value, const bool_t reusing)
 {
-	entry_t *const entry = &data->entries[index];
-	entry->key = key;
-	entry->value = value;
+	set_entry(data, index, key, value);
+	RELEASE_FENCE(); /*concurrent readers must see the entry before the flag*/
 
 	if (reusing)
 	{
@@ -146,296 +254,2755 @@ static INLINE void put_entry(hash_data_t *const data, const size_t index, const
 	}
 }
 
-static INLINE size_t compute_limit(const size_t capacity, const double load_factor)
+/* concurrent readers: the flags are loaded before the key, so that a "used" slot never exposes an entry that has not been published yet */
+static INLINE bool_t bitmap_find_shared(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out)
 {
-	size_t limit = round_sz(capacity * load_factor);
+	probe_t probe;
 
-	while (capacity && (limit >= capacity))
+	for (probe_init(&probe, param, hash, data->capacity); get_flag(data->used, probe.index); probe_next(&probe, data->capacity))
 	{
-		limit = safe_decr(limit);
+		ACQUIRE_FENCE();
+		if ((!get_flag(data->deleted, probe.index)) && (KEY(data, probe.index) == key))
+		{
+			*index_out = probe.index;
+			return TRUE;
+		}
 	}
 
-	return limit;
+	return FALSE;
 }
 
-static INLINE errno_t rebuild_map(hash_map_t *const instance, const size_t new_capacity)
+/* the first slot of the probe sequence that has never been used */
+static INLINE size_t bitmap_unused_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash)
 {
-	size_t k, index = SIZE_MAX;
-	hash_data_t temp;
+	probe_t probe;
+	probe_init(&probe, param, hash, data->capacity);
 
-	if (new_capacity < instance->valid)
+	while (get_flag(data->used, probe.index))
 	{
-		return EINVAL;
+		probe_next(&probe, data->capacity);
 	}
 
-	if (!alloc_data(&temp, new_capacity))
+	return probe.index;
+}
+
+/* bulk construction: follows the probe sequence, after the given number of steps, for as long as it stays inside of the region */
+static INLINE place_t bitmap_place_entry(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, const value_t value, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	probe_t probe;
+	probe_init(&probe, param, hash, data->capacity);
+	probe_skip(&probe, *steps, data->capacity);
+
+	for (; in_region(region, probe.index); probe_next(&probe, data->capacity), ++(*steps))
 	{
-		return ENOMEM;
+		if (!get_flag(data->used, probe.index))
+		{
+			set_entry(data, probe.index, key, value);
+			set_flag(data->used, probe.index);
+			return PLACE_DONE;
+		}
+		if (KEY(data, probe.index) == key)
+		{
+			*index_out = probe.index;
+			return PLACE_EXISTS;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void bitmap_clear_data(hash_data_t *const data)
+{
+	const size_t count = div_ceil(data->capacity, 8U);
+	zero_memory(data->used, count, sizeof(uint8_t));
+	zero_memory(data->deleted, count, sizeof(uint8_t));
+}
+
+/* in-place purge: "deleted" slots become "unused", while the "deleted" flag now marks the entries that still need to be re-inserted */
+static INLINE void bitmap_purge_data(hash_data_t *const data, const hash_param_t *const param)
+{
+	const size_t count = div_ceil(data->capacity, 8U);
+	size_t i;
+	probe_t probe;
+
+	for (i = 0U; i < count; ++i)
+	{
+		data->used[i] &= (uint8_t)(~data->deleted[i]);
+		data->deleted[i] = data->used[i];
 	}
 
-	for (k = 0U; k < instance->data.capacity; ++k)
+	for (i = 0U; i < data->capacity; ++i)
 	{
-		if (IS_VALID(instance->data, k))
+		while (get_flag(data->deleted, i))
 		{
-			const entry_t entry = instance->data.entries[k];
-			if (find_slot(&temp, instance->basis, entry.key, &index, NULL))
+			const value_t key = KEY(data, i), value = VALUE(data, i);
+			probe_init(&probe, param, hash_compute(param, key), data->capacity);
+			while (get_flag(data->used, probe.index) && (!get_flag(data->deleted, probe.index)))
 			{
-				free_data(&temp);
-				return EFAULT; /*this should never happen!*/
+				probe_next(&probe, data->capacity);
+			}
+			clear_flag(data->deleted, probe.index);
+			if (probe.index != i)
+			{
+				if (get_flag(data->used, probe.index))
+				{
+					move_entry(data, i, probe.index); /*swap with a pending entry, which is processed next*/
+				}
+				else
+				{
+					set_flag(data->used, probe.index);
+					clear_flag(data->used, i);
+					clear_flag(data->deleted, i);
+				}
+				set_entry(data, probe.index, key, value);
 			}
-			put_entry(&temp, index, entry.key, entry.value, FALSE);
 		}
 	}
+}
 
-	free_data(&instance->data);
-	instance->data = temp;
-	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
-	instance->deleted = 0U;
+/* ------------------------------------------------- */
+/* Swiss engine                                      */
+/* ------------------------------------------------- */
 
-	return 0;
-}
+#include "generic_hash_map_swiss.h"
 
-/* ========================================================================= */
-/* PUBLIC FUNCTIONS                                                          */
-/* ========================================================================= */
+/* ------------------------------------------------- */
+/* Robin Hood engine                                 */
+/* ------------------------------------------------- */
 
-hash_map_t *DECLARE(hash_map_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed)
+#include "generic_hash_map_robinhood.h"
+
+/* ------------------------------------------------- */
+/* Cuckoo engine                                     */
+/* ------------------------------------------------- */
+
+#include "generic_hash_map_cuckoo.h"
+
+/* ------------------------------------------------- */
+/* Sentinel engine                                   */
+/* ------------------------------------------------- */
+
+#include "generic_hash_map_sentinel.h"
+
+/* ------------------------------------------------- */
+/* Allocation                                        */
+/* ------------------------------------------------- */
+
+static INLINE bool_t alloc_data(hash_data_t *const data, const hash_engine_t engine, const hash_layout_t layout, const memory_t memory, size_t capacity)
 {
-	hash_map_t *instance = (hash_map_t*) calloc(1U, sizeof(hash_map_t));
-	if (!instance)
+	bool_t success;
+	zero_memory(data, 1U, sizeof(hash_data_t));
+	data->layout = layout;
+	data->block.memory = memory;
+
+	switch (engine)
 	{
-		return NULL;
+	case HASHSET_ENGINE_SWISS:
+		capacity = (capacity > GROUP_SIZE) ? capacity : GROUP_SIZE;
+		success = swiss_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		success = robinhood_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		capacity = (capacity > 2U * BUCKET_SIZE) ? capacity : (2U * BUCKET_SIZE);
+		success = cuckoo_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		success = sentinel_alloc_data(data, capacity);
+		break;
+	default:
+		success = bitmap_alloc_data(data, capacity);
 	}
 
-	if (!alloc_data(&instance->data, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY))
+	if (!success)
 	{
-		SAFE_FREE(instance);
-		return NULL;
+		return FALSE;
 	}
 
-	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
-	instance->basis = hash_initialize(seed);
-	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	data->engine = engine;
+	data->capacity = capacity;
+	return TRUE;
+}
 
-	return instance;
+static INLINE void free_data(hash_data_t *const data)
+{
+	if (data)
+	{
+		free_block(&data->block);
+		zero_memory(data, 1U, sizeof(hash_data_t));
+	}
 }
 
-void DECLARE(hash_map_destroy)(hash_map_t *instance)
+/* ------------------------------------------------- */
+/* Slot functions                                    */
+/* ------------------------------------------------- */
+
+static FORCE_INLINE size_t slot_count(const hash_data_t *const data)
 {
-	if (instance)
+	switch (data->engine)
 	{
-		free_data(&instance->data);
-		zero_memory(instance, 1U, sizeof(hash_map_t));
-		SAFE_FREE(instance);
+	case HASHSET_ENGINE_CUCKOO:
+		return data->capacity + STASH_SIZE;
+	case HASHSET_ENGINE_SENTINEL:
+		return data->capacity + 2U;
+	default:
+		return data->capacity;
 	}
 }
 
-errno_t DECLARE(hash_map_insert)(hash_map_t *const instance, const value_t key, const value_t value, const bool_t update)
+static FORCE_INLINE bool_t find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
 {
-	size_t index = SIZE_MAX;
-	bool_t slot_reused;
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		return swiss_find_slot(data, param, hash, key, index_out, reused_out);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_find_slot(data, hash, key, index_out, reused_out);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_find_slot(data, hash, key, index_out, reused_out);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_find_slot(data, param, hash, key, index_out, reused_out);
+	default:
+		return bitmap_find_slot(data, param, hash, key, index_out, reused_out);
+	}
+}
 
-	if ((!instance) || (!instance->data.entries))
+/* prefetches the slots that will be examined first when looking up a key with the given hash */
+static FORCE_INLINE void prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		swiss_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		cuckoo_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_prefetch_slot(data, hash);
+		break;
+	default:
+		bitmap_prefetch_slot(data, hash);
+	}
+}
+
+/* returns FALSE, if the entry can not be stored without growing the table first; the cuckoo engine may place the entry in a different slot than the given one, which is then returned */
+static FORCE_INLINE bool_t put_entry(hash_data_t *const data, const hash_param_t *const param, size_t *const index, const uint64_t hash, const value_t key, const value_t value, const bool_t reusing)
+{
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		swiss_put_entry(data, *index, hash, key, value);
+		return TRUE;
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_put_entry(data, *index, hash, key, value);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_put_entry(data, param, index, hash, key, value);
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_put_entry(data, *index, key, value);
+		return TRUE;
+	default:
+		bitmap_put_entry(data, *index, key, value, reusing);
+		return TRUE;
 	}
+}
+
+/* returns TRUE, if the slot was turned into a "deleted" slot, or FALSE, if the slot was turned into an "unused" slot */
+static FORCE_INLINE bool_t erase_entry(hash_data_t *const data, const size_t index)
+{
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		return swiss_erase_entry(data, index);
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_erase_entry(data, index);
+		return FALSE;
+	case HASHSET_ENGINE_CUCKOO:
+		clear_flag(data->used, index);
+		return FALSE;
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_erase_entry(data, index);
+	default:
+		set_flag(data->deleted, index);
+		return TRUE;
+	}
+}
 
-	if (find_slot(&instance->data, instance->basis, key, &index, &slot_reused))
+static FORCE_INLINE bool_t is_valid(const hash_data_t *const data, const size_t index)
+{
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		return IS_FULL(data->ctrl[index]);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return (data->dist[index] != DIST_EMPTY);
+	case HASHSET_ENGINE_CUCKOO:
+		return get_flag(data->used, index);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_is_valid(data, index);
+	default:
+		return IS_VALID(*data, index);
+	}
+}
+
+/* returns the index of the first valid slot at or after the given index, or the count (at most the slot count), if there is none; empty regions are skipped a word (or a group) at a time */
+static INLINE size_t next_valid(const hash_data_t *const data, size_t index, const size_t count)
+{
+	switch (data->engine)
 	{
-		if (update)
+	case HASHSET_ENGINE_SWISS:
+		return next_full(data->ctrl, index, count);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return next_nonzero(data->dist, index, count); /*DIST_EMPTY is zero*/
+	case HASHSET_ENGINE_CUCKOO:
+		return next_flag(data->used, NULL, index, count);
+	case HASHSET_ENGINE_SENTINEL:
+		while ((index < count) && (!sentinel_is_valid(data, index)))
 		{
-			instance->data.entries[index].value = value;
+			++index;
 		}
-		return EEXIST;
+		return (index < count) ? index : count;
+	default:
+		return next_flag(data->used, data->deleted, index, count);
 	}
+}
 
-	if ((!slot_reused) && (safe_add(instance->valid, instance->deleted) >= instance->limit))
+/* copies the keys and/or values from the valid slots, starting at the given index, until the buffers are full or the limit is reached; returns the index where to continue */
+static INLINE size_t copy_entries(const hash_data_t *const data, size_t index, const size_t limit, value_t *const keys, value_t *const values, const size_t capacity, size_t *const total)
+{
+	while ((*total < capacity) && ((index = next_valid(data, index, limit)) < limit))
 	{
-		if (instance->data.capacity < SIZE_MAX)
+		if (keys)
 		{
-			const errno_t error = rebuild_map(instance, safe_times2(instance->data.capacity));
-			if (error)
-			{
-				return error;
-			}
-			if (find_slot(&instance->data, instance->basis, key, &index, &slot_reused))
-			{
-				return EFAULT;
-			}
+			keys[*total] = KEY(data, index);
 		}
-		else
+		if (values)
 		{
-			return EFBIG; /*can not grow any futher!*/
+			values[*total] = VALUE(data, index);
 		}
+		++(*total);
+		++index;
 	}
 
-	put_entry(&instance->data, index, key, value, slot_reused);
-
-	instance->valid = safe_incr(instance->valid);
-	if (slot_reused)
-	{
-		instance->deleted = safe_decr(instance->deleted);
-	}
-
-	return 0;
+	return index;
 }
 
-errno_t DECLARE(hash_map_contains)(const hash_map_t *const instance, const value_t key)
+static INLINE char get_status(const hash_data_t *const data, const size_t index)
 {
-	if ((!instance) || (!instance->data.entries))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		return IS_FULL(data->ctrl[index]) ? 'v' : ((data->ctrl[index] == CTRL_DELETED) ? 'd' : 'u');
+	case HASHSET_ENGINE_ROBINHOOD:
+		return (data->dist[index] != DIST_EMPTY) ? 'v' : 'u';
+	case HASHSET_ENGINE_CUCKOO:
+		return get_flag(data->used, index) ? 'v' : 'u';
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_get_status(data, index);
+	default:
+		return get_flag(data->used, index) ? (get_flag(data->deleted, index) ? 'd' : 'v') : 'u';
 	}
-
-	return (instance->valid && find_slot(&instance->data, instance->basis, key, NULL, NULL)) ? 0 : ENOENT;
 }
 
-errno_t DECLARE(hash_map_get)(const hash_map_t *const instance, const value_t key, value_t *const value)
+/* the slot (or the first slot of the group/bucket) where the probe sequence for the given hash continues after the given number of steps */
+static FORCE_INLINE size_t resume_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const size_t steps)
 {
-	size_t index;
+	probe_t probe;
+	size_t first;
 
-	if ((!instance) || (!instance->data.entries))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		probe_init(&probe, param, hash >> 7, data->capacity / GROUP_SIZE);
+		probe_skip(&probe, steps, data->capacity / GROUP_SIZE);
+		return probe.index * GROUP_SIZE;
+	case HASHSET_ENGINE_ROBINHOOD:
+		return ((size_t)hash + steps) & (data->capacity - 1U);
+	case HASHSET_ENGINE_CUCKOO:
+		first = bucket_first(hash, data->capacity / BUCKET_SIZE);
+		return (steps ? bucket_other(hash, first, data->capacity / BUCKET_SIZE) : first) * BUCKET_SIZE;
+	default:
+		probe_init(&probe, param, hash, data->capacity);
+		probe_skip(&probe, steps, data->capacity);
+		return probe.index;
 	}
+}
 
-	if (!find_slot(&instance->data, instance->basis, key, &index, NULL))
+/* bulk construction: tries to store the entry without ever touching a slot outside of the given region; the number of steps is updated, if the entry is deferred */
+static FORCE_INLINE place_t place_entry(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, const value_t value, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	switch (data->engine)
 	{
-		return ENOENT;
+	case HASHSET_ENGINE_SWISS:
+		return swiss_place_entry(data, param, hash, key, value, region, steps, index_out);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_place_entry(data, hash, key, value, region, steps, index_out);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_place_entry(data, hash, key, value, region, steps, index_out);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_place_entry(data, param, hash, key, value, region, steps, index_out);
+	default:
+		return bitmap_place_entry(data, param, hash, key, value, region, steps, index_out);
 	}
-
-	*value = instance->data.entries[index].value;
-	return 0;
 }
 
-errno_t DECLARE(hash_map_remove)(hash_map_t *const instance, const value_t key, value_t *const value)
+/* returns FALSE, if the required scratch memory could not be allocated */
+static INLINE bool_t purge_data(hash_data_t *const data, const hash_param_t *const param)
 {
-	size_t index;
-
-	if ((!instance) || (!instance->data.entries))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		swiss_purge_data(data, param);
+		return TRUE;
+	case HASHSET_ENGINE_ROBINHOOD:
+	case HASHSET_ENGINE_CUCKOO:
+		return TRUE; /*never leaves any "deleted" slots*/
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_purge_data(data, param);
+	default:
+		bitmap_purge_data(data, param);
+		return TRUE;
 	}
+}
 
-	if ((!instance->valid) || (!find_slot(&instance->data, instance->basis, key, &index, NULL)))
+static INLINE void clear_data(hash_data_t *const data)
+{
+	switch (data->engine)
 	{
-		return ENOENT;
+	case HASHSET_ENGINE_SWISS:
+		swiss_clear_data(data);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_clear_data(data);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		cuckoo_clear_data(data);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_clear_data(data);
+		break;
+	default:
+		bitmap_clear_data(data);
 	}
+}
 
-	SAFE_SET(value, instance->data.entries[index].value);
-	set_flag(instance->data.deleted, index);
-	instance->deleted = safe_incr(instance->deleted);
-	instance->valid = safe_decr(instance->valid);
+/* ------------------------------------------------- */
+/* Concurrent readers                                */
+/* ------------------------------------------------- */
 
-	if (!instance->valid)
-	{
-		return DECLARE(hash_map_clear)(instance);
-	}
+#define COLLECT_INTERVAL 256U
 
-	if (instance->deleted > (instance->limit / 2U))
+static FORCE_INLINE bool_t find_shared(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out)
+{
+	switch (data->engine)
 	{
-		const size_t min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
-		const errno_t error = rebuild_map(instance, (instance->data.capacity > min_capacity) ? min_capacity : instance->data.capacity);
-		if (error && (error != ENOMEM))
-		{
-			return error;
-		}
+	case HASHSET_ENGINE_SWISS:
+		return swiss_find_shared(data, param, hash, key, index_out);
+	default:
+		return bitmap_find_shared(data, param, hash, key, index_out);
 	}
-
-	return 0;
 }
 
-errno_t DECLARE(hash_map_clear)(hash_map_t *const instance)
+/* while readers may be looking at the table, a slot is never re-used for a different key; the "deleted" slots are only reclaimed by the next rebuild */
+static FORCE_INLINE size_t unused_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash)
 {
-	if ((!instance) || (!instance->data.entries))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		return swiss_unused_slot(data, param, hash);
+	default:
+		return bitmap_unused_slot(data, param, hash);
 	}
+}
 
-	if (instance->valid || instance->deleted)
-	{
-		const size_t count = div_ceil(instance->data.capacity, 8U);
-		instance->valid = instance->deleted = 0U;
-		zero_memory(instance->data.used, count, sizeof(uint8_t));
-		zero_memory(instance->data.deleted, count, sizeof(uint8_t));
-	}
-	else
+/* in contrast to erase_entry(), the slot always becomes a "deleted" slot, so that it can not be re-used */
+static FORCE_INLINE void erase_shared(hash_data_t *const data, const size_t index)
+{
+	switch (data->engine)
 	{
-		return EAGAIN;
+	case HASHSET_ENGINE_SWISS:
+		data->ctrl[index] = CTRL_DELETED;
+		break;
+	default:
+		set_flag(data->deleted, index);
 	}
+}
+
+/* releases the retired tables that none of the readers can still be looking at */
+static INLINE void reclaim_shared(hash_map_t *const instance)
+{
+	const uint64_t oldest = epoch_oldest(&instance->shared->epoch);
+	snapshot_t **link = &instance->shared->retired;
 
-	if (instance->data.capacity > MINIMUM_CAPACITY)
+	while (*link)
 	{
-		const errno_t error = rebuild_map(instance, MINIMUM_CAPACITY);
-		if (error && (error != ENOMEM))
+		snapshot_t *const snapshot = *link;
+		if (snapshot->retired <= oldest)
 		{
-			return error;
+			*link = snapshot->next;
+			free_data(&snapshot->data);
+			heap_free(&instance->allocator, snapshot);
+		}
+		else
+		{
+			link = &snapshot->next;
 		}
 	}
 
-	return 0;
+	instance->collect = 0U;
 }
 
-errno_t DECLARE(hash_map_iterate)(const hash_map_t *const instance, size_t *const cursor, value_t *const key, value_t *const value)
+/* a reader that is still busy blocks the reclamation of the previous table, so another attempt is made every COLLECT_INTERVAL operations */
+static FORCE_INLINE void collect_shared(hash_map_t *const instance)
 {
-	size_t index;
-
-	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.entries))
+	if (instance->shared && instance->shared->retired && (++instance->collect >= COLLECT_INTERVAL))
 	{
-		return EINVAL;
+		reclaim_shared(instance);
 	}
+}
 
-	for (index = *cursor; index < instance->data.capacity; ++index)
+/* makes the given table the current table; with concurrent readers, the previous table is retired instead of being released immediately */
+static INLINE bool_t replace_data(hash_map_t *const instance, const hash_data_t *const data)
+{
+	if (instance->shared)
 	{
-		if (IS_VALID(instance->data, index))
+		snapshot_t *const previous = instance->shared->current;
+		snapshot_t *const snapshot = (snapshot_t*) heap_calloc(&instance->allocator, 1U, sizeof(snapshot_t));
+		if (!snapshot)
 		{
-			const entry_t* const entntry = &instance->data.entries[index];
-			SAFE_SET(key, entntry->key);
-			SAFE_SET(value, entntry->value);
-			*cursor = index + 1U;
-			return 0;
+			return FALSE;
 		}
+		snapshot->data = *data;
+		atomic_store_ptr((void *volatile*)&instance->shared->current, snapshot);
+		previous->retired = epoch_advance(&instance->shared->epoch);
+		previous->next = instance->shared->retired;
+		instance->shared->retired = previous;
+		reclaim_shared(instance);
+	}
+	else
+	{
+		free_data(&instance->data);
 	}
 
-	*cursor = SIZE_MAX;
-	return ENOENT;
+	instance->data = *data;
+	return TRUE;
+}
+
+/* returns FALSE, if the engine does not support concurrent readers, or if the shared state could not be allocated */
+static INLINE bool_t init_shared(hash_map_t *const instance)
+{
+	snapshot_t *snapshot;
+
+	if ((instance->data.engine != HASHSET_ENGINE_DEFAULT) && (instance->data.engine != HASHSET_ENGINE_BITMAP) && (instance->data.engine != HASHSET_ENGINE_SWISS))
+	{
+		return FALSE;
+	}
+
+	instance->shared_block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->shared = (shared_t*) alloc_block(sizeof(shared_t), &instance->shared_block);
+	if (!instance->shared)
+	{
+		return FALSE;
+	}
+
+	snapshot = (snapshot_t*) heap_calloc(&instance->allocator, 1U, sizeof(snapshot_t));
+	if (!snapshot)
+	{
+		free_block(&instance->shared_block);
+		instance->shared = NULL;
+		return FALSE;
+	}
+
+	epoch_init(&instance->shared->epoch);
+	snapshot->data = instance->data;
+	instance->shared->current = snapshot;
+	instance->shared->hash = instance->hash;
+	instance->incremental = FALSE; /*readers only ever look at a single table*/
+
+	return TRUE;
+}
+
+/* releases all retired tables, all readers must have been detached; the current table is still owned by the instance */
+static INLINE void free_shared(hash_map_t *const instance)
+{
+	if (instance->shared)
+	{
+		while (instance->shared->retired)
+		{
+			snapshot_t *const snapshot = instance->shared->retired;
+			instance->shared->retired = snapshot->next;
+			free_data(&snapshot->data);
+			heap_free(&instance->allocator, snapshot);
+		}
+		heap_free(&instance->allocator, instance->shared->current);
+		free_block(&instance->shared_block);
+		instance->shared = NULL;
+	}
+}
+
+/* ------------------------------------------------- */
+/* Partitioned build                                 */
+/* ------------------------------------------------- */
+
+typedef struct
+{
+	hash_data_t *data;
+	const hash_data_t *source; /*NULL, if the entries are taken from two arrays*/
+	const hash_param_t *param;
+	const value_t *keys, *values;
+	const build_ref_t *input; /*NULL in the first round, where the input positions are taken as they are*/
+	build_ref_t *order;
+	size_t *counts;
+	region_t region;
+	size_t shift, begin, end, placed, duplicates, resumable;
+	bool_t update;
+	int phase;
+}
+build_task_t;
+
+/* returns FALSE, if the input position does not hold a valid entry */
+static FORCE_INLINE bool_t build_input(const build_task_t *const task, const size_t k, build_ref_t *const ref)
+{
+	if (task->input)
+	{
+		*ref = task->input[k];
+		return TRUE;
+	}
+
+	ref->index = k;
+	ref->steps = 0U;
+	return (!task->source) || is_valid(task->source, k);
+}
+
+/* the region where the probe sequence of the key continues; the entries that have to be inserted sequentially are kept in the last region */
+static FORCE_INLINE size_t build_region(const build_task_t *const task, const build_ref_t *const ref)
+{
+	if (ref->steps == STEPS_SERIAL)
+	{
+		return task->region.count - 1U;
+	}
+
+	return region_of(resume_slot(task->data, task->param, hash_compute(task->param, task->keys[ref->index << task->shift]), ref->steps), task->region.count, task->region.unit_shift);
+}
+
+/* phase 0: count the keys of each region, phase 1: sort the keys by region, phase 2: place the entries of one region */
+static void build_task(void *const context)
+{
+	build_task_t *const task = (build_task_t*) context;
+	hash_data_t *const data = task->data;
+	size_t *const counts = task->counts + (task->region.id * task->region.count);
+	size_t k, index, deferred;
+	build_ref_t ref;
+
+	switch (task->phase)
+	{
+	case 0:
+		for (k = 0U; k < task->region.count; ++k)
+		{
+			counts[k] = 0U;
+		}
+		for (k = task->begin; k < task->end; ++k)
+		{
+			if (build_input(task, k, &ref))
+			{
+				++counts[build_region(task, &ref)];
+			}
+		}
+		break;
+	case 1:
+		for (k = task->begin; k < task->end; ++k)
+		{
+			if (build_input(task, k, &ref))
+			{
+				task->order[counts[build_region(task, &ref)]++] = ref;
+			}
+		}
+		break;
+	case 2:
+		for (k = deferred = task->begin; k < task->end; ++k)
+		{
+			ref = task->order[k];
+			if (ref.steps != STEPS_SERIAL)
+			{
+				const value_t key = task->keys[ref.index << task->shift];
+				switch (place_entry(data, task->param, hash_compute(task->param, key), key, task->values[ref.index << task->shift], &task->region, &ref.steps, &index))
+				{
+				case PLACE_DONE:
+					++task->placed;
+					continue;
+				case PLACE_EXISTS:
+					if (task->update)
+					{
+						VALUE(data, index) = task->values[ref.index << task->shift];
+					}
+					++task->duplicates;
+					continue;
+				case PLACE_DEFER:
+					++task->resumable;
+					break;
+				default:
+					ref.steps = STEPS_SERIAL;
+				}
+			}
+			task->order[deferred++] = ref;
+		}
+		task->end = deferred;
+		break;
+	}
+}
+
+/* runs all phases on the input positions [first, last), then once more on the deferred entries, for as long as enough of them can be resumed in another region; "scratch" must have room for 2 * (last - first) references, afterwards the [begin, end) range of the "order" of each task holds the entries that are to be inserted sequentially */
+static INLINE void run_build(build_task_t *const tasks, const size_t threads, const size_t first, const size_t last, build_ref_t *const scratch)
+{
+	const size_t count = last - first;
+	size_t t, r, offset, round, resumable;
+	const size_t unit_shift = log2_pow2(tasks[0U].data->capacity / PARALLEL_MIN_SLOTS);
+
+	for (t = 0U; t < threads; ++t)
+	{
+		tasks[t].region.id = t;
+		tasks[t].region.count = threads;
+		tasks[t].region.unit_shift = unit_shift;
+		tasks[t].input = NULL;
+		tasks[t].begin = first + ((count / threads) * t);
+		tasks[t].end = (t + 1U < threads) ? (first + ((count / threads) * (t + 1U))) : last;
+		tasks[t].placed = tasks[t].duplicates = 0U;
+	}
+
+	for (round = 0U; ; ++round)
+	{
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].order = scratch + ((round & 1U) ? count : 0U);
+			tasks[t].phase = 0;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (r = 0U, offset = 0U; r < threads; ++r)
+		{
+			for (t = 0U; t < threads; ++t)
+			{
+				const size_t region_count = tasks[0U].counts[(t * threads) + r];
+				tasks[0U].counts[(t * threads) + r] = offset;
+				offset += region_count;
+			}
+		}
+
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].phase = 1;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].phase = 2;
+			tasks[t].begin = t ? tasks[0U].counts[((threads - 1U) * threads) + (t - 1U)] : 0U;
+			tasks[t].end = tasks[0U].counts[((threads - 1U) * threads) + t];
+			tasks[t].resumable = 0U;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (t = 0U, resumable = 0U; t < threads; ++t)
+		{
+			resumable += tasks[t].resumable;
+			tasks[t].input = tasks[t].order;
+		}
+
+		if (resumable < PARALLEL_MIN_DEFERRED)
+		{
+			break;
+		}
+	}
+}
+
+/* ------------------------------------------------- */
+/* Map functions                                     */
+/* ------------------------------------------------- */
+
+static INLINE size_t compute_limit(const size_t capacity, const double load_factor)
+{
+	size_t limit = round_sz(capacity * load_factor);
+
+	while (capacity && (limit >= capacity))
+	{
+		limit = safe_decr(limit);
+	}
+
+	return limit;
+}
+
+/* stores an entry whose key is known to be absent from the table, returns ENOSPC, if the entry could not be stored */
+static INLINE errno_t transfer_entry(hash_data_t *const data, const hash_param_t *const param, const value_t key, const value_t value)
+{
+	size_t index = SIZE_MAX;
+	const uint64_t hash = hash_compute(param, key);
+
+	if (find_slot(data, param, hash, key, &index, NULL))
+	{
+		return EFAULT; /*this should never happen!*/
+	}
+
+	return put_entry(data, param, &index, hash, key, value, FALSE) ? 0 : ENOSPC;
+}
+
+/* stores all entries of the source table in the target table */
+static INLINE errno_t transfer_entries(const hash_data_t *const source, hash_data_t *const target, const hash_param_t *const param)
+{
+	size_t k;
+	errno_t error = 0;
+
+	for (k = 0U; (k < slot_count(source)) && (!error); ++k)
+	{
+		if (is_valid(source, k))
+		{
+			error = transfer_entry(target, param, KEY(source, k), VALUE(source, k));
+		}
+	}
+
+	return error;
+}
+
+/* the entries of the current table are partitioned by the region of the new table that contains their home slot, then each region is filled by its own thread; the current table is processed in chunks of PARALLEL_CHUNK slots, so that the scratch buffer does not grow with the table; returns ENOMEM without touching the new table, if the buffers could not be allocated */
+static INLINE errno_t transfer_parallel(const hash_map_t *const instance, hash_data_t *const target, const size_t threads)
+{
+	build_task_t tasks[MAX_THREADS];
+	const size_t count = slot_count(&instance->data), chunk = (count < PARALLEL_CHUNK) ? count : PARALLEL_CHUNK;
+	size_t first, k, t;
+	errno_t error = 0;
+	build_ref_t *order = (build_ref_t*) heap_alloc(&instance->allocator, safe_mult(chunk, 2U * sizeof(build_ref_t)));
+	size_t *counts = (size_t*) heap_calloc(&instance->allocator, threads * threads, sizeof(size_t));
+
+	if ((!order) || (!counts))
+	{
+		HEAP_FREE(&instance->allocator, counts);
+		HEAP_FREE(&instance->allocator, order);
+		return ENOMEM;
+	}
+
+	for (t = 0U; t < threads; ++t)
+	{
+		zero_memory(&tasks[t], 1U, sizeof(build_task_t));
+		tasks[t].data = target;
+		tasks[t].source = &instance->data;
+		tasks[t].param = &instance->hash;
+		tasks[t].keys = instance->data.keys;
+		tasks[t].values = instance->data.values;
+		tasks[t].shift = instance->data.shift;
+		tasks[t].counts = counts;
+	}
+
+	for (first = 0U; (first < count) && (!error); first += chunk)
+	{
+		run_build(tasks, threads, first, (count - first > chunk) ? (first + chunk) : count, order);
+
+		for (t = 0U; (t < threads) && (!error); ++t)
+		{
+			if (tasks[t].duplicates)
+			{
+				error = EFAULT; /*this should never happen!*/
+			}
+			for (k = tasks[t].begin; (k < tasks[t].end) && (!error); ++k)
+			{
+				error = transfer_entry(target, &instance->hash, KEY(&instance->data, tasks[t].order[k].index), VALUE(&instance->data, tasks[t].order[k].index));
+			}
+		}
+	}
+
+	HEAP_FREE(&instance->allocator, counts);
+	HEAP_FREE(&instance->allocator, order);
+	return error;
+}
+
+/* moves all entries into a new table, including those that are still waiting in the old table of an incremental resize */
+static INLINE errno_t rebuild_map(hash_map_t *const instance, const size_t new_capacity)
+{
+	const size_t threads = parallel_threads(thread_count(instance->threads), instance->valid - instance->pending);
+	errno_t error = 0;
+	hash_data_t temp;
+
+	if (new_capacity < instance->valid)
+	{
+		return EINVAL;
+	}
+
+	if ((new_capacity == instance->data.capacity) && (!instance->pending) && (!instance->shared)) /*readers may still be looking at the current table*/
+	{
+		if (!purge_data(&instance->data, &instance->hash)) /*same capacity: the "deleted" slots are purged in-place*/
+		{
+			return ENOMEM;
+		}
+		instance->deleted = 0U;
+		return 0;
+	}
+
+	if (!alloc_data(&temp, instance->data.engine, instance->data.layout, instance->data.block.memory, new_capacity))
+	{
+		return ENOMEM;
+	}
+
+	if (threads > 1U)
+	{
+		error = transfer_parallel(instance, &temp, threads);
+	}
+
+	if ((threads < 2U) || (error == ENOMEM))
+	{
+		error = transfer_entries(&instance->data, &temp, &instance->hash);
+	}
+
+	if ((!error) && instance->pending)
+	{
+		error = transfer_entries(&instance->old, &temp, &instance->hash);
+	}
+
+	if (error)
+	{
+		free_data(&temp);
+		if (error == ENOSPC)
+		{
+			return (new_capacity < SIZE_MAX) ? rebuild_map(instance, safe_times2(new_capacity)) : EFBIG;
+		}
+		return error;
+	}
+
+	if (!replace_data(instance, &temp))
+	{
+		free_data(&temp);
+		return ENOMEM;
+	}
+
+	free_data(&instance->old);
+	instance->pending = instance->migrated = 0U;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->deleted = 0U;
+
+	return 0;
+}
+
+/* moves the entries of up to "count" slots from the old table into the current table, the old table is released as soon as it has become empty */
+static INLINE errno_t migrate_map(hash_map_t *const instance, size_t count)
+{
+	for (; instance->pending && count; --count)
+	{
+		assert(instance->migrated < slot_count(&instance->old));
+		if (is_valid(&instance->old, instance->migrated))
+		{
+			const value_t key = KEY(&instance->old, instance->migrated);
+			const uint64_t hash = hash_compute(&instance->hash, key);
+			size_t index = SIZE_MAX;
+			bool_t slot_reused = FALSE;
+			if (find_slot(&instance->data, &instance->hash, hash, key, &index, &slot_reused))
+			{
+				return EFAULT; /*this should never happen!*/
+			}
+			if (!put_entry(&instance->data, &instance->hash, &index, hash, key, VALUE(&instance->old, instance->migrated), slot_reused))
+			{
+				return (instance->data.capacity < SIZE_MAX) ? rebuild_map(instance, safe_times2(instance->data.capacity)) : EFBIG;
+			}
+			if (slot_reused)
+			{
+				instance->deleted = safe_decr(instance->deleted);
+			}
+			erase_entry(&instance->old, instance->migrated); /*robinhood engine: the next entry may be shifted into this slot*/
+			--instance->pending;
+		}
+		else
+		{
+			++instance->migrated;
+		}
+	}
+
+	if ((!instance->pending) && instance->old.block.addr)
+	{
+		free_data(&instance->old);
+		instance->migrated = 0U;
+	}
+
+	return 0;
+}
+
+/* switches to a new, empty table; the entries of the previous table are moved over by the subsequent insert and remove operations */
+static INLINE errno_t begin_migration(hash_map_t *const instance, const size_t new_capacity)
+{
+	hash_data_t temp;
+
+	assert(!instance->pending);
+
+	if (!alloc_data(&temp, instance->data.engine, instance->data.layout, instance->data.block.memory, new_capacity))
+	{
+		return ENOMEM;
+	}
+
+	instance->old = instance->data;
+	instance->data = temp;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->pending = instance->valid;
+	instance->migrated = instance->deleted = 0U;
+
+	return migrate_map(instance, 0U);
+}
+
+static INLINE errno_t grow_map(hash_map_t *const instance, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
+{
+	if (instance->data.capacity < SIZE_MAX)
+	{
+		const errno_t error = (instance->incremental && (!instance->pending)) ? begin_migration(instance, safe_mult(instance->data.capacity, instance->growth)) : rebuild_map(instance, safe_mult(instance->data.capacity, instance->growth));
+		if (error)
+		{
+			return error;
+		}
+		if (find_slot(&instance->data, &instance->hash, hash, key, index_out, reused_out))
+		{
+			return EFAULT; /*this should never happen!*/
+		}
+		if (instance->shared && (*reused_out))
+		{
+			*index_out = unused_slot(&instance->data, &instance->hash, hash);
+			*reused_out = FALSE;
+		}
+		return 0;
+	}
+
+	return EFBIG; /*can not grow any futher!*/
+}
+
+static INLINE errno_t clear_map(hash_map_t *const instance)
+{
+	if (instance->shared) /*readers may still be looking at the current table, so it is replaced by an empty one*/
+	{
+		hash_data_t temp;
+		if (!alloc_data(&temp, instance->data.engine, instance->data.layout, instance->data.block.memory, ((instance->shrink == HASHSET_SHRINK_AUTO) && (instance->data.capacity > MINIMUM_CAPACITY)) ? MINIMUM_CAPACITY : instance->data.capacity))
+		{
+			return ENOMEM;
+		}
+		if (!replace_data(instance, &temp))
+		{
+			free_data(&temp);
+			return ENOMEM;
+		}
+		instance->valid = instance->deleted = 0U;
+		instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+		return 0;
+	}
+
+	instance->valid = instance->deleted = instance->pending = instance->migrated = 0U;
+	free_data(&instance->old);
+	clear_data(&instance->data);
+
+	if ((instance->shrink == HASHSET_SHRINK_AUTO) && (instance->data.capacity > MINIMUM_CAPACITY))
+	{
+		const errno_t error = rebuild_map(instance, MINIMUM_CAPACITY);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/* inserts the key with the given value, unless the key is already present; either way, a pointer to the value that is associated with the key is returned, which remains valid until the map is modified again */
+static INLINE errno_t upsert_entry(hash_map_t *const instance, const uint64_t hash, const value_t key, const value_t value, value_t **const slot_out)
+{
+	size_t index = SIZE_MAX;
+	bool_t slot_reused = FALSE;
+
+	if (instance->pending)
+	{
+		const errno_t error = migrate_map(instance, MIGRATE_SLOTS);
+		if (error)
+		{
+			return error;
+		}
+		if (instance->pending && find_slot(&instance->old, &instance->hash, hash, key, &index, NULL))
+		{
+			*slot_out = &VALUE(&instance->old, index);
+			return EEXIST;
+		}
+	}
+
+	collect_shared(instance);
+
+	if (find_slot(&instance->data, &instance->hash, hash, key, &index, &slot_reused))
+	{
+		*slot_out = &VALUE(&instance->data, index);
+		return EEXIST;
+	}
+
+	if (instance->shared && slot_reused)
+	{
+		index = unused_slot(&instance->data, &instance->hash, hash);
+		slot_reused = FALSE;
+	}
+
+	if ((!slot_reused) && (safe_add(instance->valid, instance->deleted) >= instance->limit))
+	{
+		const errno_t error = grow_map(instance, hash, key, &index, &slot_reused);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	while (!put_entry(&instance->data, &instance->hash, &index, hash, key, value, slot_reused))
+	{
+		const errno_t error = grow_map(instance, hash, key, &index, &slot_reused);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	instance->valid = safe_incr(instance->valid);
+	if (slot_reused)
+	{
+		instance->deleted = safe_decr(instance->deleted);
+	}
+
+	*slot_out = &VALUE(&instance->data, index);
+	return 0;
+}
+
+static INLINE errno_t insert_entry(hash_map_t *const instance, const uint64_t hash, const value_t key, const value_t value, const bool_t update)
+{
+	value_t *slot;
+	const errno_t error = upsert_entry(instance, hash, key, value, &slot);
+
+	if ((error == EEXIST) && update)
+	{
+		*slot = value;
+	}
+
+	return error;
+}
+
+/* applies the given operation to the value that is already associated with the key; otherwise, the key is inserted with the given value */
+static INLINE errno_t accumulate_entry(hash_map_t *const instance, const uint64_t hash, const value_t key, const value_t value, const hash_accumulate_t accumulate)
+{
+	value_t *slot;
+	const errno_t error = upsert_entry(instance, hash, key, value, &slot);
+
+	if (error == EEXIST)
+	{
+		switch (accumulate)
+		{
+		case HASHSET_ACCUMULATE_MIN:
+			*slot = (value < *slot) ? value : *slot;
+			break;
+		case HASHSET_ACCUMULATE_MAX:
+			*slot = (value > *slot) ? value : *slot;
+			break;
+		case HASHSET_ACCUMULATE_XOR:
+			*slot ^= value;
+			break;
+		default:
+			*slot += value;
+		}
+	}
+
+	return error;
+}
+
+static INLINE errno_t remove_entry(hash_map_t *const instance, const uint64_t hash, const value_t key, value_t *const value)
+{
+	size_t index;
+
+	if (!instance->valid)
+	{
+		return ENOENT;
+	}
+
+	if (instance->pending)
+	{
+		const errno_t error = migrate_map(instance, MIGRATE_SLOTS);
+		if (error)
+		{
+			return error;
+		}
+		if (instance->pending && find_slot(&instance->old, &instance->hash, hash, key, &index, NULL))
+		{
+			SAFE_SET(value, VALUE(&instance->old, index));
+			erase_entry(&instance->old, index);
+			--instance->pending;
+			instance->valid = safe_decr(instance->valid);
+			return migrate_map(instance, 0U);
+		}
+	}
+
+	collect_shared(instance);
+
+	if (!find_slot(&instance->data, &instance->hash, hash, key, &index, NULL))
+	{
+		return ENOENT;
+	}
+
+	SAFE_SET(value, VALUE(&instance->data, index));
+
+	if (instance->shared)
+	{
+		erase_shared(&instance->data, index);
+		instance->deleted = safe_incr(instance->deleted);
+	}
+	else if (erase_entry(&instance->data, index))
+	{
+		instance->deleted = safe_incr(instance->deleted);
+	}
+
+	instance->valid = safe_decr(instance->valid);
+	return 0;
+}
+
+/* looks up the key in the current table and, while an incremental resize is in progress, in the old table; returns a pointer to the value, or NULL */
+static FORCE_INLINE value_t *find_entry(const hash_map_t *const instance, const uint64_t hash, const value_t key)
+{
+	size_t index;
+
+	if (find_slot(&instance->data, &instance->hash, hash, key, &index, NULL))
+	{
+		return &VALUE(&instance->data, index);
+	}
+
+	if (instance->pending && find_slot(&instance->old, &instance->hash, hash, key, &index, NULL))
+	{
+		return &VALUE(&instance->old, index);
+	}
+
+	return NULL;
+}
+
+/* to be called after entries have been removed: releases the table if it has become empty, or gets rid of excess "deleted" slots */
+static INLINE errno_t compact_map(hash_map_t *const instance)
+{
+	size_t min_capacity;
+	bool_t shrink;
+
+	if (!instance->valid)
+	{
+		return clear_map(instance);
+	}
+
+	/* with a shrink threshold, the capacity is reduced as soon as the table is loaded lightly enough, otherwise only while getting rid of "deleted" slots */
+	min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
+	shrink = (instance->shrink != HASHSET_SHRINK_NEVER) && (min_capacity < instance->data.capacity) && ((instance->shrink_threshold <= 0.0) || (instance->valid < round_sz(instance->limit * instance->shrink_threshold)));
+
+	if ((instance->deleted > (instance->limit / 2U)) || (shrink && (instance->shrink_threshold > 0.0)))
+	{
+		const errno_t error = rebuild_map(instance, shrink ? min_capacity : instance->data.capacity);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/* makes sure that the given number of additional entries can be inserted without a rebuild, the table is left unchanged, if the allocation fails */
+static INLINE errno_t reserve_map(hash_map_t *const instance, const size_t count)
+{
+	if (safe_add(safe_add(instance->valid, instance->deleted), count) > instance->limit)
+	{
+		const size_t min_capacity = next_pow2(round_sz(safe_add(safe_incr(instance->valid), count) / instance->load_factor));
+		const errno_t error = rebuild_map(instance, (instance->data.capacity < min_capacity) ? min_capacity : instance->data.capacity);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/* the slots of the key that is PREFETCH_DISTANCE positions ahead are prefetched while the current key is looked up */
+static INLINE size_t get_batch(const hash_map_t *const instance, const value_t *const keys, const size_t count, value_t *const values, uint8_t *const found)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k, total = 0U;
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, keys[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, keys[k + PREFETCH_DISTANCE]));
+		}
+		const value_t *const value = find_entry(instance, hash, keys[k]);
+		if (value)
+		{
+			if (values)
+			{
+				values[k] = *value;
+			}
+			if (found)
+			{
+				set_flag(found, k);
+			}
+			++total;
+		}
+		else if (found)
+		{
+			clear_flag(found, k);
+		}
+	}
+
+	return total;
+}
+
+/* the number of keys that are not present yet; the keys need to be looked up only if the table would otherwise have to grow */
+static INLINE size_t missing_keys(const hash_map_t *const instance, const value_t *const keys, const size_t count)
+{
+	if ((!instance->valid) || (safe_add(safe_add(instance->valid, instance->deleted), count) <= instance->limit))
+	{
+		return count;
+	}
+
+	return count - get_batch(instance, keys, count, NULL, NULL);
+}
+
+/* ------------------------------------------------- */
+/* Bulk construction                                 */
+/* ------------------------------------------------- */
+
+/* entries are partitioned by the table region that contains their home slot, then each region is filled by its own thread; entries whose probe sequence leaves the region are handed over to the thread that owns the region where it continues, only the few that are left over are inserted sequentially afterwards; the input is processed in chunks of PARALLEL_CHUNK entries */
+static INLINE errno_t build_map(hash_map_t *const instance, const value_t *const keys, const value_t *const values, const size_t count, const size_t threads, const hash_duplicates_t duplicates, build_ref_t *const order, size_t *const counts)
+{
+	build_task_t tasks[MAX_THREADS];
+	size_t first, k, t, found = 0U;
+
+	for (t = 0U; t < threads; ++t)
+	{
+		zero_memory(&tasks[t], 1U, sizeof(build_task_t));
+		tasks[t].data = &instance->data;
+		tasks[t].param = &instance->hash;
+		tasks[t].keys = keys;
+		tasks[t].values = values;
+		tasks[t].update = (duplicates == HASHSET_DUPLICATES_UPDATE);
+		tasks[t].counts = counts;
+	}
+
+	for (first = 0U; first < count; first += PARALLEL_CHUNK)
+	{
+		run_build(tasks, threads, first, (count - first > PARALLEL_CHUNK) ? (first + PARALLEL_CHUNK) : count, order);
+
+		for (t = 0U; t < threads; ++t)
+		{
+			instance->valid += tasks[t].placed;
+			found += tasks[t].duplicates;
+		}
+
+		if (found && (duplicates == HASHSET_DUPLICATES_FAIL))
+		{
+			return EEXIST;
+		}
+
+		for (t = 0U; t < threads; ++t)
+		{
+			for (k = tasks[t].begin; k < tasks[t].end; ++k)
+			{
+				const size_t index = tasks[t].order[k].index;
+				const errno_t error = insert_entry(instance, hash_compute(&instance->hash, keys[index]), keys[index], values[index], (duplicates == HASHSET_DUPLICATES_UPDATE));
+				if (error && ((error != EEXIST) || (duplicates == HASHSET_DUPLICATES_FAIL)))
+				{
+					return error;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------- */
+/* Construction                                      */
+/* ------------------------------------------------- */
+
+/* applies the settings that are not a property of the table itself; the table must have been set up already */
+static INLINE void apply_options(hash_map_t *const instance, const double load_factor, const hash_options_t *const options)
+{
+	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->threads = options ? options->thread_count : 0U;
+	instance->incremental = options && (options->resize == HASHSET_RESIZE_INCREMENTAL);
+	instance->growth = growth_multiplier(options ? options->growth_factor : 0.0);
+	instance->shrink = (options && (options->shrink != HASHSET_SHRINK_DEFAULT)) ? options->shrink : HASHSET_SHRINK_AUTO;
+	instance->shrink_threshold = options ? BOUND(0.0, options->shrink_threshold, 0.5) : 0.0;
+}
+
+/* initializes a zeroed instance, whose allocator has already been set up; returns FALSE, if the table could not be allocated */
+static INLINE bool_t init_instance(hash_map_t *const instance, const size_t capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options, const memory_t memory)
+{
+	if (!alloc_data(&instance->data, options ? options->engine : HASHSET_ENGINE_DEFAULT, options ? options->layout : HASHSET_LAYOUT_DEFAULT, memory, capacity))
+	{
+		return FALSE;
+	}
+
+	hash_initialize(&instance->hash, options ? options->hash_function : HASHSET_HASH_DEFAULT, options ? options->probe_strategy : HASHSET_PROBE_DEFAULT, seed);
+	apply_options(instance, load_factor, options);
+
+	return TRUE;
+}
+
+static FORCE_INLINE bool_t in_buffer(const hash_map_t *const instance)
+{
+	return (instance->allocator.context == &instance->arena);
+}
+
+/* ------------------------------------------------- */
+/* Sharding                                          */
+/* ------------------------------------------------- */
+
+/* destroys the first "count" shards, as well as the instance itself */
+static INLINE void free_shards(hash_map_concurrent_t *const instance, const size_t count)
+{
+	const hash_allocator_t allocator = instance->allocator;
+	size_t i;
+
+	for (i = 0U; i < count; ++i)
+	{
+		DECLARE(hash_map_destroy)(instance->shards[i].state.instance);
+		lock_destroy(&instance->shards[i].state.lock);
+	}
+
+	free_block(&instance->block);
+	zero_memory(instance, 1U, sizeof(hash_map_concurrent_t));
+	heap_free(&allocator, instance);
+}
+
+/* all shards share the same hash function, so that the hash value needs to be computed only once */
+static FORCE_INLINE shard_state_t *select_shard(const hash_map_concurrent_t *const instance, const uint64_t hash)
+{
+	return &instance->shards[shard_index(hash, instance->shard_count)].state;
+}
+
+/* ------------------------------------------------- */
+/* Parallel scan                                     */
+/* ------------------------------------------------- */
+
+#define SCAN_BUFFER 512U
+
+/* the cursor addresses the slots of the current table, followed by the slots of the previous table, while an incremental resize is pending */
+static FORCE_INLINE size_t cursor_limit(const hash_map_t *const instance)
+{
+	return instance->pending ? safe_add(slot_count(&instance->data), slot_count(&instance->old)) : slot_count(&instance->data);
+}
+
+/* copies the entries from the valid slots in the cursor range [*cursor, end), until the buffer is full */
+static INLINE errno_t export_range(const hash_map_t *const instance, size_t *const cursor, const size_t end, value_t *const keys, value_t *const values, const size_t capacity, size_t *const count)
+{
+	const size_t slots = slot_count(&instance->data);
+	size_t index = *cursor, total = 0U;
+
+	if (index < slots)
+	{
+		index = copy_entries(&instance->data, index, (end < slots) ? end : slots, keys, values, capacity, &total);
+	}
+
+	if (instance->pending && (total < capacity) && (index >= slots) && (index < end))
+	{
+		index = slots + copy_entries(&instance->old, index - slots, ((end - slots) < slot_count(&instance->old)) ? (end - slots) : slot_count(&instance->old), keys, values, capacity, &total);
+	}
+
+	if (!(*count = total))
+	{
+		*cursor = SIZE_MAX;
+		return ENOENT;
+	}
+
+	*cursor = index;
+	return 0;
+}
+
+typedef struct
+{
+	const hash_map_t *instance;
+	hash_map_worker_t callback;
+	void *context;
+	volatile size_t *cancelled;
+	size_t part, begin, end;
+}
+scan_task_t;
+
+/* scans one range of the table, passing the entries to the callback in chunks, until the range is exhausted or any of the callbacks has requested to stop */
+static void scan_task(void *const context)
+{
+	const scan_task_t *const task = (const scan_task_t*) context;
+	value_t keys[SCAN_BUFFER], values[SCAN_BUFFER];
+	size_t cursor = task->begin, count;
+
+	while ((!atomic_load_size(task->cancelled)) && (!export_range(task->instance, &cursor, task->end, keys, values, SCAN_BUFFER, &count)))
+	{
+		if (!task->callback(keys, values, count, task->part, task->context))
+		{
+			atomic_add_size(task->cancelled, 1U);
+		}
+	}
+}
+
+/* ------------------------------------------------- */
+/* Saving and loading                                */
+/* ------------------------------------------------- */
+
+static const char FILE_MAGIC[8U] = "HashMap";
+
+/* the size of each of the arrays that the engine uses for a table of the given capacity, or zero, if the engine does not use the array */
+static INLINE void array_sizes(const hash_data_t *const data, uint64_t *const sizes)
+{
+	const size_t slots = slot_count(data);
+	const bool_t bitmap = (data->engine == HASHSET_ENGINE_DEFAULT) || (data->engine == HASHSET_ENGINE_BITMAP);
+
+	sizes[ARRAY_ITEMS] = entries_size(data->layout, slots);
+	sizes[ARRAY_USED] = (bitmap || (data->engine == HASHSET_ENGINE_CUCKOO)) ? div_ceil(slots, 8U) : 0U;
+	sizes[ARRAY_DELETED] = bitmap ? div_ceil(slots, 8U) : 0U;
+	sizes[ARRAY_CTRL] = (data->engine == HASHSET_ENGINE_SWISS) ? data->capacity : 0U;
+	sizes[ARRAY_DIST] = (data->engine == HASHSET_ENGINE_ROBINHOOD) ? data->capacity : 0U;
+}
+
+static INLINE uint8_t *array_addr(const hash_data_t *const data, const size_t array)
+{
+	switch (array)
+	{
+	case ARRAY_USED:
+		return data->used;
+	case ARRAY_DELETED:
+		return data->deleted;
+	case ARRAY_CTRL:
+		return data->ctrl;
+	case ARRAY_DIST:
+		return data->dist;
+	default:
+		return (uint8_t*) data->keys;
+	}
+}
+
+static INLINE void set_array(hash_data_t *const data, const size_t array, uint8_t *const addr)
+{
+	switch (array)
+	{
+	case ARRAY_USED:
+		data->used = addr;
+		break;
+	case ARRAY_DELETED:
+		data->deleted = addr;
+		break;
+	case ARRAY_CTRL:
+		data->ctrl = addr;
+		break;
+	case ARRAY_DIST:
+		data->dist = addr;
+		break;
+	default:
+		setup_entries(data, addr, slot_count(data));
+	}
+}
+
+static INLINE bool_t init_header(const hash_map_t *const instance, file_header_t *const header)
+{
+	memcpy(header->magic, FILE_MAGIC, sizeof(header->magic));
+	header->version = FILE_VERSION;
+	header->endian = FILE_ENDIAN;
+	header->value_size = sizeof(value_t);
+	header->engine = (uint32_t) instance->data.engine;
+	header->layout = (uint32_t) instance->data.layout;
+	header->escape = instance->data.escape;
+	header->hash_function = (uint32_t) instance->hash.function;
+	header->hash_probe = (uint32_t) instance->hash.probe;
+	header->hash_basis = instance->hash.basis;
+	header->hash_key = instance->hash.key;
+	header->capacity = instance->data.capacity;
+	header->valid = instance->valid;
+	header->deleted = instance->deleted;
+	header->load_factor = instance->load_factor;
+
+	array_sizes(&instance->data, header->size);
+	return layout_arrays(header);
+}
+
+/* checks that the arrays and the counters are consistent with the engine, the layout and the capacity */
+static INLINE bool_t check_table(const file_header_t *const header)
+{
+	hash_data_t data;
+	uint64_t sizes[ARRAY_COUNT];
+
+	zero_memory(&data, 1U, sizeof(hash_data_t));
+	data.engine = (hash_engine_t) header->engine;
+	data.layout = (hash_layout_t) header->layout;
+	data.capacity = (size_t) header->capacity;
+	array_sizes(&data, sizes);
+
+	return (header->escape <= 3U) && (!memcmp(sizes, header->size, sizeof(sizes))) && (header->valid <= slot_count(&data)) && (header->deleted <= slot_count(&data) - header->valid);
+}
+
+/* maps the table that follows the header, if requested; the table is read into newly allocated memory instead, if the file can not be mapped */
+static INLINE bool_t load_data(hash_data_t *const data, const int fd, const file_header_t *const header, const hash_load_t mode, const memory_t memory)
+{
+	uint8_t *arrays[ARRAY_COUNT];
+	uint64_t position;
+	uint8_t *base;
+	size_t array;
+
+	if ((mode == HASHSET_LOAD_MMAP) && ((position = file_position(fd)) != UINT64_MAX))
+	{
+		zero_memory(data, 1U, sizeof(hash_data_t));
+		data->block.memory = memory;
+		base = map_file(fd, position, (size_t)header->table_size, &data->block);
+		if (base && (!(((uintptr_t)base) % CACHE_LINE_SIZE)) && skip_file(fd, header->table_size))
+		{
+			data->engine = (hash_engine_t) header->engine;
+			data->layout = (hash_layout_t) header->layout;
+			data->capacity = (size_t) header->capacity;
+			for (array = 0U; array < ARRAY_COUNT; ++array)
+			{
+				if (header->size[array])
+				{
+					set_array(data, array, base + header->offset[array]);
+				}
+			}
+			return TRUE;
+		}
+		free_block(&data->block);
+	}
+
+	if (!alloc_data(data, (hash_engine_t) header->engine, (hash_layout_t) header->layout, memory, (size_t)header->capacity))
+	{
+		return FALSE;
+	}
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		arrays[array] = array_addr(data, array);
+	}
+
+	if (read_table(fd, header, arrays))
+	{
+		free_data(data);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* ------------------------------------------------- */
+/* Lock-free map                                     */
+/* ------------------------------------------------- */
+
+#include "generic_hash_map_lockfree.h"
+
+static INLINE errno_t update_lockfree(hash_map_lockfree_t *const instance, const value_t key, const update_t update, const value_t operand, value_t *const previous)
+{
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	if (IS_SENTINEL(key))
+	{
+		const bool_t inserted = atomic_acquire32(&instance->escape[ESCAPE_SLOT(key)]);
+		const value_t found = lockfree_apply(&instance->escape_value[ESCAPE_SLOT(key)], update, operand);
+		SAFE_SET(previous, found);
+		return inserted ? 0 : EEXIST;
+	}
+
+	return lockfree_update(instance, hash_compute(&instance->hash, key), key, update, operand, previous);
+}
+
+/* ========================================================================= */
+/* PUBLIC FUNCTIONS                                                          */
+/* ========================================================================= */
+
+hash_map_t *DECLARE(hash_map_create_ex)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_map_t *instance;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_map_t*) heap_calloc(allocator, 1U, sizeof(hash_map_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (!init_instance(instance, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY, load_factor, seed, options, memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator)))
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	if (options && (options->concurrency == HASHSET_CONCURRENCY_READERS) && (!init_shared(instance)))
+	{
+		free_data(&instance->data);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+hash_map_t *DECLARE(hash_map_init_in_buffer)(void *const buffer, const size_t size, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const size_t padding = buffer ? ((ARENA_ALIGN - (((uintptr_t)buffer) % ARENA_ALIGN)) % ARENA_ALIGN) : 0U;
+	hash_map_t *instance;
+	memory_t memory;
+	size_t capacity;
+
+	if ((!buffer) || (size < padding) || ((size - padding) < sizeof(hash_map_t)))
+	{
+		return NULL;
+	}
+
+	instance = (hash_map_t*) (((uint8_t*)buffer) + padding);
+	zero_memory(instance, 1U, sizeof(hash_map_t));
+	arena_init(&instance->arena, (uint8_t*)(instance + 1), ((uint8_t*)buffer) + size);
+	instance->allocator.alloc = arena_alloc;
+	instance->allocator.free = arena_free;
+	instance->allocator.context = &instance->arena;
+
+	memory = memory_config(options, HASHSET_MEMORY_HEAP, &instance->allocator);
+	memory.numa = HASHSET_NUMA_DEFAULT; /*the table is located in the buffer*/
+
+	/* the largest capacity whose table fits into the remaining space */
+	for (capacity = next_pow2((size - padding) / sizeof(value_t)); capacity >= MINIMUM_CAPACITY; capacity /= 2U)
+	{
+		if (init_instance(instance, capacity, load_factor, seed, options, memory))
+		{
+			instance->shrink = HASHSET_SHRINK_NEVER; /*memory given back to the arena can not be re-used*/
+			return instance;
+		}
+	}
+
+	zero_memory(instance, 1U, sizeof(hash_map_t));
+	return NULL;
+}
+
+hash_map_t *DECLARE(hash_map_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed)
+{
+	return DECLARE(hash_map_create_ex)(initial_capacity, load_factor, seed, NULL);
+}
+
+hash_map_t *DECLARE(hash_map_create_from_arrays)(const value_t *const keys, const value_t *const values, const size_t count, const double load_factor, const uint64_t seed, const hash_options_t *const options, const hash_duplicates_t duplicates)
+{
+	const double effective_load = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	const size_t threads = parallel_threads(thread_count(options ? options->thread_count : 0U), count);
+	build_ref_t *order = NULL;
+	size_t *counts = NULL;
+	hash_map_t *instance;
+	errno_t error;
+
+	if (((!keys) || (!values)) && count)
+	{
+		return NULL;
+	}
+
+	instance = DECLARE(hash_map_create_ex)(round_sz(safe_incr(count) / effective_load), load_factor, seed, options);
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (threads > 1U)
+	{
+		order = (build_ref_t*) heap_alloc(&instance->allocator, safe_mult((count < PARALLEL_CHUNK) ? count : PARALLEL_CHUNK, 2U * sizeof(build_ref_t)));
+		counts = (size_t*) heap_calloc(&instance->allocator, threads * threads, sizeof(size_t));
+	}
+
+	if (order && counts)
+	{
+		error = build_map(instance, keys, values, count, threads, duplicates, order, counts);
+	}
+	else
+	{
+		error = DECLARE(hash_map_insert_batch)(instance, keys, values, count, (duplicates == HASHSET_DUPLICATES_UPDATE), NULL);
+		if ((error == EEXIST) && (duplicates != HASHSET_DUPLICATES_FAIL))
+		{
+			error = 0;
+		}
+	}
+
+	HEAP_FREE(&instance->allocator, counts);
+	HEAP_FREE(&instance->allocator, order);
+
+	if (error)
+	{
+		DECLARE(hash_map_destroy)(instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_map_destroy)(hash_map_t *instance)
+{
+	if (instance)
+	{
+		const hash_allocator_t allocator = instance->allocator;
+		const bool_t is_in_buffer = in_buffer(instance);
+		free_shared(instance); /*the current table is released below*/
+		free_data(&instance->data);
+		free_data(&instance->old);
+		zero_memory(instance, 1U, sizeof(hash_map_t));
+		if (!is_in_buffer)
+		{
+			heap_free(&allocator, instance);
+		}
+	}
+}
+
+errno_t DECLARE(hash_map_insert)(hash_map_t *const instance, const value_t key, const value_t value, const bool_t update)
+{
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	return insert_entry(instance, hash_compute(&instance->hash, key), key, value, update);
+}
+
+errno_t DECLARE(hash_map_insert_batch)(hash_map_t *const instance, const value_t *const keys, const value_t *const values, const size_t count, const bool_t update, uint8_t *const inserted)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k;
+	errno_t error, result = 0;
+
+	if ((!instance) || (!instance->data.keys) || (((!keys) || (!values)) && count))
+	{
+		return EINVAL;
+	}
+
+	if (!instance->incremental) /*with incremental resizing, a single large rebuild is exactly what we want to avoid*/
+	{
+		error = reserve_map(instance, missing_keys(instance, keys, count));
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, keys[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, keys[k + PREFETCH_DISTANCE]));
+		}
+		error = insert_entry(instance, hash, keys[k], values[k], update);
+		switch (error)
+		{
+		case 0:
+			if (inserted)
+			{
+				set_flag(inserted, k);
+			}
+			break;
+		case EEXIST:
+			if (inserted)
+			{
+				clear_flag(inserted, k);
+			}
+			result = EEXIST;
+			break;
+		default:
+			return error;
+		}
+	}
+
+	return result;
+}
+
+errno_t DECLARE(hash_map_upsert)(hash_map_t *const instance, const value_t key, const value_t value, const hash_accumulate_t accumulate)
+{
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	return accumulate_entry(instance, hash_compute(&instance->hash, key), key, value, accumulate);
+}
+
+errno_t DECLARE(hash_map_upsert_callback)(hash_map_t *const instance, const value_t key, const value_t value, const hash_map_accumulator_t callback, void *const context)
+{
+	value_t *slot;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys) || (!callback))
+	{
+		return EINVAL;
+	}
+
+	if ((error = upsert_entry(instance, hash_compute(&instance->hash, key), key, value, &slot)) == EEXIST)
+	{
+		*slot = callback(key, *slot, value, context);
+	}
+
+	return error;
+}
+
+errno_t DECLARE(hash_map_get_or_insert)(hash_map_t *const instance, const value_t key, const value_t value, value_t **const slot)
+{
+	if ((!instance) || (!instance->data.keys) || (!slot))
+	{
+		return EINVAL;
+	}
+
+	return upsert_entry(instance, hash_compute(&instance->hash, key), key, value, slot);
+}
+
+errno_t DECLARE(hash_map_exchange)(hash_map_t *const instance, const value_t key, const value_t value, value_t *const previous)
+{
+	value_t *slot;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	if ((error = upsert_entry(instance, hash_compute(&instance->hash, key), key, value, &slot)) == EEXIST)
+	{
+		SAFE_SET(previous, *slot);
+		*slot = value;
+	}
+
+	return error;
+}
+
+errno_t DECLARE(hash_map_reserve)(hash_map_t *const instance, const size_t count)
+{
+	size_t additional;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	additional = (count > instance->valid) ? (count - instance->valid) : 0U;
+
+	error = reserve_map(instance, additional);
+	if (error)
+	{
+		return error;
+	}
+
+	return (safe_add(safe_add(instance->valid, instance->deleted), additional) > instance->limit) ? ENOMEM : 0;
+}
+
+errno_t DECLARE(hash_map_shrink_to_fit)(hash_map_t *const instance)
+{
+	size_t min_capacity;
+
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
+	if ((instance->data.capacity <= min_capacity) && (!instance->deleted) && (!instance->pending))
+	{
+		return 0;
+	}
+
+	return rebuild_map(instance, (instance->data.capacity < min_capacity) ? instance->data.capacity : min_capacity);
+}
+
+errno_t DECLARE(hash_map_contains)(const hash_map_t *const instance, const value_t key)
+{
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	return (instance->valid && find_entry(instance, hash_compute(&instance->hash, key), key)) ? 0 : ENOENT;
+}
+
+errno_t DECLARE(hash_map_get)(const hash_map_t *const instance, const value_t key, value_t *const value)
+{
+	const value_t *entry;
+
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	entry = find_entry(instance, hash_compute(&instance->hash, key), key);
+	if (!entry)
+	{
+		return ENOENT;
+	}
+
+	*value = *entry;
+	return 0;
+}
+
+errno_t DECLARE(hash_map_get_batch)(const hash_map_t *const instance, const value_t *const keys, const size_t count, value_t *const values, uint8_t *const found)
+{
+	if ((!instance) || (!instance->data.keys) || (((!keys) || (!values)) && count))
+	{
+		return EINVAL;
+	}
+
+	if (!instance->valid)
+	{
+		if (found)
+		{
+			zero_memory(found, div_ceil(count, 8U), sizeof(uint8_t));
+		}
+		return count ? ENOENT : 0;
+	}
+
+	return (get_batch(instance, keys, count, values, found) == count) ? 0 : ENOENT;
+}
+
+void DECLARE(hash_map_prefetch)(const hash_map_t *const instance, const value_t key)
+{
+	if (instance && instance->data.keys)
+	{
+		prefetch_slot(&instance->data, hash_compute(&instance->hash, key));
+	}
+}
+
+errno_t DECLARE(hash_map_remove)(hash_map_t *const instance, const value_t key, value_t *const value)
+{
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	error = remove_entry(instance, hash_compute(&instance->hash, key), key, value);
+	if (error)
+	{
+		return error;
+	}
+
+	return compact_map(instance);
+}
+
+errno_t DECLARE(hash_map_remove_batch)(hash_map_t *const instance, const value_t *const keys, const size_t count, value_t *const values, uint8_t *const removed)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k, total = 0U;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys) || ((!keys) && count))
+	{
+		return EINVAL;
+	}
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, keys[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, keys[k + PREFETCH_DISTANCE]));
+		}
+		if (!remove_entry(instance, hash, keys[k], values ? &values[k] : NULL))
+		{
+			if (removed)
+			{
+				set_flag(removed, k);
+			}
+			++total;
+		}
+		else if (removed)
+		{
+			clear_flag(removed, k);
+		}
+	}
+
+	if (total)
+	{
+		error = compact_map(instance);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	return (total == count) ? 0 : ENOENT;
+}
+
+errno_t DECLARE(hash_map_clear)(hash_map_t *const instance)
+{
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	if (!(instance->valid || instance->deleted))
+	{
+		return EAGAIN;
+	}
+
+	return clear_map(instance);
+}
+
+errno_t DECLARE(hash_map_iterate)(const hash_map_t *const instance, size_t *const cursor, value_t *const key, value_t *const value)
+{
+	size_t index;
+
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	if (((index = *cursor) < slot_count(&instance->data)) && ((index = next_valid(&instance->data, index, slot_count(&instance->data))) < slot_count(&instance->data)))
+	{
+		SAFE_SET(key, KEY(&instance->data, index));
+		SAFE_SET(value, VALUE(&instance->data, index));
+		*cursor = index + 1U;
+		return 0;
+	}
+
+	if (instance->pending && ((index = next_valid(&instance->old, index - slot_count(&instance->data), slot_count(&instance->old))) < slot_count(&instance->old)))
+	{
+		SAFE_SET(key, KEY(&instance->old, index));
+		SAFE_SET(value, VALUE(&instance->old, index));
+		*cursor = slot_count(&instance->data) + index + 1U;
+		return 0;
+	}
+
+	*cursor = SIZE_MAX;
+	return ENOENT;
+}
+
+errno_t DECLARE(hash_map_export)(const hash_map_t *const instance, size_t *const cursor, value_t *const keys, value_t *const values, const size_t capacity, size_t *const count)
+{
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.keys) || ((!keys) && (!values)) || (!capacity) || (!count))
+	{
+		return EINVAL;
+	}
+
+	return export_range(instance, cursor, SIZE_MAX, keys, values, capacity, count);
+}
+
+errno_t DECLARE(hash_map_split)(const hash_map_t *const instance, const size_t parts, size_t *const bounds)
+{
+	size_t k, limit;
+
+	if ((!instance) || (!instance->data.keys) || (!parts) || (parts >= SIZE_MAX) || (!bounds))
+	{
+		return EINVAL;
+	}
+
+	for (k = 0U, limit = cursor_limit(instance); k < parts; ++k)
+	{
+		bounds[k] = range_begin(limit, k, parts);
+	}
+
+	bounds[parts] = limit;
+	return 0;
+}
+
+errno_t DECLARE(hash_map_export_range)(const hash_map_t *const instance, size_t *const cursor, const size_t end, value_t *const keys, value_t *const values, const size_t capacity, size_t *const count)
+{
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.keys) || ((!keys) && (!values)) || (!capacity) || (!count))
+	{
+		return EINVAL;
+	}
+
+	return export_range(instance, cursor, end, keys, values, capacity, count);
+}
+
+errno_t DECLARE(hash_map_parallel_for)(const hash_map_t *const instance, const size_t threads, const hash_map_worker_t callback, void *const context)
+{
+	scan_task_t tasks[MAX_THREADS];
+	volatile size_t cancelled = 0U;
+	size_t k, limit, count;
+
+	if ((!instance) || (!instance->data.keys) || (!callback))
+	{
+		return EINVAL;
+	}
+
+	limit = cursor_limit(instance);
+	count = parallel_threads(thread_count(threads), limit);
+
+	for (k = 0U; k < count; ++k)
+	{
+		tasks[k].instance = instance;
+		tasks[k].callback = callback;
+		tasks[k].context = context;
+		tasks[k].cancelled = &cancelled;
+		tasks[k].part = k;
+		tasks[k].begin = range_begin(limit, k, count);
+		tasks[k].end = (k + 1U < count) ? range_begin(limit, k + 1U, count) : limit;
+	}
+
+	run_tasks(scan_task, tasks, sizeof(scan_task_t), count);
+	return cancelled ? ECANCELED : 0;
 }
 
 size_t DECLARE(hash_map_size)(const hash_map_t *const instance)
 {
-	return instance ? instance->valid : 0U;
+	return instance ? instance->valid : 0U;
+}
+
+errno_t DECLARE(hash_map_info)(const hash_map_t *const instance, size_t *const capacity, size_t *const valid, size_t *const deleted, size_t *const limit)
+{
+	if ((!instance) || (!instance->data.keys))
+	{
+		return EINVAL;
+	}
+
+	SAFE_SET(capacity, instance->data.capacity);
+	SAFE_SET(valid, instance->valid);
+	SAFE_SET(deleted,instance->deleted);
+	SAFE_SET(limit, instance->limit);
+
+	return 0;
+}
+
+HASHSET_API errno_t DECLARE(hash_map_dump)(const hash_map_t *const instance, const hash_map_callback_t callback)
+{
+	size_t index;
+
+	if ((!instance) || (!instance->data.keys) || (!callback))
+	{
+		return EINVAL;
+	}
+
+	for (index = 0U; index < slot_count(&instance->data); ++index)
+	{
+		if (!callback(index, get_status(&instance->data, index), KEY(&instance->data, index), VALUE(&instance->data, index)))
+		{
+			return ECANCELED;
+		}
+	}
+
+	for (; instance->pending && (index - slot_count(&instance->data) < slot_count(&instance->old)); ++index)
+	{
+		if (!callback(index, get_status(&instance->old, index - slot_count(&instance->data)), KEY(&instance->old, index - slot_count(&instance->data)), VALUE(&instance->old, index - slot_count(&instance->data))))
+		{
+			return ECANCELED;
+		}
+	}
+
+	return 0;
+}
+
+errno_t DECLARE(hash_map_save)(hash_map_t *const instance, const int fd)
+{
+	uint8_t *arrays[ARRAY_COUNT];
+	file_page_t page;
+	size_t array;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.keys) || (fd < 0))
+	{
+		return EINVAL;
+	}
+
+	/* a pending incremental resize is completed first, so that the file only contains a single table */
+	if (instance->pending && ((error = migrate_map(instance, SIZE_MAX)) != 0))
+	{
+		return error;
+	}
+
+	zero_memory(&page, 1U, sizeof(file_page_t));
+	if (!init_header(instance, &page.header))
+	{
+		return EFBIG;
+	}
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		arrays[array] = array_addr(&instance->data, array);
+	}
+
+	return write_table(fd, &page, arrays);
+}
+
+hash_map_t *DECLARE(hash_map_load)(const int fd, const hash_load_t mode, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_map_t *instance;
+	file_page_t page;
+
+	if ((fd < 0) || (!allocator_valid(allocator)))
+	{
+		return NULL;
+	}
+
+	if (read_file(fd, &page, sizeof(file_page_t)) || (!check_header(&page.header, FILE_MAGIC, sizeof(value_t))) || (!check_table(&page.header)))
+	{
+		return NULL;
+	}
+
+	instance = (hash_map_t*) heap_calloc(allocator, 1U, sizeof(hash_map_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (!load_data(&instance->data, fd, &page.header, mode, memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator)))
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	instance->data.escape = (uint8_t) page.header.escape;
+	instance->hash.function = (hash_function_t) page.header.hash_function;
+	instance->hash.probe = (hash_probe_t) page.header.hash_probe;
+	instance->hash.basis = page.header.hash_basis;
+	instance->hash.key = page.header.hash_key;
+	instance->valid = (size_t) page.header.valid;
+	instance->deleted = (size_t) page.header.deleted;
+	apply_options(instance, page.header.load_factor, options);
+
+	if (options && (options->concurrency == HASHSET_CONCURRENCY_READERS) && (!init_shared(instance)))
+	{
+		free_data(&instance->data);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
 }
 
-errno_t DECLARE(hash_map_info)(const hash_map_t *const instance, size_t *const capacity, size_t *const valid, size_t *const deleted, size_t *const limit)
+hash_map_reader_t *DECLARE(hash_map_reader_attach)(hash_map_t *const instance)
+{
+	if ((!instance) || (!instance->shared))
+	{
+		return NULL;
+	}
+
+	return (hash_map_reader_t*) epoch_attach(&instance->shared->epoch, instance->shared);
+}
+
+void DECLARE(hash_map_reader_detach)(hash_map_reader_t *const reader)
+{
+	if (reader)
+	{
+		epoch_detach((reader_slot_t*)reader);
+	}
+}
+
+errno_t DECLARE(hash_map_reader_contains)(hash_map_reader_t *const reader, const value_t key)
+{
+	return DECLARE(hash_map_reader_get)(reader, key, NULL);
+}
+
+errno_t DECLARE(hash_map_reader_get)(hash_map_reader_t *const reader, const value_t key, value_t *const value)
 {
-	if ((!instance) || (!instance->data.entries))
+	reader_slot_t *const slot = (reader_slot_t*) reader;
+	const shared_t *shared;
+	const snapshot_t *snapshot;
+	size_t index = SIZE_MAX;
+	bool_t found;
+
+	if (!reader)
 	{
 		return EINVAL;
 	}
 
-	SAFE_SET(capacity, instance->data.capacity);
-	SAFE_SET(valid, instance->valid);
-	SAFE_SET(deleted,instance->deleted);
-	SAFE_SET(limit, instance->limit);
+	shared = (const shared_t*) slot->state.owner;
+	epoch_enter((epoch_t*)&shared->epoch, slot);
+	snapshot = (const snapshot_t*) atomic_load_ptr((void *const volatile*)&shared->current);
+	found = find_shared(&snapshot->data, &shared->hash, hash_compute(&shared->hash, key), key, &index);
+	if (found)
+	{
+		SAFE_SET(value, VALUE(&snapshot->data, index));
+	}
 
-	return 0;
+	epoch_exit(slot);
+	return found ? 0 : ENOENT;
 }
 
-HASHSET_API errno_t DECLARE(hash_map_dump)(const hash_map_t *const instance, const hash_map_callback_t callback)
+hash_map_concurrent_t *DECLARE(hash_map_concurrent_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
 {
-	size_t index;
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_map_concurrent_t *instance;
+	hash_options_t shard_options;
+	size_t capacity, i;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_map_concurrent_t*) heap_calloc(allocator, 1U, sizeof(hash_map_concurrent_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (options)
+	{
+		shard_options = *options;
+	}
+	else
+	{
+		zero_memory(&shard_options, 1U, sizeof(hash_options_t));
+	}
+
+	shard_options.concurrency = HASHSET_CONCURRENCY_NONE; /*each shard is protected by its own lock*/
+	shard_options.thread_count = shard_options.thread_count ? shard_options.thread_count : 1U; /*the calling threads already run in parallel*/
+
+	instance->shard_count = shard_count(shard_options.shard_count);
+	hash_initialize(&instance->hash, shard_options.hash_function, shard_options.probe_strategy, seed);
+	capacity = div_ceil((initial_capacity > 0U) ? initial_capacity : DEFAULT_CAPACITY, instance->shard_count);
+
+	instance->block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->shards = (shard_t*) alloc_block(safe_mult(instance->shard_count, sizeof(shard_t)), &instance->block);
+	if (!instance->shards)
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	for (i = 0U; i < instance->shard_count; ++i)
+	{
+		if (!lock_init(&instance->shards[i].state.lock))
+		{
+			free_shards(instance, i);
+			return NULL;
+		}
+		if (!(instance->shards[i].state.instance = DECLARE(hash_map_create_ex)(capacity, load_factor, seed, &shard_options)))
+		{
+			lock_destroy(&instance->shards[i].state.lock);
+			free_shards(instance, i);
+			return NULL;
+		}
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_map_concurrent_destroy)(hash_map_concurrent_t *const instance)
+{
+	if (instance)
+	{
+		free_shards(instance, instance->shard_count);
+	}
+}
+
+errno_t DECLARE(hash_map_concurrent_insert)(hash_map_concurrent_t *const instance, const value_t key, const value_t value, const bool_t update)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	errno_t error;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, key);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	error = insert_entry(shard->instance, hash, key, value, update);
+	lock_release(&shard->lock);
+
+	return error;
+}
+
+errno_t DECLARE(hash_map_concurrent_remove)(hash_map_concurrent_t *const instance, const value_t key, value_t *const value)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	errno_t error;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, key);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	error = remove_entry(shard->instance, hash, key, value);
+	if (!error)
+	{
+		error = compact_map(shard->instance);
+	}
+	lock_release(&shard->lock);
+
+	return error;
+}
+
+errno_t DECLARE(hash_map_concurrent_contains)(hash_map_concurrent_t *const instance, const value_t key)
+{
+	return DECLARE(hash_map_concurrent_get)(instance, key, NULL);
+}
+
+errno_t DECLARE(hash_map_concurrent_get)(hash_map_concurrent_t *const instance, const value_t key, value_t *const value)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	const value_t *entry;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, key);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	entry = shard->instance->valid ? find_entry(shard->instance, hash, key) : NULL;
+	if (entry)
+	{
+		SAFE_SET(value, *entry); /*the value must be copied while the shard is still locked*/
+	}
+	lock_release(&shard->lock);
+
+	return entry ? 0 : ENOENT;
+}
 
-	if ((!instance) || (!instance->data.entries) || (!callback))
+/* the shards are cleared one after another, so entries that are inserted concurrently may or may not survive */
+errno_t DECLARE(hash_map_concurrent_clear)(hash_map_concurrent_t *const instance)
+{
+	size_t i;
+	errno_t error = EAGAIN;
+
+	if (!instance)
 	{
 		return EINVAL;
 	}
 
-	for (index = 0U; index < instance->data.capacity; ++index)
+	for (i = 0U; i < instance->shard_count; ++i)
 	{
-		const entry_t* const entntry = &instance->data.entries[index];
-		if (!callback(index, get_flag(instance->data.used, index) ? (get_flag(instance->data.deleted, index) ? 'd' : 'v') : 'u', entntry->key, entntry->value))
+		shard_state_t *const shard = &instance->shards[i].state;
+		lock_acquire(&shard->lock);
+		if (shard->instance->valid || shard->instance->deleted)
 		{
-			return ECANCELED;
+			const errno_t result = clear_map(shard->instance);
+			if (error != ENOMEM)
+			{
+				error = result;
+			}
+		}
+		lock_release(&shard->lock);
+	}
+
+	return error;
+}
+
+size_t DECLARE(hash_map_concurrent_size)(hash_map_concurrent_t *const instance)
+{
+	size_t i, total = 0U;
+
+	if (!instance)
+	{
+		return 0U;
+	}
+
+	for (i = 0U; i < instance->shard_count; ++i)
+	{
+		shard_state_t *const shard = &instance->shards[i].state;
+		lock_acquire(&shard->lock);
+		total += shard->instance->valid;
+		lock_release(&shard->lock);
+	}
+
+	return total;
+}
+
+hash_map_lockfree_t *DECLARE(hash_map_lockfree_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_map_lockfree_t *instance;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_map_lockfree_t*) heap_calloc(allocator, 1U, sizeof(hash_map_lockfree_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	instance->growth = growth_multiplier(options ? options->growth_factor : 0.0);
+	instance->memory = memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator);
+	hash_initialize(&instance->hash, options ? options->hash_function : HASHSET_HASH_DEFAULT, options ? options->probe_strategy : HASHSET_PROBE_DEFAULT, seed);
+
+	instance->size_block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->size = (counter_t*) alloc_block(MAX_STRIPES * sizeof(counter_t), &instance->size_block);
+	if (!instance->size)
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	instance->current = lockfree_alloc_table(instance, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY);
+	if (!instance->current)
+	{
+		free_block(&instance->size_block);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_map_lockfree_destroy)(hash_map_lockfree_t *const instance)
+{
+	if (instance)
+	{
+		const hash_allocator_t allocator = instance->allocator;
+		lockfree_table_t *table = instance->current, *next = table->next;
+		while (next)
+		{
+			lockfree_table_t *const following = next->next;
+			lockfree_free_table(next); /*a resize that has not been completed*/
+			next = following;
+		}
+		while (table)
+		{
+			lockfree_table_t *const previous = table->previous;
+			lockfree_free_table(table);
+			table = previous;
+		}
+		free_block(&instance->size_block);
+		zero_memory(instance, 1U, sizeof(hash_map_lockfree_t));
+		heap_free(&allocator, instance);
+	}
+}
+
+errno_t DECLARE(hash_map_lockfree_fetch_add)(hash_map_lockfree_t *const instance, const value_t key, const value_t value, value_t *const previous)
+{
+	return update_lockfree(instance, key, UPDATE_ADD, value, previous);
+}
+
+errno_t DECLARE(hash_map_lockfree_fetch_max)(hash_map_lockfree_t *const instance, const value_t key, const value_t value, value_t *const previous)
+{
+	return update_lockfree(instance, key, UPDATE_MAX, value, previous);
+}
+
+errno_t DECLARE(hash_map_lockfree_fetch_or)(hash_map_lockfree_t *const instance, const value_t key, const value_t value, value_t *const previous)
+{
+	return update_lockfree(instance, key, UPDATE_OR, value, previous);
+}
+
+errno_t DECLARE(hash_map_lockfree_get)(const hash_map_lockfree_t *const instance, const value_t key, value_t *const value)
+{
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	if (IS_SENTINEL(key))
+	{
+		if (!atomic_load_word(&instance->escape[ESCAPE_SLOT(key)], sizeof(uint32_t)))
+		{
+			return ENOENT;
+		}
+		SAFE_SET(value, LOAD_WORD(instance->escape_value[ESCAPE_SLOT(key)]));
+		return 0;
+	}
+
+	return lockfree_get(instance, hash_compute(&instance->hash, key), key, value);
+}
+
+size_t DECLARE(hash_map_lockfree_size)(const hash_map_lockfree_t *const instance)
+{
+	size_t i, total;
+
+	if (!instance)
+	{
+		return 0U;
+	}
+
+	total = (size_t)atomic_load_word(&instance->escape[0U], sizeof(uint32_t)) + (size_t)atomic_load_word(&instance->escape[1U], sizeof(uint32_t));
+
+	for (i = 0U; i < MAX_STRIPES; ++i)
+	{
+		total += atomic_load_size(&instance->size[i].value);
+	}
+
+	return total;
+}
+
+errno_t DECLARE(hash_map_lockfree_snapshot)(const hash_map_lockfree_t *const instance, hash_map_t *const target)
+{
+	const lockfree_table_t *table;
+	errno_t error;
+	size_t slot;
+
+	if ((!instance) || (!target) || (!target->data.keys))
+	{
+		return EINVAL;
+	}
+
+	if (target->valid || target->deleted)
+	{
+		if ((error = clear_map(target)) != 0)
+		{
+			return error;
+		}
+	}
+
+	for (slot = 0U; slot < 2U; ++slot)
+	{
+		if (atomic_load_word(&instance->escape[slot], sizeof(uint32_t)))
+		{
+			const value_t key = slot ? SENTINEL_DELETED : SENTINEL_EMPTY;
+			if ((error = insert_entry(target, hash_compute(&target->hash, key), key, LOAD_WORD(instance->escape_value[slot]), TRUE)) && (error != EEXIST))
+			{
+				return error;
+			}
+		}
+	}
+
+	/* a migration that is in progress, or that starts meanwhile, makes the copy go on in the next table */
+	for (table = (const lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current); table; table = (const lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next))
+	{
+		if ((error = lockfree_copy(table, target)) != 0)
+		{
+			return error;
 		}
 	}
 
@@ -0,0 +1,451 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_MAP_LOCKFREE_INCLUDED
+#define _LIBHASHSET_GENERIC_MAP_LOCKFREE_INCLUDED
+
+/*
+ * Lock-free map: Keys are never removed, so a key slot only ever changes from
+ * "empty" to holding a key, which is done by a single compare-and-swap on the
+ * key. The values are updated in place, by a single atomic operation on the
+ * value slot; new keys start out with a value of zero, which is the identity
+ * of every supported update. The two sentinel keys are stored "out-of-band".
+ *
+ * When the table needs to grow, the entries are moved to the new table, one
+ * chunk of slots at a time, by all threads that update the map. Each entry
+ * has two state bits: it is "sealed" by the one thread that moves it, before
+ * the value is taken out of the old slot, and it has "landed" as soon as the
+ * value has been added to the new table. The key stays in the old slot, so
+ * that every thread still finds the entry there. A thread that finds the
+ * table being migrated does not wait for the other helpers; it moves the
+ * entry of its own key, unless another thread does so already, and goes on
+ * in the new table. Only an entry that is being moved at this very moment
+ * is waited for, until it has landed. Empty slots are sealed with the "moved"
+ * sentinel, so that no key can be inserted into the old table anymore.
+ */
+
+#define LOCKFREE_MOVED SENTINEL_DELETED /*never stored otherwise, because nothing is ever removed*/
+#define MIGRATE_CHUNK 1024U
+
+#define ENTRY_KEY(T,I) ((T)->entries[(I) << 1])
+#define ENTRY_VALUE(T,I) ((T)->entries[((I) << 1) | 1U])
+
+#define STATE_SEALED 1U
+#define STATE_LANDED 2U
+#define STATE_WORD(T,I) ((T)->states[(I) >> 5])
+#define STATE_SHIFT(I) (((I) & 31U) << 1)
+
+#define LOAD_WORD(X) ((value_t)atomic_load_word(&(X), sizeof(value_t)))
+#define SWAP_WORD(X,Y,Z) ((value_t)atomic_cas_word(&(X), sizeof(value_t), (Y), (Z)))
+
+typedef enum
+{
+	UPDATE_ADD,
+	UPDATE_MAX,
+	UPDATE_OR
+}
+update_t;
+
+static INLINE lockfree_table_t *lockfree_alloc_table(const hash_map_lockfree_t *const instance, const size_t capacity)
+{
+	const size_t header_size = align_size(sizeof(lockfree_table_t)), state_size = safe_mult(div_ceil(capacity, 32U), sizeof(uint64_t));
+	lockfree_table_t *table;
+	block_t block;
+	uint8_t *addr;
+
+	block.addr = NULL;
+	block.mapped = 0U;
+	block.memory = instance->memory;
+
+	addr = alloc_block(safe_add(safe_add(header_size, state_size), safe_mult(safe_times2(capacity), sizeof(value_t))), &block);
+	if (!addr)
+	{
+		return NULL;
+	}
+
+	table = (lockfree_table_t*) addr;
+	table->states = (volatile uint64_t*) (addr + header_size);
+	table->entries = (volatile value_t*) (addr + header_size + state_size);
+	table->capacity = capacity;
+	table->limit = compute_limit(capacity, instance->load_factor);
+	table->stripes = stripe_count(capacity);
+	table->chunks = div_ceil(capacity, MIGRATE_CHUNK);
+	table->block = block;
+
+	return table;
+}
+
+static INLINE void lockfree_free_table(lockfree_table_t *const table)
+{
+	block_t block = table->block; /*the block contains the table itself*/
+	free_block(&block);
+}
+
+static FORCE_INLINE uint32_t entry_state(const lockfree_table_t *const table, const size_t index)
+{
+	return ((uint32_t)(atomic_load_word(&STATE_WORD(table, index), sizeof(uint64_t)) >> STATE_SHIFT(index))) & (STATE_SEALED | STATE_LANDED);
+}
+
+/* returns TRUE, if the calling thread has sealed the entry, which makes it responsible for moving the entry */
+static FORCE_INLINE bool_t entry_seal(lockfree_table_t *const table, const size_t index)
+{
+	return !((atomic_or_word(&STATE_WORD(table, index), sizeof(uint64_t), ((uint64_t)STATE_SEALED) << STATE_SHIFT(index)) >> STATE_SHIFT(index)) & STATE_SEALED);
+}
+
+static FORCE_INLINE void entry_land(lockfree_table_t *const table, const size_t index)
+{
+	atomic_or_word(&STATE_WORD(table, index), sizeof(uint64_t), ((uint64_t)STATE_LANDED) << STATE_SHIFT(index));
+}
+
+/* an entry that is being moved by another thread at this very moment can only be accessed in the next table once it has landed there */
+static INLINE void entry_await(const lockfree_table_t *const table, const size_t index)
+{
+	while (!(entry_state(table, index) & STATE_LANDED))
+	{
+		thread_yield();
+	}
+}
+
+/* returns the value that was found, before the update was applied */
+static FORCE_INLINE value_t lockfree_apply(volatile value_t *const slot, const update_t update, const value_t operand)
+{
+	value_t current, found;
+
+	switch (update)
+	{
+	case UPDATE_ADD:
+		return (value_t) atomic_add_word(slot, sizeof(value_t), operand);
+	case UPDATE_OR:
+		return (value_t) atomic_or_word(slot, sizeof(value_t), operand);
+	default:
+		for (current = LOAD_WORD(*slot); current < operand; current = found)
+		{
+			if ((found = SWAP_WORD(*slot, current, operand)) == current)
+			{
+				break;
+			}
+		}
+		return current;
+	}
+}
+
+/* combines the value that was found in the next table with the value that was found in the old slot, before the remainder was forwarded */
+static FORCE_INLINE value_t lockfree_combine(const update_t update, const value_t value, const value_t base)
+{
+	switch (update)
+	{
+	case UPDATE_ADD:
+		return (value_t)(value + base);
+	case UPDATE_OR:
+		return value | base;
+	default:
+		return (value > base) ? value : base;
+	}
+}
+
+/* returns 0, if an empty slot has been claimed for the key, EEXIST, if the key was found, ENOENT, if an empty slot was found, but "fill" is the empty sentinel, or EAGAIN, if the key can only be in the next table, because the probe sequence has been sealed or the table is full; if "fill" is the "moved" sentinel, then an empty slot is sealed */
+static INLINE errno_t lockfree_locate(lockfree_table_t *const table, const hash_param_t *const param, const uint64_t hash, const value_t key, const value_t fill, size_t *const index_out)
+{
+	probe_t probe;
+	size_t count;
+
+	for (probe_init(&probe, param, hash, table->capacity), count = 0U; count < table->capacity; probe_next(&probe, table->capacity), ++count)
+	{
+		value_t current = LOAD_WORD(ENTRY_KEY(table, probe.index));
+		if (current == SENTINEL_EMPTY)
+		{
+			if (fill == SENTINEL_EMPTY)
+			{
+				return ENOENT;
+			}
+			if ((current = SWAP_WORD(ENTRY_KEY(table, probe.index), SENTINEL_EMPTY, fill)) == SENTINEL_EMPTY)
+			{
+				*index_out = probe.index;
+				return (fill == key) ? 0 : EAGAIN;
+			}
+		}
+		if (current == key)
+		{
+			*index_out = probe.index;
+			return EEXIST;
+		}
+		if (current == LOCKFREE_MOVED)
+		{
+			return EAGAIN;
+		}
+	}
+
+	return EAGAIN;
+}
+
+/* publishes a larger table, unless another thread has done so already; the old table is kept until the instance is destroyed, because other threads may still be looking at it */
+static INLINE errno_t lockfree_grow(hash_map_lockfree_t *const instance, lockfree_table_t *const table)
+{
+	lockfree_table_t *next;
+
+	if (atomic_load_ptr((void *const volatile*)&table->next))
+	{
+		return 0;
+	}
+
+	if (table->capacity > (SIZE_MAX / (2U * sizeof(value_t))) / instance->growth)
+	{
+		return EFBIG;
+	}
+
+	next = lockfree_alloc_table(instance, table->capacity * instance->growth);
+	if (!next)
+	{
+		return ENOMEM;
+	}
+
+	next->previous = table;
+	if (!atomic_cas_ptr((void *volatile*)&table->next, NULL, next))
+	{
+		lockfree_free_table(next);
+	}
+
+	return 0;
+}
+
+/* adds the value of a moved entry to the given table, or to a later one, if that table is being migrated itself; no other thread updates the key meanwhile, because they all wait for the entry to land */
+static INLINE void lockfree_deposit(hash_map_lockfree_t *const instance, lockfree_table_t *table, const uint64_t hash, const value_t key, value_t value)
+{
+	lockfree_table_t *next;
+	size_t index = 0U;
+	errno_t error;
+
+	for (;;)
+	{
+		if ((error = lockfree_locate(table, &instance->hash, hash, key, key, &index)) == EAGAIN)
+		{
+			if ((next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next)) != NULL)
+			{
+				table = next;
+			}
+			else if (lockfree_grow(instance, table) != 0)
+			{
+				thread_yield(); /*the value has been taken out of the old slot already, so this is retried until memory is available*/
+			}
+			continue;
+		}
+
+		if (!error)
+		{
+			atomic_add_size(&table->used[shard_index(hash, table->stripes)].value, 1U);
+		}
+
+		/* if the entry has been sealed meanwhile, then its mover may or may not have taken the value */
+		atomic_add_word(&ENTRY_VALUE(table, index), sizeof(value_t), value);
+		if ((!entry_state(table, index)) || (!(value = (value_t) atomic_swap_word(&ENTRY_VALUE(table, index), sizeof(value_t), 0U))))
+		{
+			return;
+		}
+
+		entry_await(table, index);
+		table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+	}
+}
+
+/* takes the value out of an entry that the calling thread has sealed, and adds it to the next table */
+static INLINE void lockfree_move(hash_map_lockfree_t *const instance, lockfree_table_t *const table, const size_t index, const value_t key, lockfree_table_t *const next)
+{
+	lockfree_deposit(instance, next, hash_compute(&instance->hash, key), key, (value_t) atomic_swap_word(&ENTRY_VALUE(table, index), sizeof(value_t), 0U));
+	entry_land(table, index);
+}
+
+/* makes the first table whose migration has not been completed yet the current table */
+static INLINE void lockfree_advance(hash_map_lockfree_t *const instance)
+{
+	for (;;)
+	{
+		lockfree_table_t *const table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current);
+		lockfree_table_t *const next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+		if ((!next) || (atomic_load_size(&table->migrated) < table->chunks))
+		{
+			return;
+		}
+		atomic_cas_ptr((void *volatile*)&instance->current, table, next);
+	}
+}
+
+/* migrates chunks of the table, until every chunk has been claimed by one of the helping threads; a chunk is only complete once all of its entries have landed */
+static INLINE void lockfree_help(hash_map_lockfree_t *const instance, lockfree_table_t *const table, lockfree_table_t *const next)
+{
+	size_t chunk, index, limit;
+
+	while ((chunk = atomic_add_size(&table->claimed, 1U) - 1U) < table->chunks)
+	{
+		limit = ((chunk + 1U) * MIGRATE_CHUNK < table->capacity) ? ((chunk + 1U) * MIGRATE_CHUNK) : table->capacity;
+		for (index = chunk * MIGRATE_CHUNK; index < limit; ++index)
+		{
+			value_t key = LOAD_WORD(ENTRY_KEY(table, index));
+			if ((key == SENTINEL_EMPTY) && ((key = SWAP_WORD(ENTRY_KEY(table, index), SENTINEL_EMPTY, LOCKFREE_MOVED)) == SENTINEL_EMPTY))
+			{
+				continue;
+			}
+			if (key != LOCKFREE_MOVED)
+			{
+				if (entry_seal(table, index))
+				{
+					lockfree_move(instance, table, index, key, next);
+				}
+				else
+				{
+					entry_await(table, index);
+				}
+			}
+		}
+		if (atomic_add_size(&table->migrated, 1U) == table->chunks)
+		{
+			lockfree_advance(instance);
+		}
+	}
+}
+
+/* a thread that finds the table being migrated helps with the remaining chunks, then moves the entry of its own key, unless another thread does so, and goes on in the next table; if the entry is sealed right after the update has been applied, then whatever is left in the old slot is forwarded */
+static INLINE errno_t lockfree_update(hash_map_lockfree_t *const instance, const uint64_t hash, const value_t key, const update_t update, const value_t operand, value_t *const previous)
+{
+	lockfree_table_t *table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current);
+	value_t pending = operand, found, before, base = 0U;
+	bool_t forwarded = FALSE;
+	errno_t error, result = EEXIST;
+	size_t index;
+
+	for (;;)
+	{
+		lockfree_table_t *const next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+		const size_t stripe = shard_index(hash, table->stripes);
+
+		if (next)
+		{
+			lockfree_help(instance, table, next);
+			if ((error = lockfree_locate(table, &instance->hash, hash, key, LOCKFREE_MOVED, &index)) == EEXIST)
+			{
+				if (entry_seal(table, index))
+				{
+					lockfree_move(instance, table, index, key, next);
+				}
+				else
+				{
+					entry_await(table, index);
+				}
+			}
+			table = next;
+			continue;
+		}
+
+		error = lockfree_locate(table, &instance->hash, hash, key, (atomic_load_size(&table->used[stripe].value) < table->limit / table->stripes) ? key : SENTINEL_EMPTY, &index);
+		if ((error == ENOENT) || (error == EAGAIN))
+		{
+			/* unless a resize has sealed the slot, the table is full */
+			if ((!atomic_load_ptr((void *const volatile*)&table->next)) && ((error = lockfree_grow(instance, table)) != 0))
+			{
+				return error;
+			}
+			continue;
+		}
+
+		if (!error)
+		{
+			atomic_add_size(&table->used[stripe].value, 1U);
+			atomic_add_size(&instance->size[shard_index(hash, MAX_STRIPES)].value, 1U);
+			result = 0;
+		}
+
+		if (entry_state(table, index))
+		{
+			entry_await(table, index);
+			table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+			continue;
+		}
+
+		found = lockfree_apply(&ENTRY_VALUE(table, index), update, pending);
+		before = forwarded ? lockfree_combine(update, found, base) : found;
+
+		/* if the entry has been sealed meanwhile, then the update may have been applied after the value was moved, so whatever is left in the old slot is forwarded */
+		if ((!entry_state(table, index)) || (!(pending = (value_t) atomic_swap_word(&ENTRY_VALUE(table, index), sizeof(value_t), 0U))))
+		{
+			SAFE_SET(previous, before);
+			return result;
+		}
+
+		if (!forwarded)
+		{
+			base = found;
+			forwarded = TRUE;
+		}
+
+		entry_await(table, index);
+		table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+	}
+}
+
+/* the value is read from the first table in which the entry has not been moved yet */
+static INLINE errno_t lockfree_get(const hash_map_lockfree_t *const instance, const uint64_t hash, const value_t key, value_t *const value)
+{
+	lockfree_table_t *table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current);
+	value_t found;
+	errno_t error;
+	size_t index;
+
+	while (table)
+	{
+		if ((error = lockfree_locate(table, &instance->hash, hash, key, SENTINEL_EMPTY, &index)) == EEXIST)
+		{
+			if (!entry_state(table, index))
+			{
+				found = LOAD_WORD(ENTRY_VALUE(table, index));
+				if (!entry_state(table, index))
+				{
+					SAFE_SET(value, found);
+					return 0;
+				}
+			}
+			entry_await(table, index);
+		}
+		else if (error != EAGAIN)
+		{
+			return error;
+		}
+
+		table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+	}
+
+	return ENOENT;
+}
+
+/* copies the entries of the table that have not been moved; the moved entries are copied from the next table */
+static INLINE errno_t lockfree_copy(const lockfree_table_t *const table, hash_map_t *const target)
+{
+	size_t index;
+	value_t key, value;
+	errno_t error;
+
+	for (index = 0U; index < table->capacity; ++index)
+	{
+		if (((key = LOAD_WORD(ENTRY_KEY(table, index))) == SENTINEL_EMPTY) || (key == LOCKFREE_MOVED))
+		{
+			continue;
+		}
+		if (!entry_state(table, index))
+		{
+			value = LOAD_WORD(ENTRY_VALUE(table, index));
+			if (!entry_state(table, index))
+			{
+				if ((error = insert_entry(target, hash_compute(&target->hash, key), key, value, TRUE)) && (error != EEXIST))
+				{
+					return error;
+				}
+				continue;
+			}
+		}
+		entry_await(table, index);
+	}
+
+	return 0;
+}
+
+#endif /* _LIBHASHSET_GENERIC_MAP_LOCKFREE_INCLUDED */
@@ -0,0 +1,137 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_MAP_ROBINHOOD_INCLUDED
+#define _LIBHASHSET_GENERIC_MAP_ROBINHOOD_INCLUDED
+
+/*
+ * Robin Hood engine: Linear probing, where each slot stores the distance of
+ * its entry from the entry's "home" slot, plus one (zero means "unused"). The
+ * entries of a cluster are kept ordered by their home slot, so a lookup stops
+ * as soon as it meets an entry that is closer to its home than the wanted
+ * entry would be. Removal shifts the subsequent entries back by one slot, so
+ * there never are any "deleted" slots.
+ */
+
+static INLINE bool_t robinhood_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t array_size = align_size(entries_size(data->layout, capacity));
+	uint8_t *const block = alloc_block(safe_add(array_size, capacity), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	setup_entries(data, block, capacity);
+	data->dist = block + array_size;
+	return TRUE;
+}
+
+static FORCE_INLINE void robinhood_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	const size_t index = ((size_t)hash) & (data->capacity - 1U);
+	PREFETCH(&data->dist[index]);
+	prefetch_entry(data, index);
+}
+
+static INLINE bool_t robinhood_find_slot(const hash_data_t *const data, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t index, dist;
+
+	for (index = (size_t)hash & mask, dist = 1U; data->dist[index] >= dist; index = (index + 1U) & mask, ++dist)
+	{
+		if ((data->dist[index] == dist) && (KEY(data, index) == key))
+		{
+			SAFE_SET(index_out, index);
+			SAFE_SET(reused_out, FALSE);
+			return TRUE;
+		}
+	}
+
+	SAFE_SET(index_out, index);
+	SAFE_SET(reused_out, FALSE);
+	return FALSE;
+}
+
+/* returns FALSE, if a probe distance would overflow, in which case the table remains unchanged */
+static INLINE bool_t robinhood_put_entry(hash_data_t *const data, const size_t index, const uint64_t hash, const value_t key, const value_t value)
+{
+	const size_t mask = data->capacity - 1U;
+	const size_t dist = ((index - (size_t)hash) & mask) + 1U;
+	size_t last, prev;
+
+	if (dist > DIST_MAX)
+	{
+		return FALSE;
+	}
+
+	for (last = index; data->dist[last] != DIST_EMPTY; last = (last + 1U) & mask)
+	{
+		if (data->dist[last] >= DIST_MAX)
+		{
+			return FALSE;
+		}
+	}
+
+	for (; last != index; last = prev)
+	{
+		prev = (last - 1U) & mask;
+		move_entry(data, last, prev);
+		data->dist[last] = data->dist[prev] + 1U;
+	}
+
+	set_entry(data, index, key, value);
+	data->dist[index] = (uint8_t)dist;
+	return TRUE;
+}
+
+static INLINE void robinhood_erase_entry(hash_data_t *const data, size_t index)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t next;
+
+	for (next = (index + 1U) & mask; data->dist[next] > 1U; index = next, next = (next + 1U) & mask)
+	{
+		move_entry(data, index, next);
+		data->dist[index] = data->dist[next] - 1U;
+	}
+
+	data->dist[index] = DIST_EMPTY;
+}
+
+/* the entry is inserted in the usual way, as long as neither the probe sequence nor the run of entries that needs to be shifted leaves the region */
+static INLINE place_t robinhood_place_entry(hash_data_t *const data, const uint64_t hash, const value_t key, const value_t value, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t index, last;
+
+	for (index = ((size_t)hash + *steps) & mask; in_region(region, index); index = (index + 1U) & mask, ++(*steps))
+	{
+		if (data->dist[index] <= *steps)
+		{
+			last = index;
+			while (in_region(region, last) && (data->dist[last] != DIST_EMPTY))
+			{
+				last = (last + 1U) & mask;
+			}
+			return (in_region(region, last) && robinhood_put_entry(data, index, hash, key, value)) ? PLACE_DONE : PLACE_SERIAL;
+		}
+		if ((data->dist[index] == *steps + 1U) && (KEY(data, index) == key))
+		{
+			*index_out = index;
+			return PLACE_EXISTS;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void robinhood_clear_data(hash_data_t *const data)
+{
+	zero_memory(data->dist, data->capacity, sizeof(uint8_t));
+}
+
+#endif /* _LIBHASHSET_GENERIC_MAP_ROBINHOOD_INCLUDED */
@@ -0,0 +1,210 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_MAP_SENTINEL_INCLUDED
+#define _LIBHASHSET_GENERIC_MAP_SENTINEL_INCLUDED
+
+/*
+ * Sentinel engine: The state of a slot is encoded in the key itself, by
+ * reserving two "sentinel" values that mark an "unused" or a "deleted" slot,
+ * so that each probe touches exactly one array. The entries whose keys happen
+ * to be equal to one of the sentinel values are stored "out-of-band", in two
+ * extra slots located right after the last regular slot.
+ */
+
+#define SENTINEL_EMPTY   ((value_t)0U)
+#define SENTINEL_DELETED ((value_t)(~((value_t)0U)))
+
+#define IS_SENTINEL(X) (((X) == SENTINEL_EMPTY) || ((X) == SENTINEL_DELETED))
+#define ESCAPE_SLOT(X) (((X) == SENTINEL_EMPTY) ? 0U : 1U)
+
+static INLINE bool_t sentinel_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	uint8_t *const block = alloc_block(entries_size(data->layout, capacity + 2U), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	setup_entries(data, block, capacity + 2U);
+	return TRUE;
+}
+
+static FORCE_INLINE void sentinel_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	prefetch_entry(data, ((size_t)hash) & (data->capacity - 1U));
+}
+
+static INLINE bool_t sentinel_find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
+{
+	probe_t probe;
+	value_t current;
+	bool_t is_saved = FALSE;
+
+	if (IS_SENTINEL(key))
+	{
+		const size_t slot = ESCAPE_SLOT(key);
+		SAFE_SET(index_out, data->capacity + slot);
+		SAFE_SET(reused_out, FALSE);
+		return get_flag(&data->escape, slot);
+	}
+
+	for (probe_init(&probe, param, hash, data->capacity); (current = KEY(data, probe.index)) != SENTINEL_EMPTY; probe_next(&probe, data->capacity))
+	{
+		PREFETCH(&KEY(data, probe_peek(&probe, data->capacity)));
+
+		if (current == key)
+		{
+			SAFE_SET(index_out, probe.index);
+			SAFE_SET(reused_out, FALSE);
+			return TRUE;
+		}
+
+		if ((current == SENTINEL_DELETED) && (!is_saved))
+		{
+			SAFE_SET(index_out, probe.index);
+			SAFE_SET(reused_out, TRUE);
+			is_saved = TRUE;
+		}
+	}
+
+	if (!is_saved)
+	{
+		SAFE_SET(index_out, probe.index);
+		SAFE_SET(reused_out, FALSE);
+	}
+
+	return FALSE;
+}
+
+static INLINE void sentinel_put_entry(hash_data_t *const data, const size_t index, const value_t key, const value_t value)
+{
+	set_entry(data, index, key, value);
+
+	if (index >= data->capacity)
+	{
+		set_flag(&data->escape, index - data->capacity);
+	}
+}
+
+/* returns TRUE, if the slot was turned into a "deleted" slot, or FALSE, if the (out-of-band) slot was turned into an "unused" slot */
+static INLINE bool_t sentinel_erase_entry(hash_data_t *const data, const size_t index)
+{
+	if (index >= data->capacity)
+	{
+		clear_flag(&data->escape, index - data->capacity);
+		return FALSE;
+	}
+
+	KEY(data, index) = SENTINEL_DELETED;
+	return TRUE;
+}
+
+static INLINE bool_t sentinel_is_valid(const hash_data_t *const data, const size_t index)
+{
+	return (index < data->capacity) ? (!IS_SENTINEL(KEY(data, index))) : get_flag(&data->escape, index - data->capacity);
+}
+
+static INLINE char sentinel_get_status(const hash_data_t *const data, const size_t index)
+{
+	if (index >= data->capacity)
+	{
+		return get_flag(&data->escape, index - data->capacity) ? 'v' : 'u';
+	}
+
+	return (KEY(data, index) == SENTINEL_EMPTY) ? 'u' : ((KEY(data, index) == SENTINEL_DELETED) ? 'd' : 'v');
+}
+
+static INLINE place_t sentinel_place_entry(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, const value_t value, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	probe_t probe;
+
+	if (IS_SENTINEL(key))
+	{
+		return PLACE_SERIAL;
+	}
+
+	probe_init(&probe, param, hash, data->capacity);
+	probe_skip(&probe, *steps, data->capacity);
+
+	for (; in_region(region, probe.index); probe_next(&probe, data->capacity), ++(*steps))
+	{
+		if (KEY(data, probe.index) == SENTINEL_EMPTY)
+		{
+			set_entry(data, probe.index, key, value);
+			return PLACE_DONE;
+		}
+		if (KEY(data, probe.index) == key)
+		{
+			*index_out = probe.index;
+			return PLACE_EXISTS;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void sentinel_clear_data(hash_data_t *const data)
+{
+	zero_memory(data->keys, data->capacity << data->shift, sizeof(value_t));
+	data->escape = 0U;
+}
+
+/* in-place purge: the entries that still need to be re-inserted are tracked in a scratch bitmap, because there is no spare in-band state */
+static INLINE bool_t sentinel_purge_data(hash_data_t *const data, const hash_param_t *const param)
+{
+	size_t i;
+	probe_t probe;
+
+	uint8_t *const pending = (uint8_t*) heap_calloc(data->block.memory.allocator, div_ceil(data->capacity, 8U), sizeof(uint8_t));
+	if (!pending)
+	{
+		return FALSE;
+	}
+
+	for (i = 0U; i < data->capacity; ++i)
+	{
+		if (KEY(data, i) == SENTINEL_DELETED)
+		{
+			KEY(data, i) = SENTINEL_EMPTY;
+		}
+		else if (KEY(data, i) != SENTINEL_EMPTY)
+		{
+			set_flag(pending, i);
+		}
+	}
+
+	for (i = 0U; i < data->capacity; ++i)
+	{
+		while (get_flag(pending, i))
+		{
+			const value_t key = KEY(data, i), value = VALUE(data, i);
+			probe_init(&probe, param, hash_compute(param, key), data->capacity);
+			while ((KEY(data, probe.index) != SENTINEL_EMPTY) && (!get_flag(pending, probe.index)))
+			{
+				probe_next(&probe, data->capacity);
+			}
+			clear_flag(pending, probe.index);
+			if (probe.index != i)
+			{
+				if (KEY(data, probe.index) != SENTINEL_EMPTY)
+				{
+					move_entry(data, i, probe.index); /*swap with a pending entry, which is processed next*/
+				}
+				else
+				{
+					KEY(data, i) = SENTINEL_EMPTY;
+					clear_flag(pending, i);
+				}
+				set_entry(data, probe.index, key, value);
+			}
+		}
+	}
+
+	heap_free(data->block.memory.allocator, pending);
+	return TRUE;
+}
+
+#endif /* _LIBHASHSET_GENERIC_MAP_SENTINEL_INCLUDED */
@@ -0,0 +1,245 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_MAP_SWISS_INCLUDED
+#define _LIBHASHSET_GENERIC_MAP_SWISS_INCLUDED
+
+/*
+ * Swiss engine: One control byte per slot, with the high bit indicating an
+ * "empty" or "deleted" slot and the low seven bits holding a tag taken from
+ * the hash value. Slots are probed in groups of GROUP_SIZE control bytes, so
+ * that all candidates of a group are found by a single SIMD comparison.
+ */
+
+static INLINE bool_t swiss_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t ctrl_size = align_size(capacity);
+	uint8_t *block;
+
+	assert(!(capacity % GROUP_SIZE));
+
+	block = alloc_block(safe_add(ctrl_size, entries_size(data->layout, capacity)), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	data->ctrl = block;
+	setup_entries(data, block + ctrl_size, capacity);
+	memset(data->ctrl, CTRL_EMPTY, capacity * sizeof(uint8_t));
+	return TRUE;
+}
+
+static FORCE_INLINE void swiss_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	const size_t base = (((size_t)(hash >> 7)) & ((data->capacity / GROUP_SIZE) - 1U)) * GROUP_SIZE;
+	PREFETCH(&data->ctrl[base]);
+	prefetch_entry(data, base);
+}
+
+static INLINE bool_t swiss_find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out, bool_t *const reused_out)
+{
+	const size_t group_count = data->capacity / GROUP_SIZE;
+	const uint8_t tag = CTRL_TAG(hash);
+	bool_t is_saved = FALSE;
+	probe_t probe;
+
+	for (probe_init(&probe, param, hash >> 7, group_count); ; probe_next(&probe, group_count))
+	{
+		const size_t base = probe.index * GROUP_SIZE;
+		const uint8_t *const group = data->ctrl + base;
+		uint32_t match = group_match(group, tag);
+
+		PREFETCH(&data->ctrl[probe_peek(&probe, group_count) * GROUP_SIZE]);
+
+		while (match)
+		{
+			const size_t index = base + count_trailing_zeros(match);
+			if (KEY(data, index) == key)
+			{
+				SAFE_SET(index_out, index);
+				SAFE_SET(reused_out, FALSE);
+				return TRUE;
+			}
+			match &= match - 1U;
+		}
+
+		if (!is_saved)
+		{
+			const uint32_t available = group_match_available(group);
+			if (available)
+			{
+				const size_t index = base + count_trailing_zeros(available);
+				SAFE_SET(index_out, index);
+				SAFE_SET(reused_out, (data->ctrl[index] == CTRL_DELETED));
+				is_saved = TRUE;
+			}
+		}
+
+		if (group_match(group, CTRL_EMPTY))
+		{
+			return FALSE;
+		}
+	}
+}
+
+static INLINE void swiss_put_entry(hash_data_t *const data, const size_t index, const uint64_t hash, const value_t key, const value_t value)
+{
+	assert(!IS_FULL(data->ctrl[index]));
+	set_entry(data, index, key, value);
+	RELEASE_FENCE(); /*concurrent readers must see the entry before the control byte*/
+	data->ctrl[index] = CTRL_TAG(hash);
+}
+
+/* concurrent readers: the control bytes are loaded before the keys, so that a full slot never exposes an entry that has not been published yet */
+static INLINE bool_t swiss_find_shared(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, size_t *const index_out)
+{
+	const size_t group_count = data->capacity / GROUP_SIZE;
+	const uint8_t tag = CTRL_TAG(hash);
+	probe_t probe;
+
+	for (probe_init(&probe, param, hash >> 7, group_count); ; probe_next(&probe, group_count))
+	{
+		const size_t base = probe.index * GROUP_SIZE;
+		uint32_t match = group_match(data->ctrl + base, tag);
+		const uint32_t empty = group_match(data->ctrl + base, CTRL_EMPTY);
+
+		ACQUIRE_FENCE();
+
+		while (match)
+		{
+			const size_t index = base + count_trailing_zeros(match);
+			if (KEY(data, index) == key)
+			{
+				*index_out = index;
+				return TRUE;
+			}
+			match &= match - 1U;
+		}
+
+		if (empty)
+		{
+			return FALSE;
+		}
+	}
+}
+
+/* the first slot of the probe sequence that has never been used */
+static INLINE size_t swiss_unused_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash)
+{
+	const size_t group_count = data->capacity / GROUP_SIZE;
+	uint32_t empty;
+	probe_t probe;
+
+	probe_init(&probe, param, hash >> 7, group_count);
+
+	while (!(empty = group_match(data->ctrl + (probe.index * GROUP_SIZE), CTRL_EMPTY)))
+	{
+		probe_next(&probe, group_count);
+	}
+
+	return (probe.index * GROUP_SIZE) + count_trailing_zeros(empty);
+}
+
+static INLINE bool_t swiss_erase_entry(hash_data_t *const data, const size_t index)
+{
+	/* if the group still has an empty slot, then no probe sequence has ever continued past this group */
+	if (group_match(data->ctrl + (index - (index % GROUP_SIZE)), CTRL_EMPTY))
+	{
+		data->ctrl[index] = CTRL_EMPTY;
+		return FALSE;
+	}
+
+	data->ctrl[index] = CTRL_DELETED;
+	return TRUE;
+}
+
+static INLINE place_t swiss_place_entry(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t key, const value_t value, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	const size_t group_count = data->capacity / GROUP_SIZE;
+	const uint8_t tag = CTRL_TAG(hash);
+	probe_t probe;
+
+	probe_init(&probe, param, hash >> 7, group_count);
+	probe_skip(&probe, *steps, group_count);
+
+	for (; in_region(region, probe.index * GROUP_SIZE); probe_next(&probe, group_count), ++(*steps))
+	{
+		const size_t base = probe.index * GROUP_SIZE;
+		uint32_t match = group_match(data->ctrl + base, tag), available;
+
+		while (match)
+		{
+			const size_t index = base + count_trailing_zeros(match);
+			if (KEY(data, index) == key)
+			{
+				*index_out = index;
+				return PLACE_EXISTS;
+			}
+			match &= match - 1U;
+		}
+
+		available = group_match(data->ctrl + base, CTRL_EMPTY);
+		if (available)
+		{
+			const size_t index = base + count_trailing_zeros(available);
+			set_entry(data, index, key, value);
+			data->ctrl[index] = tag;
+			return PLACE_DONE;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void swiss_clear_data(hash_data_t *const data)
+{
+	memset(data->ctrl, CTRL_EMPTY, data->capacity * sizeof(uint8_t));
+}
+
+/* in-place purge: "deleted" slots become "empty", while the full slots are marked as "deleted" until their entries have been re-inserted */
+static INLINE void swiss_purge_data(hash_data_t *const data, const hash_param_t *const param)
+{
+	const size_t group_count = data->capacity / GROUP_SIZE;
+	size_t i, target;
+	probe_t probe;
+
+	for (i = 0U; i < data->capacity; ++i)
+	{
+		data->ctrl[i] = IS_FULL(data->ctrl[i]) ? CTRL_DELETED : CTRL_EMPTY;
+	}
+
+	for (i = 0U; i < data->capacity; ++i)
+	{
+		while (data->ctrl[i] == CTRL_DELETED)
+		{
+			const value_t key = KEY(data, i), value = VALUE(data, i);
+			const uint64_t hash = hash_compute(param, key);
+			probe_init(&probe, param, hash >> 7, group_count);
+			while (!group_match_available(data->ctrl + (probe.index * GROUP_SIZE)))
+			{
+				probe_next(&probe, group_count);
+			}
+			if (probe.index == (i / GROUP_SIZE))
+			{
+				data->ctrl[i] = CTRL_TAG(hash); /*already located in the first group that has room*/
+				break;
+			}
+			target = (probe.index * GROUP_SIZE) + count_trailing_zeros(group_match_available(data->ctrl + (probe.index * GROUP_SIZE)));
+			if (data->ctrl[target] == CTRL_EMPTY)
+			{
+				data->ctrl[i] = CTRL_EMPTY;
+			}
+			else
+			{
+				move_entry(data, i, target); /*swap with a pending entry, which is processed next*/
+			}
+			set_entry(data, target, key, value);
+			data->ctrl[target] = CTRL_TAG(hash);
+		}
+	}
+}
+
+#endif /* _LIBHASHSET_GENERIC_MAP_SWISS_INCLUDED */
@@ -21,91 +21,153 @@
 typedef struct DECLARE(_hash_set_data)
 {
 	value_t *items;
-	uint8_t *used, *deleted;
+	uint8_t *used, *deleted; /*bitmap engine, cuckoo engine*/
+	uint8_t *ctrl; /*swiss engine*/
+	uint8_t *dist; /*robinhood engine*/
+	uint8_t escape; /*sentinel engine*/
+	block_t block;
+	hash_engine_t engine;
 	size_t capacity;
 }
 hash_data_t;
 
+typedef struct DECLARE(_hash_set_snapshot)
+{
+	hash_data_t data;
+	uint64_t retired; /*epoch in which the table was replaced*/
+	struct DECLARE(_hash_set_snapshot) *next;
+}
+snapshot_t;
+
+/* the state that concurrent readers access, it is modified only when the writer publishes a new table */
+typedef struct
+{
+	epoch_t epoch;
+	snapshot_t *volatile current;
+	snapshot_t *retired;
+	hash_param_t hash;
+}
+shared_t;
+
 struct DECLARE(_hash_set)
 {
 	double load_factor;
-	size_t valid, deleted, limit;
-	uint64_t basis;
-	hash_data_t data;
+	size_t valid, deleted, limit, threads;
+	size_t pending, migrated; /*incremental resize*/
+	bool_t incremental;
+	size_t growth;
+	hash_shrink_t shrink;
+	double shrink_threshold;
+	hash_allocator_t allocator;
+	arena_t arena; /*instances that live in a caller-provided buffer*/
+	hash_param_t hash;
+	hash_data_t data, old;
+	shared_t *shared; /*concurrent readers, NULL otherwise*/
+	block_t shared_block;
+	size_t collect;
 };
 
-/* ------------------------------------------------- */
-/* Allocation                                        */
-/* ------------------------------------------------- */
+typedef struct
+{
+	lock_t lock;
+	hash_set_t *instance;
+}
+shard_state_t;
 
-static INLINE bool_t alloc_data(hash_data_t *const data, const size_t capacity)
+/* each shard owns a separate cache line, so that threads working on different shards never write to the same cache line */
+typedef union
 {
-	zero_memory(data, 1U, sizeof(hash_data_t));
+	shard_state_t state;
+	uint8_t padding[PADDED_SIZE(sizeof(shard_state_t))];
+}
+shard_t;
 
-	data->items = (value_t*) calloc(capacity, sizeof(value_t));
-	if (!data->items)
-	{
-		return FALSE;
-	}
+struct DECLARE(_hash_set_concurrent)
+{
+	hash_param_t hash;
+	size_t shard_count;
+	hash_allocator_t allocator;
+	block_t block;
+	shard_t *shards;
+};
 
-	data->used = (uint8_t*) calloc(div_ceil(capacity, 8U), sizeof(uint8_t));
-	if (!data->used)
-	{
-		SAFE_FREE(data->items);
-		return FALSE;
-	}
+typedef struct DECLARE(_hash_set_lockfree_table)
+{
+	counter_t used[MAX_STRIPES]; /*the first member, so that the counters are aligned to the cache lines*/
+	volatile value_t *items;
+	size_t capacity, limit, stripes, chunks;
+	volatile size_t claimed, migrated; /*resize progress, in chunks*/
+	struct DECLARE(_hash_set_lockfree_table) *volatile next;
+	struct DECLARE(_hash_set_lockfree_table) *previous;
+	block_t block;
+}
+lockfree_table_t;
+
+struct DECLARE(_hash_set_lockfree)
+{
+	lockfree_table_t *volatile current;
+	hash_param_t hash;
+	double load_factor;
+	size_t growth;
+	memory_t memory;
+	hash_allocator_t allocator;
+	volatile uint32_t escape[2U]; /*the items that are equal to one of the sentinel values*/
+	counter_t *size;
+	block_t size_block;
+};
+
+/* ------------------------------------------------- */
+/* Bitmap engine                                     */
+/* ------------------------------------------------- */
 
-	data->deleted = (uint8_t*) calloc(div_ceil(capacity, 8U), sizeof(uint8_t));
-	if (!data->deleted)
+static INLINE bool_t bitmap_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t array_size = align_size(safe_mult(capacity, sizeof(value_t))), flags_size = align_size(div_ceil(capacity, 8U));
+	uint8_t *const block = alloc_block(safe_add(array_size, safe_times2(flags_size)), &data->block);
+	if (!block)
 	{
-		SAFE_FREE(data->used);
-		SAFE_FREE(data->items);
 		return FALSE;
 	}
 
-	data->capacity = capacity;
+	data->items = (value_t*) block;
+	data->used = block + array_size;
+	data->deleted = data->used + flags_size;
 	return TRUE;
 }
 
-static INLINE void free_data(hash_data_t *const data)
+static FORCE_INLINE void bitmap_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
 {
-	if (data)
-	{
-		SAFE_FREE(data->items);
-		SAFE_FREE(data->used);
-		SAFE_FREE(data->deleted);
-		data->capacity = 0U;
-	}
+	const size_t index = ((size_t)hash) & (data->capacity - 1U);
+	PREFETCH(&data->used[index / 8U]);
+	PREFETCH(&data->deleted[index / 8U]);
+	PREFETCH(&data->items[index]);
 }
 
-/* ------------------------------------------------- */
-/* Set functions                                     */
-/* ------------------------------------------------- */
-
-#define INDEX(X) ((size_t)((X) % data->capacity))
-
-static INLINE bool_t find_slot(const hash_data_t *const data, const uint64_t basis, const value_t item, size_t *const index_out, bool_t *const reused_out)
+static INLINE bool_t bitmap_find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item, size_t *const index_out, bool_t *const reused_out)
 {
-	size_t index;
+	probe_t probe;
 	bool_t is_saved = FALSE;
-	uint64_t loop = 0U;
 
-	for (index = INDEX(hash_compute(basis, loop, item)); get_flag(data->used, index); index = INDEX(hash_compute(basis, ++loop, item)))
+	for (probe_init(&probe, param, hash, data->capacity); get_flag(data->used, probe.index); probe_next(&probe, data->capacity))
 	{
-		if (get_flag(data->deleted, index))
+		const size_t next = probe_peek(&probe, data->capacity);
+		PREFETCH(&data->used[next / 8U]);
+		PREFETCH(&data->items[next]);
+
+		if (get_flag(data->deleted, probe.index))
 		{
 			if (!is_saved)
 			{
-				SAFE_SET(index_out, index);
+				SAFE_SET(index_out, probe.index);
 				SAFE_SET(reused_out, TRUE);
 				is_saved = TRUE;
 			}
 		}
 		else
 		{
-			if (data->items[index] == item)
+			if (data->items[probe.index] == item)
 			{
-				SAFE_SET(index_out, index);
+				SAFE_SET(index_out, probe.index);
 				SAFE_SET(reused_out, FALSE);
 				return TRUE;
 			}
@@ -114,16 +176,17 @@ static INLINE bool_t find_slot(const hash_data_t *const data, const uint64_t bas
 
 	if (!is_saved)
 	{
-		SAFE_SET(index_out, index);
+		SAFE_SET(index_out, probe.index);
 		SAFE_SET(reused_out, FALSE);
 	}
 
 	return FALSE;
 }
 
-static INLINE void put_item(hash_data_t *const data, const size_t index, const value_t item, const bool_t reusing)
+static INLINE void bitmap_put_item(hash_data_t *const data, const size_t index, const value_t item, const bool_t reusing)
 {
 	data->items[index] = item;
+	RELEASE_FENCE(); /*concurrent readers must see the item before the flag*/
 
 	if (reusing)
 	{
@@ -137,274 +200,2514 @@ static INLINE void put_item(hash_data_t *const data, const size_t index, const v
 	}
 }
 
-static INLINE size_t compute_limit(const size_t capacity, const double load_factor)
+/* concurrent readers: the flags are loaded before the item, so that a "used" slot never exposes an item that has not been published yet */
+static INLINE bool_t bitmap_find_shared(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item)
 {
-	size_t limit = round_sz(capacity * load_factor);
+	probe_t probe;
 
-	while (capacity && (limit >= capacity))
+	for (probe_init(&probe, param, hash, data->capacity); get_flag(data->used, probe.index); probe_next(&probe, data->capacity))
 	{
-		limit = safe_decr(limit);
+		ACQUIRE_FENCE();
+		if ((!get_flag(data->deleted, probe.index)) && (data->items[probe.index] == item))
+		{
+			return TRUE;
+		}
 	}
 
-	return limit;
+	return FALSE;
 }
 
-static INLINE errno_t rebuild_set(hash_set_t *const instance, const size_t new_capacity)
+/* the first slot of the probe sequence that has never been used */
+static INLINE size_t bitmap_unused_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash)
 {
-	size_t k, index = SIZE_MAX;
-	hash_data_t temp;
+	probe_t probe;
+	probe_init(&probe, param, hash, data->capacity);
 
-	if (new_capacity < instance->valid)
+	while (get_flag(data->used, probe.index))
 	{
-		return EINVAL;
+		probe_next(&probe, data->capacity);
 	}
 
-	if (!alloc_data(&temp, new_capacity))
+	return probe.index;
+}
+
+/* bulk construction: follows the probe sequence, after the given number of steps, for as long as it stays inside of the region */
+static INLINE place_t bitmap_place_item(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	probe_t probe;
+	probe_init(&probe, param, hash, data->capacity);
+	probe_skip(&probe, *steps, data->capacity);
+
+	for (; in_region(region, probe.index); probe_next(&probe, data->capacity), ++(*steps))
 	{
-		return ENOMEM;
+		if (!get_flag(data->used, probe.index))
+		{
+			data->items[probe.index] = item;
+			set_flag(data->used, probe.index);
+			return PLACE_DONE;
+		}
+		if (data->items[probe.index] == item)
+		{
+			*index_out = probe.index;
+			return PLACE_EXISTS;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void bitmap_clear_data(hash_data_t *const data)
+{
+	const size_t count = div_ceil(data->capacity, 8U);
+	zero_memory(data->used, count, sizeof(uint8_t));
+	zero_memory(data->deleted, count, sizeof(uint8_t));
+}
+
+/* in-place purge: "deleted" slots become "unused", while the "deleted" flag now marks the items that still need to be re-inserted */
+static INLINE void bitmap_purge_data(hash_data_t *const data, const hash_param_t *const param)
+{
+	const size_t count = div_ceil(data->capacity, 8U);
+	size_t i;
+	probe_t probe;
+
+	for (i = 0U; i < count; ++i)
+	{
+		data->used[i] &= (uint8_t)(~data->deleted[i]);
+		data->deleted[i] = data->used[i];
 	}
 
-	for (k = 0U; k < instance->data.capacity; ++k)
+	for (i = 0U; i < data->capacity; ++i)
 	{
-		if (IS_VALID(instance->data, k))
+		while (get_flag(data->deleted, i))
 		{
-			const value_t item = instance->data.items[k];
-			if (find_slot(&temp, instance->basis, item, &index, NULL))
+			const value_t item = data->items[i];
+			probe_init(&probe, param, hash_compute(param, item), data->capacity);
+			while (get_flag(data->used, probe.index) && (!get_flag(data->deleted, probe.index)))
 			{
-				free_data(&temp);
-				return EFAULT; /*this should never happen!*/
+				probe_next(&probe, data->capacity);
+			}
+			clear_flag(data->deleted, probe.index);
+			if (probe.index != i)
+			{
+				if (get_flag(data->used, probe.index))
+				{
+					data->items[i] = data->items[probe.index]; /*swap with a pending item, which is processed next*/
+				}
+				else
+				{
+					set_flag(data->used, probe.index);
+					clear_flag(data->used, i);
+					clear_flag(data->deleted, i);
+				}
+				data->items[probe.index] = item;
 			}
-			put_item(&temp, index, item, FALSE);
 		}
 	}
+}
 
-	free_data(&instance->data);
-	instance->data = temp;
-	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
-	instance->deleted = 0U;
+/* ------------------------------------------------- */
+/* Swiss engine                                      */
+/* ------------------------------------------------- */
 
-	return 0;
-}
+#include "generic_hash_set_swiss.h"
 
-/* ========================================================================= */
-/* PUBLIC FUNCTIONS                                                          */
-/* ========================================================================= */
+/* ------------------------------------------------- */
+/* Robin Hood engine                                 */
+/* ------------------------------------------------- */
 
-hash_set_t *DECLARE(hash_set_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed)
+#include "generic_hash_set_robinhood.h"
+
+/* ------------------------------------------------- */
+/* Cuckoo engine                                     */
+/* ------------------------------------------------- */
+
+#include "generic_hash_set_cuckoo.h"
+
+/* ------------------------------------------------- */
+/* Sentinel engine                                   */
+/* ------------------------------------------------- */
+
+#include "generic_hash_set_sentinel.h"
+
+/* ------------------------------------------------- */
+/* Allocation                                        */
+/* ------------------------------------------------- */
+
+static INLINE bool_t alloc_data(hash_data_t *const data, const hash_engine_t engine, const memory_t memory, size_t capacity)
 {
-	hash_set_t *instance = (hash_set_t*) calloc(1U, sizeof(hash_set_t));
-	if (!instance)
+	bool_t success;
+	zero_memory(data, 1U, sizeof(hash_data_t));
+	data->block.memory = memory;
+
+	switch (engine)
 	{
-		return NULL;
+	case HASHSET_ENGINE_SWISS:
+		capacity = (capacity > GROUP_SIZE) ? capacity : GROUP_SIZE;
+		success = swiss_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		success = robinhood_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		capacity = (capacity > 2U * BUCKET_SIZE) ? capacity : (2U * BUCKET_SIZE);
+		success = cuckoo_alloc_data(data, capacity);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		success = sentinel_alloc_data(data, capacity);
+		break;
+	default:
+		success = bitmap_alloc_data(data, capacity);
 	}
 
-	if (!alloc_data(&instance->data, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY))
+	if (!success)
 	{
-		SAFE_FREE(instance);
-		return NULL;
+		return FALSE;
 	}
 
-	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
-	instance->basis = hash_initialize(seed);
-	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
-
-	return instance;
+	data->engine = engine;
+	data->capacity = capacity;
+	return TRUE;
 }
 
-void DECLARE(hash_set_destroy)(hash_set_t *instance)
+static INLINE void free_data(hash_data_t *const data)
 {
-	if (instance)
+	if (data)
 	{
-		free_data(&instance->data);
-		zero_memory(instance, 1U, sizeof(hash_set_t));
-		SAFE_FREE(instance);
+		free_block(&data->block);
+		zero_memory(data, 1U, sizeof(hash_data_t));
 	}
 }
 
-errno_t DECLARE(hash_set_insert)(hash_set_t *const instance, const value_t item)
-{
-	size_t index = SIZE_MAX;
-	bool_t slot_reused;
+/* ------------------------------------------------- */
+/* Slot functions                                    */
+/* ------------------------------------------------- */
 
-	if ((!instance) || (!instance->data.items))
+static FORCE_INLINE size_t slot_count(const hash_data_t *const data)
+{
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_CUCKOO:
+		return data->capacity + STASH_SIZE;
+	case HASHSET_ENGINE_SENTINEL:
+		return data->capacity + 2U;
+	default:
+		return data->capacity;
 	}
+}
 
-	if (find_slot(&instance->data, instance->basis, item, &index, &slot_reused))
+static FORCE_INLINE bool_t find_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item, size_t *const index_out, bool_t *const reused_out)
+{
+	switch (data->engine)
 	{
-		return EEXIST;
+	case HASHSET_ENGINE_SWISS:
+		return swiss_find_slot(data, param, hash, item, index_out, reused_out);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_find_slot(data, hash, item, index_out, reused_out);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_find_slot(data, hash, item, index_out, reused_out);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_find_slot(data, param, hash, item, index_out, reused_out);
+	default:
+		return bitmap_find_slot(data, param, hash, item, index_out, reused_out);
 	}
+}
 
-	if ((!slot_reused) && (safe_add(instance->valid, instance->deleted) >= instance->limit))
+/* prefetches the slots that will be examined first when looking up an item with the given hash */
+static FORCE_INLINE void prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	switch (data->engine)
 	{
-		if (instance->data.capacity < SIZE_MAX)
-		{
-			const errno_t error = rebuild_set(instance, safe_times2(instance->data.capacity));
-			if (error)
-			{
-				return error;
-			}
-			if (find_slot(&instance->data, instance->basis, item, &index, &slot_reused))
-			{
-				return EFAULT;
-			}
-		}
-		else
-		{
-			return EFBIG; /*can not grow any futher!*/
-		}
+	case HASHSET_ENGINE_SWISS:
+		swiss_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		cuckoo_prefetch_slot(data, hash);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_prefetch_slot(data, hash);
+		break;
+	default:
+		bitmap_prefetch_slot(data, hash);
 	}
+}
 
-	put_item(&instance->data, index, item, slot_reused);
-
-	instance->valid = safe_incr(instance->valid);
-	if (slot_reused)
+/* returns FALSE, if the item can not be stored without growing the table first */
+static FORCE_INLINE bool_t put_item(hash_data_t *const data, const hash_param_t *const param, const size_t index, const uint64_t hash, const value_t item, const bool_t reusing)
+{
+	switch (data->engine)
 	{
-		instance->deleted = safe_decr(instance->deleted);
+	case HASHSET_ENGINE_SWISS:
+		swiss_put_item(data, index, hash, item);
+		return TRUE;
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_put_item(data, index, hash, item);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_put_item(data, param, index, hash, item);
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_put_item(data, index, item);
+		return TRUE;
+	default:
+		bitmap_put_item(data, index, item, reusing);
+		return TRUE;
 	}
-
-	return 0;
 }
 
-errno_t DECLARE(hash_set_contains)(const hash_set_t *const instance, const value_t item)
+/* returns TRUE, if the slot was turned into a "deleted" slot, or FALSE, if the slot was turned into an "unused" slot */
+static FORCE_INLINE bool_t erase_item(hash_data_t *const data, const size_t index)
 {
-	if ((!instance) || (!instance->data.items))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		return swiss_erase_item(data, index);
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_erase_item(data, index);
+		return FALSE;
+	case HASHSET_ENGINE_CUCKOO:
+		clear_flag(data->used, index);
+		return FALSE;
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_erase_item(data, index);
+	default:
+		set_flag(data->deleted, index);
+		return TRUE;
 	}
-
-	return (instance->valid && find_slot(&instance->data, instance->basis, item, NULL, NULL)) ? 0 : ENOENT;
 }
 
-errno_t DECLARE(hash_set_remove)(hash_set_t *const instance, const value_t item)
+static FORCE_INLINE bool_t is_valid(const hash_data_t *const data, const size_t index)
 {
-	size_t index;
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		return IS_FULL(data->ctrl[index]);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return (data->dist[index] != DIST_EMPTY);
+	case HASHSET_ENGINE_CUCKOO:
+		return get_flag(data->used, index);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_is_valid(data, index);
+	default:
+		return IS_VALID(*data, index);
+	}
+}
 
-	if ((!instance) || (!instance->data.items))
+/* returns the index of the first valid slot at or after the given index, or the count (at most the slot count), if there is none; empty regions are skipped a word (or a group) at a time */
+static INLINE size_t next_valid(const hash_data_t *const data, size_t index, const size_t count)
+{
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		return next_full(data->ctrl, index, count);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return next_nonzero(data->dist, index, count); /*DIST_EMPTY is zero*/
+	case HASHSET_ENGINE_CUCKOO:
+		return next_flag(data->used, NULL, index, count);
+	case HASHSET_ENGINE_SENTINEL:
+		while ((index < count) && (!sentinel_is_valid(data, index)))
+		{
+			++index;
+		}
+		return (index < count) ? index : count;
+	default:
+		return next_flag(data->used, data->deleted, index, count);
 	}
+}
 
-	if ((!instance->valid) || (!find_slot(&instance->data, instance->basis, item, &index, NULL)))
+/* copies the items from the valid slots, starting at the given index, until the buffer is full or the limit is reached; returns the index where to continue */
+static INLINE size_t copy_items(const hash_data_t *const data, size_t index, const size_t limit, value_t *const items, const size_t capacity, size_t *const total)
+{
+	while ((*total < capacity) && ((index = next_valid(data, index, limit)) < limit))
 	{
-		return ENOENT;
+		items[(*total)++] = data->items[index++];
 	}
 
-	set_flag(instance->data.deleted, index);
-	instance->deleted = safe_incr(instance->deleted);
-	instance->valid = safe_decr(instance->valid);
+	return index;
+}
 
-	if (!instance->valid)
+static INLINE char get_status(const hash_data_t *const data, const size_t index)
+{
+	switch (data->engine)
 	{
-		return DECLARE(hash_set_clear)(instance);
+	case HASHSET_ENGINE_SWISS:
+		return IS_FULL(data->ctrl[index]) ? 'v' : ((data->ctrl[index] == CTRL_DELETED) ? 'd' : 'u');
+	case HASHSET_ENGINE_ROBINHOOD:
+		return (data->dist[index] != DIST_EMPTY) ? 'v' : 'u';
+	case HASHSET_ENGINE_CUCKOO:
+		return get_flag(data->used, index) ? 'v' : 'u';
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_get_status(data, index);
+	default:
+		return get_flag(data->used, index) ? (get_flag(data->deleted, index) ? 'd' : 'v') : 'u';
 	}
+}
+
+/* the slot (or the first slot of the group/bucket) where the probe sequence for the given hash continues after the given number of steps */
+static FORCE_INLINE size_t resume_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const size_t steps)
+{
+	probe_t probe;
+	size_t first;
 
-	if (instance->deleted > (instance->limit / 2U))
+	switch (data->engine)
 	{
-		const size_t min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
-		const errno_t error = rebuild_set(instance, (instance->data.capacity > min_capacity) ? min_capacity : instance->data.capacity);
-		if (error && (error != ENOMEM))
-		{
-			return error;
-		}
+	case HASHSET_ENGINE_SWISS:
+		probe_init(&probe, param, hash >> 7, data->capacity / GROUP_SIZE);
+		probe_skip(&probe, steps, data->capacity / GROUP_SIZE);
+		return probe.index * GROUP_SIZE;
+	case HASHSET_ENGINE_ROBINHOOD:
+		return ((size_t)hash + steps) & (data->capacity - 1U);
+	case HASHSET_ENGINE_CUCKOO:
+		first = bucket_first(hash, data->capacity / BUCKET_SIZE);
+		return (steps ? bucket_other(hash, first, data->capacity / BUCKET_SIZE) : first) * BUCKET_SIZE;
+	default:
+		probe_init(&probe, param, hash, data->capacity);
+		probe_skip(&probe, steps, data->capacity);
+		return probe.index;
 	}
-
-	return 0;
 }
 
-errno_t DECLARE(hash_set_clear)(hash_set_t *const instance)
+/* bulk construction: tries to store the item without ever touching a slot outside of the given region; the number of steps is updated, if the item is deferred */
+static FORCE_INLINE place_t place_item(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item, const region_t *const region, size_t *const steps, size_t *const index_out)
 {
-	if ((!instance) || (!instance->data.items))
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		return swiss_place_item(data, param, hash, item, region, steps, index_out);
+	case HASHSET_ENGINE_ROBINHOOD:
+		return robinhood_place_item(data, hash, item, region, steps, index_out);
+	case HASHSET_ENGINE_CUCKOO:
+		return cuckoo_place_item(data, hash, item, region, steps, index_out);
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_place_item(data, param, hash, item, region, steps, index_out);
+	default:
+		return bitmap_place_item(data, param, hash, item, region, steps, index_out);
 	}
+}
 
-	if (instance->valid || instance->deleted)
+/* returns FALSE, if the required scratch memory could not be allocated */
+static INLINE bool_t purge_data(hash_data_t *const data, const hash_param_t *const param)
+{
+	switch (data->engine)
 	{
-		const size_t count = div_ceil(instance->data.capacity, 8U);
-		instance->valid = instance->deleted = 0U;
-		zero_memory(instance->data.used, count, sizeof(uint8_t));
-		zero_memory(instance->data.deleted, count, sizeof(uint8_t));
+	case HASHSET_ENGINE_SWISS:
+		swiss_purge_data(data, param);
+		return TRUE;
+	case HASHSET_ENGINE_ROBINHOOD:
+	case HASHSET_ENGINE_CUCKOO:
+		return TRUE; /*never leaves any "deleted" slots*/
+	case HASHSET_ENGINE_SENTINEL:
+		return sentinel_purge_data(data, param);
+	default:
+		bitmap_purge_data(data, param);
+		return TRUE;
 	}
-	else
+}
+
+static INLINE void clear_data(hash_data_t *const data)
+{
+	switch (data->engine)
 	{
-		return EAGAIN;
+	case HASHSET_ENGINE_SWISS:
+		swiss_clear_data(data);
+		break;
+	case HASHSET_ENGINE_ROBINHOOD:
+		robinhood_clear_data(data);
+		break;
+	case HASHSET_ENGINE_CUCKOO:
+		cuckoo_clear_data(data);
+		break;
+	case HASHSET_ENGINE_SENTINEL:
+		sentinel_clear_data(data);
+		break;
+	default:
+		bitmap_clear_data(data);
 	}
+}
+
+/* ------------------------------------------------- */
+/* Concurrent readers                                */
+/* ------------------------------------------------- */
 
-	if (instance->data.capacity > MINIMUM_CAPACITY)
+#define COLLECT_INTERVAL 256U
+
+static FORCE_INLINE bool_t find_shared(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, const value_t item)
+{
+	switch (data->engine)
 	{
-		const errno_t error = rebuild_set(instance, MINIMUM_CAPACITY);
-		if (error && (error != ENOMEM))
-		{
-			return error;
-		}
+	case HASHSET_ENGINE_SWISS:
+		return swiss_find_shared(data, param, hash, item);
+	default:
+		return bitmap_find_shared(data, param, hash, item);
 	}
-
-	return 0;
 }
 
-errno_t DECLARE(hash_set_iterate)(const hash_set_t *const instance, size_t *const cursor, value_t *const item)
+/* while readers may be looking at the table, a slot is never re-used for a different item; the "deleted" slots are only reclaimed by the next rebuild */
+static FORCE_INLINE size_t unused_slot(const hash_data_t *const data, const hash_param_t *const param, const uint64_t hash)
 {
-	size_t index;
+	switch (data->engine)
+	{
+	case HASHSET_ENGINE_SWISS:
+		return swiss_unused_slot(data, param, hash);
+	default:
+		return bitmap_unused_slot(data, param, hash);
+	}
+}
 
-	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.items))
+/* in contrast to erase_item(), the slot always becomes a "deleted" slot, so that it can not be re-used */
+static FORCE_INLINE void erase_shared(hash_data_t *const data, const size_t index)
+{
+	switch (data->engine)
 	{
-		return EINVAL;
+	case HASHSET_ENGINE_SWISS:
+		data->ctrl[index] = CTRL_DELETED;
+		break;
+	default:
+		set_flag(data->deleted, index);
 	}
+}
 
-	for (index = *cursor; index < instance->data.capacity; ++index)
+/* releases the retired tables that none of the readers can still be looking at */
+static INLINE void reclaim_shared(hash_set_t *const instance)
+{
+	const uint64_t oldest = epoch_oldest(&instance->shared->epoch);
+	snapshot_t **link = &instance->shared->retired;
+
+	while (*link)
 	{
-		if (IS_VALID(instance->data, index))
+		snapshot_t *const snapshot = *link;
+		if (snapshot->retired <= oldest)
+		{
+			*link = snapshot->next;
+			free_data(&snapshot->data);
+			heap_free(&instance->allocator, snapshot);
+		}
+		else
 		{
-			SAFE_SET(item, instance->data.items[index]);
-			*cursor = index + 1U;
-			return 0;
+			link = &snapshot->next;
 		}
 	}
 
-	*cursor = SIZE_MAX;
-	return ENOENT;
+	instance->collect = 0U;
 }
 
-size_t DECLARE(hash_set_size)(const hash_set_t *const instance)
+/* a reader that is still busy blocks the reclamation of the previous table, so another attempt is made every COLLECT_INTERVAL operations */
+static FORCE_INLINE void collect_shared(hash_set_t *const instance)
 {
-	return instance ? instance->valid : 0U;
+	if (instance->shared && instance->shared->retired && (++instance->collect >= COLLECT_INTERVAL))
+	{
+		reclaim_shared(instance);
+	}
 }
 
-errno_t DECLARE(hash_set_info)(const hash_set_t *const instance, size_t *const capacity, size_t *const valid, size_t *const deleted, size_t *const limit)
+/* makes the given table the current table; with concurrent readers, the previous table is retired instead of being released immediately */
+static INLINE bool_t replace_data(hash_set_t *const instance, const hash_data_t *const data)
 {
-	if ((!instance) || (!instance->data.items))
+	if (instance->shared)
 	{
-		return EINVAL;
+		snapshot_t *const previous = instance->shared->current;
+		snapshot_t *const snapshot = (snapshot_t*) heap_calloc(&instance->allocator, 1U, sizeof(snapshot_t));
+		if (!snapshot)
+		{
+			return FALSE;
+		}
+		snapshot->data = *data;
+		atomic_store_ptr((void *volatile*)&instance->shared->current, snapshot);
+		previous->retired = epoch_advance(&instance->shared->epoch);
+		previous->next = instance->shared->retired;
+		instance->shared->retired = previous;
+		reclaim_shared(instance);
+	}
+	else
+	{
+		free_data(&instance->data);
 	}
 
-	SAFE_SET(capacity, instance->data.capacity);
-	SAFE_SET(valid, instance->valid);
-	SAFE_SET(deleted, instance->deleted);
-	SAFE_SET(limit, instance->limit);
-
-	return 0;
+	instance->data = *data;
+	return TRUE;
 }
 
-HASHSET_API errno_t DECLARE(hash_set_dump)(const hash_set_t *const instance, const hash_set_callback_t callback)
+/* returns FALSE, if the engine does not support concurrent readers, or if the shared state could not be allocated */
+static INLINE bool_t init_shared(hash_set_t *const instance)
 {
-	size_t index;
+	snapshot_t *snapshot;
 
-	if ((!instance) || (!instance->data.items) || (!callback))
+	if ((instance->data.engine != HASHSET_ENGINE_DEFAULT) && (instance->data.engine != HASHSET_ENGINE_BITMAP) && (instance->data.engine != HASHSET_ENGINE_SWISS))
 	{
-		return EINVAL;
+		return FALSE;
 	}
 
-	for (index = 0U; index < instance->data.capacity; ++index)
+	instance->shared_block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->shared = (shared_t*) alloc_block(sizeof(shared_t), &instance->shared_block);
+	if (!instance->shared)
 	{
-		if (!callback(index, get_flag(instance->data.used, index) ? (get_flag(instance->data.deleted, index) ? 'd' : 'v') : 'u', instance->data.items[index]))
-		{
-			return ECANCELED;
-		}
+		return FALSE;
+	}
+
+	snapshot = (snapshot_t*) heap_calloc(&instance->allocator, 1U, sizeof(snapshot_t));
+	if (!snapshot)
+	{
+		free_block(&instance->shared_block);
+		instance->shared = NULL;
+		return FALSE;
+	}
+
+	epoch_init(&instance->shared->epoch);
+	snapshot->data = instance->data;
+	instance->shared->current = snapshot;
+	instance->shared->hash = instance->hash;
+	instance->incremental = FALSE; /*readers only ever look at a single table*/
+
+	return TRUE;
+}
+
+/* releases all retired tables, all readers must have been detached; the current table is still owned by the instance */
+static INLINE void free_shared(hash_set_t *const instance)
+{
+	if (instance->shared)
+	{
+		while (instance->shared->retired)
+		{
+			snapshot_t *const snapshot = instance->shared->retired;
+			instance->shared->retired = snapshot->next;
+			free_data(&snapshot->data);
+			heap_free(&instance->allocator, snapshot);
+		}
+		heap_free(&instance->allocator, instance->shared->current);
+		free_block(&instance->shared_block);
+		instance->shared = NULL;
+	}
+}
+
+/* ------------------------------------------------- */
+/* Partitioned build                                 */
+/* ------------------------------------------------- */
+
+typedef struct
+{
+	hash_data_t *data;
+	const hash_data_t *source; /*NULL, if the items are taken from an array*/
+	const hash_param_t *param;
+	const value_t *items;
+	const build_ref_t *input; /*NULL in the first round, where the input positions are taken as they are*/
+	build_ref_t *order;
+	size_t *counts;
+	region_t region;
+	size_t begin, end, placed, duplicates, resumable;
+	int phase;
+}
+build_task_t;
+
+/* returns FALSE, if the input position does not hold a valid item */
+static FORCE_INLINE bool_t build_input(const build_task_t *const task, const size_t k, build_ref_t *const ref)
+{
+	if (task->input)
+	{
+		*ref = task->input[k];
+		return TRUE;
+	}
+
+	ref->index = k;
+	ref->steps = 0U;
+	return (!task->source) || is_valid(task->source, k);
+}
+
+/* the region where the probe sequence of the item continues; the items that have to be inserted sequentially are kept in the last region */
+static FORCE_INLINE size_t build_region(const build_task_t *const task, const build_ref_t *const ref)
+{
+	if (ref->steps == STEPS_SERIAL)
+	{
+		return task->region.count - 1U;
+	}
+
+	return region_of(resume_slot(task->data, task->param, hash_compute(task->param, task->items[ref->index]), ref->steps), task->region.count, task->region.unit_shift);
+}
+
+/* phase 0: count the items of each region, phase 1: sort the items by region, phase 2: place the items of one region */
+static void build_task(void *const context)
+{
+	build_task_t *const task = (build_task_t*) context;
+	size_t *const counts = task->counts + (task->region.id * task->region.count);
+	size_t k, index, deferred;
+	build_ref_t ref;
+
+	switch (task->phase)
+	{
+	case 0:
+		for (k = 0U; k < task->region.count; ++k)
+		{
+			counts[k] = 0U;
+		}
+		for (k = task->begin; k < task->end; ++k)
+		{
+			if (build_input(task, k, &ref))
+			{
+				++counts[build_region(task, &ref)];
+			}
+		}
+		break;
+	case 1:
+		for (k = task->begin; k < task->end; ++k)
+		{
+			if (build_input(task, k, &ref))
+			{
+				task->order[counts[build_region(task, &ref)]++] = ref;
+			}
+		}
+		break;
+	case 2:
+		for (k = deferred = task->begin; k < task->end; ++k)
+		{
+			ref = task->order[k];
+			if (ref.steps != STEPS_SERIAL)
+			{
+				const value_t item = task->items[ref.index];
+				switch (place_item(task->data, task->param, hash_compute(task->param, item), item, &task->region, &ref.steps, &index))
+				{
+				case PLACE_DONE:
+					++task->placed;
+					continue;
+				case PLACE_EXISTS:
+					++task->duplicates;
+					continue;
+				case PLACE_DEFER:
+					++task->resumable;
+					break;
+				default:
+					ref.steps = STEPS_SERIAL;
+				}
+			}
+			task->order[deferred++] = ref;
+		}
+		task->end = deferred;
+		break;
+	}
+}
+
+/* runs all phases on the input positions [first, last), then once more on the deferred items, for as long as enough of them can be resumed in another region; "scratch" must have room for 2 * (last - first) references, afterwards the [begin, end) range of the "order" of each task holds the items that are to be inserted sequentially */
+static INLINE void run_build(build_task_t *const tasks, const size_t threads, const size_t first, const size_t last, build_ref_t *const scratch)
+{
+	const size_t count = last - first;
+	size_t t, r, offset, round, resumable;
+	const size_t unit_shift = log2_pow2(tasks[0U].data->capacity / PARALLEL_MIN_SLOTS);
+
+	for (t = 0U; t < threads; ++t)
+	{
+		tasks[t].region.id = t;
+		tasks[t].region.count = threads;
+		tasks[t].region.unit_shift = unit_shift;
+		tasks[t].input = NULL;
+		tasks[t].begin = first + ((count / threads) * t);
+		tasks[t].end = (t + 1U < threads) ? (first + ((count / threads) * (t + 1U))) : last;
+		tasks[t].placed = tasks[t].duplicates = 0U;
+	}
+
+	for (round = 0U; ; ++round)
+	{
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].order = scratch + ((round & 1U) ? count : 0U);
+			tasks[t].phase = 0;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (r = 0U, offset = 0U; r < threads; ++r)
+		{
+			for (t = 0U; t < threads; ++t)
+			{
+				const size_t region_count = tasks[0U].counts[(t * threads) + r];
+				tasks[0U].counts[(t * threads) + r] = offset;
+				offset += region_count;
+			}
+		}
+
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].phase = 1;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (t = 0U; t < threads; ++t)
+		{
+			tasks[t].phase = 2;
+			tasks[t].begin = t ? tasks[0U].counts[((threads - 1U) * threads) + (t - 1U)] : 0U;
+			tasks[t].end = tasks[0U].counts[((threads - 1U) * threads) + t];
+			tasks[t].resumable = 0U;
+		}
+
+		run_tasks(build_task, tasks, sizeof(build_task_t), threads);
+
+		for (t = 0U, resumable = 0U; t < threads; ++t)
+		{
+			resumable += tasks[t].resumable;
+			tasks[t].input = tasks[t].order;
+		}
+
+		if (resumable < PARALLEL_MIN_DEFERRED)
+		{
+			break;
+		}
+	}
+}
+
+/* ------------------------------------------------- */
+/* Set functions                                     */
+/* ------------------------------------------------- */
+
+static INLINE size_t compute_limit(const size_t capacity, const double load_factor)
+{
+	size_t limit = round_sz(capacity * load_factor);
+
+	while (capacity && (limit >= capacity))
+	{
+		limit = safe_decr(limit);
+	}
+
+	return limit;
+}
+
+/* stores an item that is known to be absent from the table, returns ENOSPC, if the item could not be stored */
+static INLINE errno_t transfer_item(hash_data_t *const data, const hash_param_t *const param, const value_t item)
+{
+	size_t index = SIZE_MAX;
+	const uint64_t hash = hash_compute(param, item);
+
+	if (find_slot(data, param, hash, item, &index, NULL))
+	{
+		return EFAULT; /*this should never happen!*/
+	}
+
+	return put_item(data, param, index, hash, item, FALSE) ? 0 : ENOSPC;
+}
+
+/* stores all items of the source table in the target table */
+static INLINE errno_t transfer_items(const hash_data_t *const source, hash_data_t *const target, const hash_param_t *const param)
+{
+	size_t k;
+	errno_t error = 0;
+
+	for (k = 0U; (k < slot_count(source)) && (!error); ++k)
+	{
+		if (is_valid(source, k))
+		{
+			error = transfer_item(target, param, source->items[k]);
+		}
+	}
+
+	return error;
+}
+
+/* the items of the current table are partitioned by the region of the new table that contains their home slot, then each region is filled by its own thread; the current table is processed in chunks of PARALLEL_CHUNK slots, so that the scratch buffer does not grow with the table; returns ENOMEM without touching the new table, if the buffers could not be allocated */
+static INLINE errno_t transfer_parallel(const hash_set_t *const instance, hash_data_t *const target, const size_t threads)
+{
+	build_task_t tasks[MAX_THREADS];
+	const size_t count = slot_count(&instance->data), chunk = (count < PARALLEL_CHUNK) ? count : PARALLEL_CHUNK;
+	size_t first, k, t;
+	errno_t error = 0;
+	build_ref_t *order = (build_ref_t*) heap_alloc(&instance->allocator, safe_mult(chunk, 2U * sizeof(build_ref_t)));
+	size_t *counts = (size_t*) heap_calloc(&instance->allocator, threads * threads, sizeof(size_t));
+
+	if ((!order) || (!counts))
+	{
+		HEAP_FREE(&instance->allocator, counts);
+		HEAP_FREE(&instance->allocator, order);
+		return ENOMEM;
+	}
+
+	for (t = 0U; t < threads; ++t)
+	{
+		zero_memory(&tasks[t], 1U, sizeof(build_task_t));
+		tasks[t].data = target;
+		tasks[t].source = &instance->data;
+		tasks[t].param = &instance->hash;
+		tasks[t].items = instance->data.items;
+		tasks[t].counts = counts;
+	}
+
+	for (first = 0U; (first < count) && (!error); first += chunk)
+	{
+		run_build(tasks, threads, first, (count - first > chunk) ? (first + chunk) : count, order);
+
+		for (t = 0U; (t < threads) && (!error); ++t)
+		{
+			if (tasks[t].duplicates)
+			{
+				error = EFAULT; /*this should never happen!*/
+			}
+			for (k = tasks[t].begin; (k < tasks[t].end) && (!error); ++k)
+			{
+				error = transfer_item(target, &instance->hash, instance->data.items[tasks[t].order[k].index]);
+			}
+		}
+	}
+
+	HEAP_FREE(&instance->allocator, counts);
+	HEAP_FREE(&instance->allocator, order);
+	return error;
+}
+
+/* moves all items into a new table, including those that are still waiting in the old table of an incremental resize */
+static INLINE errno_t rebuild_set(hash_set_t *const instance, const size_t new_capacity)
+{
+	const size_t threads = parallel_threads(thread_count(instance->threads), instance->valid - instance->pending);
+	errno_t error = 0;
+	hash_data_t temp;
+
+	if (new_capacity < instance->valid)
+	{
+		return EINVAL;
+	}
+
+	if ((new_capacity == instance->data.capacity) && (!instance->pending) && (!instance->shared)) /*readers may still be looking at the current table*/
+	{
+		if (!purge_data(&instance->data, &instance->hash)) /*same capacity: the "deleted" slots are purged in-place*/
+		{
+			return ENOMEM;
+		}
+		instance->deleted = 0U;
+		return 0;
+	}
+
+	if (!alloc_data(&temp, instance->data.engine, instance->data.block.memory, new_capacity))
+	{
+		return ENOMEM;
+	}
+
+	if (threads > 1U)
+	{
+		error = transfer_parallel(instance, &temp, threads);
+	}
+
+	if ((threads < 2U) || (error == ENOMEM))
+	{
+		error = transfer_items(&instance->data, &temp, &instance->hash);
+	}
+
+	if ((!error) && instance->pending)
+	{
+		error = transfer_items(&instance->old, &temp, &instance->hash);
+	}
+
+	if (error)
+	{
+		free_data(&temp);
+		if (error == ENOSPC)
+		{
+			return (new_capacity < SIZE_MAX) ? rebuild_set(instance, safe_times2(new_capacity)) : EFBIG;
+		}
+		return error;
+	}
+
+	if (!replace_data(instance, &temp))
+	{
+		free_data(&temp);
+		return ENOMEM;
+	}
+
+	free_data(&instance->old);
+	instance->pending = instance->migrated = 0U;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->deleted = 0U;
+
+	return 0;
+}
+
+/* moves the items of up to "count" slots from the old table into the current table, the old table is released as soon as it has become empty */
+static INLINE errno_t migrate_set(hash_set_t *const instance, size_t count)
+{
+	for (; instance->pending && count; --count)
+	{
+		assert(instance->migrated < slot_count(&instance->old));
+		if (is_valid(&instance->old, instance->migrated))
+		{
+			const value_t item = instance->old.items[instance->migrated];
+			const uint64_t hash = hash_compute(&instance->hash, item);
+			size_t index = SIZE_MAX;
+			bool_t slot_reused = FALSE;
+			if (find_slot(&instance->data, &instance->hash, hash, item, &index, &slot_reused))
+			{
+				return EFAULT; /*this should never happen!*/
+			}
+			if (!put_item(&instance->data, &instance->hash, index, hash, item, slot_reused))
+			{
+				return (instance->data.capacity < SIZE_MAX) ? rebuild_set(instance, safe_times2(instance->data.capacity)) : EFBIG;
+			}
+			if (slot_reused)
+			{
+				instance->deleted = safe_decr(instance->deleted);
+			}
+			erase_item(&instance->old, instance->migrated); /*robinhood engine: the next item may be shifted into this slot*/
+			--instance->pending;
+		}
+		else
+		{
+			++instance->migrated;
+		}
+	}
+
+	if ((!instance->pending) && instance->old.block.addr)
+	{
+		free_data(&instance->old);
+		instance->migrated = 0U;
+	}
+
+	return 0;
+}
+
+/* switches to a new, empty table; the items of the previous table are moved over by the subsequent insert and remove operations */
+static INLINE errno_t begin_migration(hash_set_t *const instance, const size_t new_capacity)
+{
+	hash_data_t temp;
+
+	assert(!instance->pending);
+
+	if (!alloc_data(&temp, instance->data.engine, instance->data.block.memory, new_capacity))
+	{
+		return ENOMEM;
+	}
+
+	instance->old = instance->data;
+	instance->data = temp;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->pending = instance->valid;
+	instance->migrated = instance->deleted = 0U;
+
+	return migrate_set(instance, 0U);
+}
+
+static INLINE errno_t grow_set(hash_set_t *const instance, const uint64_t hash, const value_t item, size_t *const index_out, bool_t *const reused_out)
+{
+	if (instance->data.capacity < SIZE_MAX)
+	{
+		const errno_t error = (instance->incremental && (!instance->pending)) ? begin_migration(instance, safe_mult(instance->data.capacity, instance->growth)) : rebuild_set(instance, safe_mult(instance->data.capacity, instance->growth));
+		if (error)
+		{
+			return error;
+		}
+		if (find_slot(&instance->data, &instance->hash, hash, item, index_out, reused_out))
+		{
+			return EFAULT; /*this should never happen!*/
+		}
+		if (instance->shared && (*reused_out))
+		{
+			*index_out = unused_slot(&instance->data, &instance->hash, hash);
+			*reused_out = FALSE;
+		}
+		return 0;
+	}
+
+	return EFBIG; /*can not grow any futher!*/
+}
+
+static INLINE errno_t clear_set(hash_set_t *const instance)
+{
+	if (instance->shared) /*readers may still be looking at the current table, so it is replaced by an empty one*/
+	{
+		hash_data_t temp;
+		if (!alloc_data(&temp, instance->data.engine, instance->data.block.memory, ((instance->shrink == HASHSET_SHRINK_AUTO) && (instance->data.capacity > MINIMUM_CAPACITY)) ? MINIMUM_CAPACITY : instance->data.capacity))
+		{
+			return ENOMEM;
+		}
+		if (!replace_data(instance, &temp))
+		{
+			free_data(&temp);
+			return ENOMEM;
+		}
+		instance->valid = instance->deleted = 0U;
+		instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+		return 0;
+	}
+
+	instance->valid = instance->deleted = instance->pending = instance->migrated = 0U;
+	free_data(&instance->old);
+	clear_data(&instance->data);
+
+	if ((instance->shrink == HASHSET_SHRINK_AUTO) && (instance->data.capacity > MINIMUM_CAPACITY))
+	{
+		const errno_t error = rebuild_set(instance, MINIMUM_CAPACITY);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+static INLINE errno_t insert_item(hash_set_t *const instance, const uint64_t hash, const value_t item)
+{
+	size_t index = SIZE_MAX;
+	bool_t slot_reused = FALSE;
+
+	if (instance->pending)
+	{
+		const errno_t error = migrate_set(instance, MIGRATE_SLOTS);
+		if (error)
+		{
+			return error;
+		}
+		if (instance->pending && find_slot(&instance->old, &instance->hash, hash, item, NULL, NULL))
+		{
+			return EEXIST;
+		}
+	}
+
+	collect_shared(instance);
+
+	if (find_slot(&instance->data, &instance->hash, hash, item, &index, &slot_reused))
+	{
+		return EEXIST;
+	}
+
+	if (instance->shared && slot_reused)
+	{
+		index = unused_slot(&instance->data, &instance->hash, hash);
+		slot_reused = FALSE;
+	}
+
+	if ((!slot_reused) && (safe_add(instance->valid, instance->deleted) >= instance->limit))
+	{
+		const errno_t error = grow_set(instance, hash, item, &index, &slot_reused);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	while (!put_item(&instance->data, &instance->hash, index, hash, item, slot_reused))
+	{
+		const errno_t error = grow_set(instance, hash, item, &index, &slot_reused);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	instance->valid = safe_incr(instance->valid);
+	if (slot_reused)
+	{
+		instance->deleted = safe_decr(instance->deleted);
+	}
+
+	return 0;
+}
+
+static INLINE errno_t remove_item(hash_set_t *const instance, const uint64_t hash, const value_t item)
+{
+	size_t index;
+
+	if (!instance->valid)
+	{
+		return ENOENT;
+	}
+
+	if (instance->pending)
+	{
+		const errno_t error = migrate_set(instance, MIGRATE_SLOTS);
+		if (error)
+		{
+			return error;
+		}
+		if (instance->pending && find_slot(&instance->old, &instance->hash, hash, item, &index, NULL))
+		{
+			erase_item(&instance->old, index);
+			--instance->pending;
+			instance->valid = safe_decr(instance->valid);
+			return migrate_set(instance, 0U);
+		}
+	}
+
+	collect_shared(instance);
+
+	if (!find_slot(&instance->data, &instance->hash, hash, item, &index, NULL))
+	{
+		return ENOENT;
+	}
+
+	if (instance->shared)
+	{
+		erase_shared(&instance->data, index);
+		instance->deleted = safe_incr(instance->deleted);
+	}
+	else if (erase_item(&instance->data, index))
+	{
+		instance->deleted = safe_incr(instance->deleted);
+	}
+
+	instance->valid = safe_decr(instance->valid);
+	return 0;
+}
+
+/* looks up the item in the current table and, while an incremental resize is in progress, in the old table */
+static FORCE_INLINE bool_t contains_item(const hash_set_t *const instance, const uint64_t hash, const value_t item)
+{
+	return find_slot(&instance->data, &instance->hash, hash, item, NULL, NULL) || (instance->pending && find_slot(&instance->old, &instance->hash, hash, item, NULL, NULL));
+}
+
+/* to be called after items have been removed: releases the table if it has become empty, or gets rid of excess "deleted" slots */
+static INLINE errno_t compact_set(hash_set_t *const instance)
+{
+	size_t min_capacity;
+	bool_t shrink;
+
+	if (!instance->valid)
+	{
+		return clear_set(instance);
+	}
+
+	/* with a shrink threshold, the capacity is reduced as soon as the table is loaded lightly enough, otherwise only while getting rid of "deleted" slots */
+	min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
+	shrink = (instance->shrink != HASHSET_SHRINK_NEVER) && (min_capacity < instance->data.capacity) && ((instance->shrink_threshold <= 0.0) || (instance->valid < round_sz(instance->limit * instance->shrink_threshold)));
+
+	if ((instance->deleted > (instance->limit / 2U)) || (shrink && (instance->shrink_threshold > 0.0)))
+	{
+		const errno_t error = rebuild_set(instance, shrink ? min_capacity : instance->data.capacity);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/* makes sure that the given number of additional items can be inserted without a rebuild, the table is left unchanged, if the allocation fails */
+static INLINE errno_t reserve_set(hash_set_t *const instance, const size_t count)
+{
+	if (safe_add(safe_add(instance->valid, instance->deleted), count) > instance->limit)
+	{
+		const size_t min_capacity = next_pow2(round_sz(safe_add(safe_incr(instance->valid), count) / instance->load_factor));
+		const errno_t error = rebuild_set(instance, (instance->data.capacity < min_capacity) ? min_capacity : instance->data.capacity);
+		if (error && (error != ENOMEM))
+		{
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/* the slots of the item that is PREFETCH_DISTANCE positions ahead are prefetched while the current item is looked up */
+static INLINE size_t contains_batch(const hash_set_t *const instance, const value_t *const items, const size_t count, uint8_t *const found)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k, total = 0U;
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, items[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, items[k + PREFETCH_DISTANCE]));
+		}
+		if (contains_item(instance, hash, items[k]))
+		{
+			if (found)
+			{
+				set_flag(found, k);
+			}
+			++total;
+		}
+		else if (found)
+		{
+			clear_flag(found, k);
+		}
+	}
+
+	return total;
+}
+
+/* the number of items that are not present yet; the items need to be looked up only if the table would otherwise have to grow */
+static INLINE size_t missing_items(const hash_set_t *const instance, const value_t *const items, const size_t count)
+{
+	if ((!instance->valid) || (safe_add(safe_add(instance->valid, instance->deleted), count) <= instance->limit))
+	{
+		return count;
+	}
+
+	return count - contains_batch(instance, items, count, NULL);
+}
+
+/* ------------------------------------------------- */
+/* Bulk construction                                 */
+/* ------------------------------------------------- */
+
+/* items are partitioned by the table region that contains their home slot, then each region is filled by its own thread; items whose probe sequence leaves the region are handed over to the thread that owns the region where it continues, only the few that are left over are inserted sequentially afterwards; the input is processed in chunks of PARALLEL_CHUNK items */
+static INLINE errno_t build_set(hash_set_t *const instance, const value_t *const items, const size_t count, const size_t threads, const hash_duplicates_t duplicates, build_ref_t *const order, size_t *const counts)
+{
+	build_task_t tasks[MAX_THREADS];
+	size_t first, k, t, found = 0U;
+
+	for (t = 0U; t < threads; ++t)
+	{
+		zero_memory(&tasks[t], 1U, sizeof(build_task_t));
+		tasks[t].data = &instance->data;
+		tasks[t].param = &instance->hash;
+		tasks[t].items = items;
+		tasks[t].counts = counts;
+	}
+
+	for (first = 0U; first < count; first += PARALLEL_CHUNK)
+	{
+		run_build(tasks, threads, first, (count - first > PARALLEL_CHUNK) ? (first + PARALLEL_CHUNK) : count, order);
+
+		for (t = 0U; t < threads; ++t)
+		{
+			instance->valid += tasks[t].placed;
+			found += tasks[t].duplicates;
+		}
+
+		if (found && (duplicates == HASHSET_DUPLICATES_FAIL))
+		{
+			return EEXIST;
+		}
+
+		for (t = 0U; t < threads; ++t)
+		{
+			for (k = tasks[t].begin; k < tasks[t].end; ++k)
+			{
+				const value_t item = items[tasks[t].order[k].index];
+				const errno_t error = insert_item(instance, hash_compute(&instance->hash, item), item);
+				if (error && ((error != EEXIST) || (duplicates == HASHSET_DUPLICATES_FAIL)))
+				{
+					return error;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------- */
+/* Construction                                      */
+/* ------------------------------------------------- */
+
+/* applies the settings that are not a property of the table itself; the table must have been set up already */
+static INLINE void apply_options(hash_set_t *const instance, const double load_factor, const hash_options_t *const options)
+{
+	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	instance->limit = compute_limit(instance->data.capacity, instance->load_factor);
+	instance->threads = options ? options->thread_count : 0U;
+	instance->incremental = options && (options->resize == HASHSET_RESIZE_INCREMENTAL);
+	instance->growth = growth_multiplier(options ? options->growth_factor : 0.0);
+	instance->shrink = (options && (options->shrink != HASHSET_SHRINK_DEFAULT)) ? options->shrink : HASHSET_SHRINK_AUTO;
+	instance->shrink_threshold = options ? BOUND(0.0, options->shrink_threshold, 0.5) : 0.0;
+}
+
+/* initializes a zeroed instance, whose allocator has already been set up; returns FALSE, if the table could not be allocated */
+static INLINE bool_t init_instance(hash_set_t *const instance, const size_t capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options, const memory_t memory)
+{
+	if (!alloc_data(&instance->data, options ? options->engine : HASHSET_ENGINE_DEFAULT, memory, capacity))
+	{
+		return FALSE;
+	}
+
+	hash_initialize(&instance->hash, options ? options->hash_function : HASHSET_HASH_DEFAULT, options ? options->probe_strategy : HASHSET_PROBE_DEFAULT, seed);
+	apply_options(instance, load_factor, options);
+
+	return TRUE;
+}
+
+static FORCE_INLINE bool_t in_buffer(const hash_set_t *const instance)
+{
+	return (instance->allocator.context == &instance->arena);
+}
+
+/* ------------------------------------------------- */
+/* Sharding                                          */
+/* ------------------------------------------------- */
+
+/* destroys the first "count" shards, as well as the instance itself */
+static INLINE void free_shards(hash_set_concurrent_t *const instance, const size_t count)
+{
+	const hash_allocator_t allocator = instance->allocator;
+	size_t i;
+
+	for (i = 0U; i < count; ++i)
+	{
+		DECLARE(hash_set_destroy)(instance->shards[i].state.instance);
+		lock_destroy(&instance->shards[i].state.lock);
+	}
+
+	free_block(&instance->block);
+	zero_memory(instance, 1U, sizeof(hash_set_concurrent_t));
+	heap_free(&allocator, instance);
+}
+
+/* all shards share the same hash function, so that the hash value needs to be computed only once */
+static FORCE_INLINE shard_state_t *select_shard(const hash_set_concurrent_t *const instance, const uint64_t hash)
+{
+	return &instance->shards[shard_index(hash, instance->shard_count)].state;
+}
+
+/* ------------------------------------------------- */
+/* Parallel scan                                     */
+/* ------------------------------------------------- */
+
+#define SCAN_BUFFER 512U
+
+/* the cursor addresses the slots of the current table, followed by the slots of the previous table, while an incremental resize is pending */
+static FORCE_INLINE size_t cursor_limit(const hash_set_t *const instance)
+{
+	return instance->pending ? safe_add(slot_count(&instance->data), slot_count(&instance->old)) : slot_count(&instance->data);
+}
+
+/* copies the items from the valid slots in the cursor range [*cursor, end), until the buffer is full */
+static INLINE errno_t iterate_range(const hash_set_t *const instance, size_t *const cursor, const size_t end, value_t *const items, const size_t capacity, size_t *const count)
+{
+	const size_t slots = slot_count(&instance->data);
+	size_t index = *cursor, total = 0U;
+
+	if (index < slots)
+	{
+		index = copy_items(&instance->data, index, (end < slots) ? end : slots, items, capacity, &total);
+	}
+
+	if (instance->pending && (total < capacity) && (index >= slots) && (index < end))
+	{
+		index = slots + copy_items(&instance->old, index - slots, ((end - slots) < slot_count(&instance->old)) ? (end - slots) : slot_count(&instance->old), items, capacity, &total);
+	}
+
+	if (!(*count = total))
+	{
+		*cursor = SIZE_MAX;
+		return ENOENT;
+	}
+
+	*cursor = index;
+	return 0;
+}
+
+typedef struct
+{
+	const hash_set_t *instance;
+	hash_set_worker_t callback;
+	void *context;
+	volatile size_t *cancelled;
+	size_t part, begin, end;
+}
+scan_task_t;
+
+/* scans one range of the table, passing the items to the callback in chunks, until the range is exhausted or any of the callbacks has requested to stop */
+static void scan_task(void *const context)
+{
+	const scan_task_t *const task = (const scan_task_t*) context;
+	value_t items[SCAN_BUFFER];
+	size_t cursor = task->begin, count;
+
+	while ((!atomic_load_size(task->cancelled)) && (!iterate_range(task->instance, &cursor, task->end, items, SCAN_BUFFER, &count)))
+	{
+		if (!task->callback(items, count, task->part, task->context))
+		{
+			atomic_add_size(task->cancelled, 1U);
+		}
+	}
+}
+
+/* ------------------------------------------------- */
+/* Saving and loading                                */
+/* ------------------------------------------------- */
+
+static const char FILE_MAGIC[8U] = "HashSet";
+
+/* the size of each of the arrays that the engine uses for a table of the given capacity, or zero, if the engine does not use the array */
+static INLINE void array_sizes(const hash_data_t *const data, uint64_t *const sizes)
+{
+	const size_t slots = slot_count(data);
+	const bool_t bitmap = (data->engine == HASHSET_ENGINE_DEFAULT) || (data->engine == HASHSET_ENGINE_BITMAP);
+
+	sizes[ARRAY_ITEMS] = ((uint64_t)slots) * sizeof(value_t);
+	sizes[ARRAY_USED] = (bitmap || (data->engine == HASHSET_ENGINE_CUCKOO)) ? div_ceil(slots, 8U) : 0U;
+	sizes[ARRAY_DELETED] = bitmap ? div_ceil(slots, 8U) : 0U;
+	sizes[ARRAY_CTRL] = (data->engine == HASHSET_ENGINE_SWISS) ? data->capacity : 0U;
+	sizes[ARRAY_DIST] = (data->engine == HASHSET_ENGINE_ROBINHOOD) ? data->capacity : 0U;
+}
+
+static INLINE uint8_t *array_addr(const hash_data_t *const data, const size_t array)
+{
+	switch (array)
+	{
+	case ARRAY_USED:
+		return data->used;
+	case ARRAY_DELETED:
+		return data->deleted;
+	case ARRAY_CTRL:
+		return data->ctrl;
+	case ARRAY_DIST:
+		return data->dist;
+	default:
+		return (uint8_t*) data->items;
+	}
+}
+
+static INLINE void set_array(hash_data_t *const data, const size_t array, uint8_t *const addr)
+{
+	switch (array)
+	{
+	case ARRAY_USED:
+		data->used = addr;
+		break;
+	case ARRAY_DELETED:
+		data->deleted = addr;
+		break;
+	case ARRAY_CTRL:
+		data->ctrl = addr;
+		break;
+	case ARRAY_DIST:
+		data->dist = addr;
+		break;
+	default:
+		data->items = (value_t*) addr;
+	}
+}
+
+static INLINE bool_t init_header(const hash_set_t *const instance, file_header_t *const header)
+{
+	memcpy(header->magic, FILE_MAGIC, sizeof(header->magic));
+	header->version = FILE_VERSION;
+	header->endian = FILE_ENDIAN;
+	header->value_size = sizeof(value_t);
+	header->engine = (uint32_t) instance->data.engine;
+	header->escape = instance->data.escape;
+	header->hash_function = (uint32_t) instance->hash.function;
+	header->hash_probe = (uint32_t) instance->hash.probe;
+	header->hash_basis = instance->hash.basis;
+	header->hash_key = instance->hash.key;
+	header->capacity = instance->data.capacity;
+	header->valid = instance->valid;
+	header->deleted = instance->deleted;
+	header->load_factor = instance->load_factor;
+
+	array_sizes(&instance->data, header->size);
+	return layout_arrays(header);
+}
+
+/* checks that the arrays and the counters are consistent with the engine and the capacity */
+static INLINE bool_t check_table(const file_header_t *const header)
+{
+	hash_data_t data;
+	uint64_t sizes[ARRAY_COUNT];
+
+	zero_memory(&data, 1U, sizeof(hash_data_t));
+	data.engine = (hash_engine_t) header->engine;
+	data.capacity = (size_t) header->capacity;
+	array_sizes(&data, sizes);
+
+	return (!header->layout) && (header->escape <= 3U) && (!memcmp(sizes, header->size, sizeof(sizes))) && (header->valid <= slot_count(&data)) && (header->deleted <= slot_count(&data) - header->valid);
+}
+
+/* maps the table that follows the header, if requested; the table is read into newly allocated memory instead, if the file can not be mapped */
+static INLINE bool_t load_data(hash_data_t *const data, const int fd, const file_header_t *const header, const hash_load_t mode, const memory_t memory)
+{
+	uint8_t *arrays[ARRAY_COUNT];
+	uint64_t position;
+	uint8_t *base;
+	size_t array;
+
+	if ((mode == HASHSET_LOAD_MMAP) && ((position = file_position(fd)) != UINT64_MAX))
+	{
+		zero_memory(data, 1U, sizeof(hash_data_t));
+		data->block.memory = memory;
+		base = map_file(fd, position, (size_t)header->table_size, &data->block);
+		if (base && (!(((uintptr_t)base) % CACHE_LINE_SIZE)) && skip_file(fd, header->table_size))
+		{
+			data->engine = (hash_engine_t) header->engine;
+			data->capacity = (size_t) header->capacity;
+			for (array = 0U; array < ARRAY_COUNT; ++array)
+			{
+				if (header->size[array])
+				{
+					set_array(data, array, base + header->offset[array]);
+				}
+			}
+			return TRUE;
+		}
+		free_block(&data->block);
+	}
+
+	if (!alloc_data(data, (hash_engine_t) header->engine, memory, (size_t)header->capacity))
+	{
+		return FALSE;
+	}
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		arrays[array] = array_addr(data, array);
+	}
+
+	if (read_table(fd, header, arrays))
+	{
+		free_data(data);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* ------------------------------------------------- */
+/* Lock-free set                                     */
+/* ------------------------------------------------- */
+
+#include "generic_hash_set_lockfree.h"
+
+/* ========================================================================= */
+/* PUBLIC FUNCTIONS                                                          */
+/* ========================================================================= */
+
+hash_set_t *DECLARE(hash_set_create_ex)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_set_t *instance;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_set_t*) heap_calloc(allocator, 1U, sizeof(hash_set_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (!init_instance(instance, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY, load_factor, seed, options, memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator)))
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	if (options && (options->concurrency == HASHSET_CONCURRENCY_READERS) && (!init_shared(instance)))
+	{
+		free_data(&instance->data);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+hash_set_t *DECLARE(hash_set_init_in_buffer)(void *const buffer, const size_t size, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const size_t padding = buffer ? ((ARENA_ALIGN - (((uintptr_t)buffer) % ARENA_ALIGN)) % ARENA_ALIGN) : 0U;
+	hash_set_t *instance;
+	memory_t memory;
+	size_t capacity;
+
+	if ((!buffer) || (size < padding) || ((size - padding) < sizeof(hash_set_t)))
+	{
+		return NULL;
+	}
+
+	instance = (hash_set_t*) (((uint8_t*)buffer) + padding);
+	zero_memory(instance, 1U, sizeof(hash_set_t));
+	arena_init(&instance->arena, (uint8_t*)(instance + 1), ((uint8_t*)buffer) + size);
+	instance->allocator.alloc = arena_alloc;
+	instance->allocator.free = arena_free;
+	instance->allocator.context = &instance->arena;
+
+	memory = memory_config(options, HASHSET_MEMORY_HEAP, &instance->allocator);
+	memory.numa = HASHSET_NUMA_DEFAULT; /*the table is located in the buffer*/
+
+	/* the largest capacity whose table fits into the remaining space */
+	for (capacity = next_pow2((size - padding) / sizeof(value_t)); capacity >= MINIMUM_CAPACITY; capacity /= 2U)
+	{
+		if (init_instance(instance, capacity, load_factor, seed, options, memory))
+		{
+			instance->shrink = HASHSET_SHRINK_NEVER; /*memory given back to the arena can not be re-used*/
+			return instance;
+		}
+	}
+
+	zero_memory(instance, 1U, sizeof(hash_set_t));
+	return NULL;
+}
+
+hash_set_t *DECLARE(hash_set_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed)
+{
+	return DECLARE(hash_set_create_ex)(initial_capacity, load_factor, seed, NULL);
+}
+
+hash_set_t *DECLARE(hash_set_create_from_array)(const value_t *const items, const size_t count, const double load_factor, const uint64_t seed, const hash_options_t *const options, const hash_duplicates_t duplicates)
+{
+	const double effective_load = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	const size_t threads = parallel_threads(thread_count(options ? options->thread_count : 0U), count);
+	build_ref_t *order = NULL;
+	size_t *counts = NULL;
+	hash_set_t *instance;
+	errno_t error;
+
+	if ((!items) && count)
+	{
+		return NULL;
+	}
+
+	instance = DECLARE(hash_set_create_ex)(round_sz(safe_incr(count) / effective_load), load_factor, seed, options);
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (threads > 1U)
+	{
+		order = (build_ref_t*) heap_alloc(&instance->allocator, safe_mult((count < PARALLEL_CHUNK) ? count : PARALLEL_CHUNK, 2U * sizeof(build_ref_t)));
+		counts = (size_t*) heap_calloc(&instance->allocator, threads * threads, sizeof(size_t));
+	}
+
+	if (order && counts)
+	{
+		error = build_set(instance, items, count, threads, duplicates, order, counts);
+	}
+	else
+	{
+		error = DECLARE(hash_set_insert_batch)(instance, items, count, NULL);
+		if ((error == EEXIST) && (duplicates != HASHSET_DUPLICATES_FAIL))
+		{
+			error = 0;
+		}
+	}
+
+	HEAP_FREE(&instance->allocator, counts);
+	HEAP_FREE(&instance->allocator, order);
+
+	if (error)
+	{
+		DECLARE(hash_set_destroy)(instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_set_destroy)(hash_set_t *instance)
+{
+	if (instance)
+	{
+		const hash_allocator_t allocator = instance->allocator;
+		const bool_t is_in_buffer = in_buffer(instance);
+		free_shared(instance); /*the current table is released below*/
+		free_data(&instance->data);
+		free_data(&instance->old);
+		zero_memory(instance, 1U, sizeof(hash_set_t));
+		if (!is_in_buffer)
+		{
+			heap_free(&allocator, instance);
+		}
+	}
+}
+
+errno_t DECLARE(hash_set_insert)(hash_set_t *const instance, const value_t item)
+{
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	return insert_item(instance, hash_compute(&instance->hash, item), item);
+}
+
+errno_t DECLARE(hash_set_insert_batch)(hash_set_t *const instance, const value_t *const items, const size_t count, uint8_t *const inserted)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k;
+	errno_t error, result = 0;
+
+	if ((!instance) || (!instance->data.items) || ((!items) && count))
+	{
+		return EINVAL;
+	}
+
+	if (!instance->incremental) /*with incremental resizing, a single large rebuild is exactly what we want to avoid*/
+	{
+		error = reserve_set(instance, missing_items(instance, items, count));
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, items[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, items[k + PREFETCH_DISTANCE]));
+		}
+		error = insert_item(instance, hash, items[k]);
+		switch (error)
+		{
+		case 0:
+			if (inserted)
+			{
+				set_flag(inserted, k);
+			}
+			break;
+		case EEXIST:
+			if (inserted)
+			{
+				clear_flag(inserted, k);
+			}
+			result = EEXIST;
+			break;
+		default:
+			return error;
+		}
+	}
+
+	return result;
+}
+
+errno_t DECLARE(hash_set_reserve)(hash_set_t *const instance, const size_t count)
+{
+	size_t additional;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	additional = (count > instance->valid) ? (count - instance->valid) : 0U;
+
+	error = reserve_set(instance, additional);
+	if (error)
+	{
+		return error;
+	}
+
+	return (safe_add(safe_add(instance->valid, instance->deleted), additional) > instance->limit) ? ENOMEM : 0;
+}
+
+errno_t DECLARE(hash_set_shrink_to_fit)(hash_set_t *const instance)
+{
+	size_t min_capacity;
+
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	min_capacity = next_pow2(round_sz(safe_incr(instance->valid) / instance->load_factor));
+	if ((instance->data.capacity <= min_capacity) && (!instance->deleted) && (!instance->pending))
+	{
+		return 0;
+	}
+
+	return rebuild_set(instance, (instance->data.capacity < min_capacity) ? instance->data.capacity : min_capacity);
+}
+
+errno_t DECLARE(hash_set_contains)(const hash_set_t *const instance, const value_t item)
+{
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	return (instance->valid && contains_item(instance, hash_compute(&instance->hash, item), item)) ? 0 : ENOENT;
+}
+
+errno_t DECLARE(hash_set_contains_batch)(const hash_set_t *const instance, const value_t *const items, const size_t count, uint8_t *const found)
+{
+	if ((!instance) || (!instance->data.items) || ((!items) && count))
+	{
+		return EINVAL;
+	}
+
+	if (!instance->valid)
+	{
+		if (found)
+		{
+			zero_memory(found, div_ceil(count, 8U), sizeof(uint8_t));
+		}
+		return count ? ENOENT : 0;
+	}
+
+	return (contains_batch(instance, items, count, found) == count) ? 0 : ENOENT;
+}
+
+void DECLARE(hash_set_prefetch)(const hash_set_t *const instance, const value_t item)
+{
+	if (instance && instance->data.items)
+	{
+		prefetch_slot(&instance->data, hash_compute(&instance->hash, item));
+	}
+}
+
+errno_t DECLARE(hash_set_remove)(hash_set_t *const instance, const value_t item)
+{
+	errno_t error;
+
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	error = remove_item(instance, hash_compute(&instance->hash, item), item);
+	if (error)
+	{
+		return error;
+	}
+
+	return compact_set(instance);
+}
+
+errno_t DECLARE(hash_set_remove_batch)(hash_set_t *const instance, const value_t *const items, const size_t count, uint8_t *const removed)
+{
+	uint64_t hashes[PREFETCH_DISTANCE];
+	size_t k, total = 0U;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.items) || ((!items) && count))
+	{
+		return EINVAL;
+	}
+
+	for (k = 0U; (k < count) && (k < PREFETCH_DISTANCE); ++k)
+	{
+		prefetch_slot(&instance->data, hashes[k] = hash_compute(&instance->hash, items[k]));
+	}
+
+	for (k = 0U; k < count; ++k)
+	{
+		const uint64_t hash = hashes[k % PREFETCH_DISTANCE];
+		if (k + PREFETCH_DISTANCE < count)
+		{
+			prefetch_slot(&instance->data, hashes[k % PREFETCH_DISTANCE] = hash_compute(&instance->hash, items[k + PREFETCH_DISTANCE]));
+		}
+		if (!remove_item(instance, hash, items[k]))
+		{
+			if (removed)
+			{
+				set_flag(removed, k);
+			}
+			++total;
+		}
+		else if (removed)
+		{
+			clear_flag(removed, k);
+		}
+	}
+
+	if (total)
+	{
+		error = compact_set(instance);
+		if (error)
+		{
+			return error;
+		}
+	}
+
+	return (total == count) ? 0 : ENOENT;
+}
+
+errno_t DECLARE(hash_set_clear)(hash_set_t *const instance)
+{
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	if (!(instance->valid || instance->deleted))
+	{
+		return EAGAIN;
+	}
+
+	return clear_set(instance);
+}
+
+errno_t DECLARE(hash_set_iterate)(const hash_set_t *const instance, size_t *const cursor, value_t *const item)
+{
+	size_t index;
+
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	if (((index = *cursor) < slot_count(&instance->data)) && ((index = next_valid(&instance->data, index, slot_count(&instance->data))) < slot_count(&instance->data)))
+	{
+		SAFE_SET(item, instance->data.items[index]);
+		*cursor = index + 1U;
+		return 0;
+	}
+
+	if (instance->pending && ((index = next_valid(&instance->old, index - slot_count(&instance->data), slot_count(&instance->old))) < slot_count(&instance->old)))
+	{
+		SAFE_SET(item, instance->old.items[index]);
+		*cursor = slot_count(&instance->data) + index + 1U;
+		return 0;
+	}
+
+	*cursor = SIZE_MAX;
+	return ENOENT;
+}
+
+errno_t DECLARE(hash_set_iterate_batch)(const hash_set_t *const instance, size_t *const cursor, value_t *const items, const size_t capacity, size_t *const count)
+{
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.items) || (!items) || (!capacity) || (!count))
+	{
+		return EINVAL;
+	}
+
+	return iterate_range(instance, cursor, SIZE_MAX, items, capacity, count);
+}
+
+errno_t DECLARE(hash_set_split)(const hash_set_t *const instance, const size_t parts, size_t *const bounds)
+{
+	size_t k, limit;
+
+	if ((!instance) || (!instance->data.items) || (!parts) || (parts >= SIZE_MAX) || (!bounds))
+	{
+		return EINVAL;
+	}
+
+	for (k = 0U, limit = cursor_limit(instance); k < parts; ++k)
+	{
+		bounds[k] = range_begin(limit, k, parts);
+	}
+
+	bounds[parts] = limit;
+	return 0;
+}
+
+errno_t DECLARE(hash_set_iterate_range)(const hash_set_t *const instance, size_t *const cursor, const size_t end, value_t *const items, const size_t capacity, size_t *const count)
+{
+	if ((!instance) || (!cursor) || (*cursor >= SIZE_MAX) || (!instance->data.items) || (!items) || (!capacity) || (!count))
+	{
+		return EINVAL;
+	}
+
+	return iterate_range(instance, cursor, end, items, capacity, count);
+}
+
+errno_t DECLARE(hash_set_parallel_for)(const hash_set_t *const instance, const size_t threads, const hash_set_worker_t callback, void *const context)
+{
+	scan_task_t tasks[MAX_THREADS];
+	volatile size_t cancelled = 0U;
+	size_t k, limit, count;
+
+	if ((!instance) || (!instance->data.items) || (!callback))
+	{
+		return EINVAL;
+	}
+
+	limit = cursor_limit(instance);
+	count = parallel_threads(thread_count(threads), limit);
+
+	for (k = 0U; k < count; ++k)
+	{
+		tasks[k].instance = instance;
+		tasks[k].callback = callback;
+		tasks[k].context = context;
+		tasks[k].cancelled = &cancelled;
+		tasks[k].part = k;
+		tasks[k].begin = range_begin(limit, k, count);
+		tasks[k].end = (k + 1U < count) ? range_begin(limit, k + 1U, count) : limit;
+	}
+
+	run_tasks(scan_task, tasks, sizeof(scan_task_t), count);
+	return cancelled ? ECANCELED : 0;
+}
+
+size_t DECLARE(hash_set_size)(const hash_set_t *const instance)
+{
+	return instance ? instance->valid : 0U;
+}
+
+errno_t DECLARE(hash_set_info)(const hash_set_t *const instance, size_t *const capacity, size_t *const valid, size_t *const deleted, size_t *const limit)
+{
+	if ((!instance) || (!instance->data.items))
+	{
+		return EINVAL;
+	}
+
+	SAFE_SET(capacity, instance->data.capacity);
+	SAFE_SET(valid, instance->valid);
+	SAFE_SET(deleted, instance->deleted);
+	SAFE_SET(limit, instance->limit);
+
+	return 0;
+}
+
+HASHSET_API errno_t DECLARE(hash_set_dump)(const hash_set_t *const instance, const hash_set_callback_t callback)
+{
+	size_t index;
+
+	if ((!instance) || (!instance->data.items) || (!callback))
+	{
+		return EINVAL;
+	}
+
+	for (index = 0U; index < slot_count(&instance->data); ++index)
+	{
+		if (!callback(index, get_status(&instance->data, index), instance->data.items[index]))
+		{
+			return ECANCELED;
+		}
+	}
+
+	for (; instance->pending && (index - slot_count(&instance->data) < slot_count(&instance->old)); ++index)
+	{
+		if (!callback(index, get_status(&instance->old, index - slot_count(&instance->data)), instance->old.items[index - slot_count(&instance->data)]))
+		{
+			return ECANCELED;
+		}
 	}
 
 	return 0;
 }
 
+errno_t DECLARE(hash_set_save)(hash_set_t *const instance, const int fd)
+{
+	uint8_t *arrays[ARRAY_COUNT];
+	file_page_t page;
+	size_t array;
+	errno_t error;
+
+	if ((!instance) || (!instance->data.items) || (fd < 0))
+	{
+		return EINVAL;
+	}
+
+	/* a pending incremental resize is completed first, so that the file only contains a single table */
+	if (instance->pending && ((error = migrate_set(instance, SIZE_MAX)) != 0))
+	{
+		return error;
+	}
+
+	zero_memory(&page, 1U, sizeof(file_page_t));
+	if (!init_header(instance, &page.header))
+	{
+		return EFBIG;
+	}
+
+	for (array = 0U; array < ARRAY_COUNT; ++array)
+	{
+		arrays[array] = array_addr(&instance->data, array);
+	}
+
+	return write_table(fd, &page, arrays);
+}
+
+hash_set_t *DECLARE(hash_set_load)(const int fd, const hash_load_t mode, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_set_t *instance;
+	file_page_t page;
+
+	if ((fd < 0) || (!allocator_valid(allocator)))
+	{
+		return NULL;
+	}
+
+	if (read_file(fd, &page, sizeof(file_page_t)) || (!check_header(&page.header, FILE_MAGIC, sizeof(value_t))) || (!check_table(&page.header)))
+	{
+		return NULL;
+	}
+
+	instance = (hash_set_t*) heap_calloc(allocator, 1U, sizeof(hash_set_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (!load_data(&instance->data, fd, &page.header, mode, memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator)))
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	instance->data.escape = (uint8_t) page.header.escape;
+	instance->hash.function = (hash_function_t) page.header.hash_function;
+	instance->hash.probe = (hash_probe_t) page.header.hash_probe;
+	instance->hash.basis = page.header.hash_basis;
+	instance->hash.key = page.header.hash_key;
+	instance->valid = (size_t) page.header.valid;
+	instance->deleted = (size_t) page.header.deleted;
+	apply_options(instance, page.header.load_factor, options);
+
+	if (options && (options->concurrency == HASHSET_CONCURRENCY_READERS) && (!init_shared(instance)))
+	{
+		free_data(&instance->data);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+hash_set_reader_t *DECLARE(hash_set_reader_attach)(hash_set_t *const instance)
+{
+	if ((!instance) || (!instance->shared))
+	{
+		return NULL;
+	}
+
+	return (hash_set_reader_t*) epoch_attach(&instance->shared->epoch, instance->shared);
+}
+
+void DECLARE(hash_set_reader_detach)(hash_set_reader_t *const reader)
+{
+	if (reader)
+	{
+		epoch_detach((reader_slot_t*)reader);
+	}
+}
+
+errno_t DECLARE(hash_set_reader_contains)(hash_set_reader_t *const reader, const value_t item)
+{
+	reader_slot_t *const slot = (reader_slot_t*) reader;
+	const shared_t *shared;
+	const snapshot_t *snapshot;
+	bool_t found;
+
+	if (!reader)
+	{
+		return EINVAL;
+	}
+
+	shared = (const shared_t*) slot->state.owner;
+	epoch_enter((epoch_t*)&shared->epoch, slot);
+	snapshot = (const snapshot_t*) atomic_load_ptr((void *const volatile*)&shared->current);
+	found = find_shared(&snapshot->data, &shared->hash, hash_compute(&shared->hash, item), item);
+	epoch_exit(slot);
+
+	return found ? 0 : ENOENT;
+}
+
+hash_set_concurrent_t *DECLARE(hash_set_concurrent_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_set_concurrent_t *instance;
+	hash_options_t shard_options;
+	size_t capacity, i;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_set_concurrent_t*) heap_calloc(allocator, 1U, sizeof(hash_set_concurrent_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	if (options)
+	{
+		shard_options = *options;
+	}
+	else
+	{
+		zero_memory(&shard_options, 1U, sizeof(hash_options_t));
+	}
+
+	shard_options.concurrency = HASHSET_CONCURRENCY_NONE; /*each shard is protected by its own lock*/
+	shard_options.thread_count = shard_options.thread_count ? shard_options.thread_count : 1U; /*the calling threads already run in parallel*/
+
+	instance->shard_count = shard_count(shard_options.shard_count);
+	hash_initialize(&instance->hash, shard_options.hash_function, shard_options.probe_strategy, seed);
+	capacity = div_ceil((initial_capacity > 0U) ? initial_capacity : DEFAULT_CAPACITY, instance->shard_count);
+
+	instance->block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->shards = (shard_t*) alloc_block(safe_mult(instance->shard_count, sizeof(shard_t)), &instance->block);
+	if (!instance->shards)
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	for (i = 0U; i < instance->shard_count; ++i)
+	{
+		if (!lock_init(&instance->shards[i].state.lock))
+		{
+			free_shards(instance, i);
+			return NULL;
+		}
+		if (!(instance->shards[i].state.instance = DECLARE(hash_set_create_ex)(capacity, load_factor, seed, &shard_options)))
+		{
+			lock_destroy(&instance->shards[i].state.lock);
+			free_shards(instance, i);
+			return NULL;
+		}
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_set_concurrent_destroy)(hash_set_concurrent_t *const instance)
+{
+	if (instance)
+	{
+		free_shards(instance, instance->shard_count);
+	}
+}
+
+errno_t DECLARE(hash_set_concurrent_insert)(hash_set_concurrent_t *const instance, const value_t item)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	errno_t error;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, item);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	error = insert_item(shard->instance, hash, item);
+	lock_release(&shard->lock);
+
+	return error;
+}
+
+errno_t DECLARE(hash_set_concurrent_remove)(hash_set_concurrent_t *const instance, const value_t item)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	errno_t error;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, item);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	error = remove_item(shard->instance, hash, item);
+	if (!error)
+	{
+		error = compact_set(shard->instance);
+	}
+	lock_release(&shard->lock);
+
+	return error;
+}
+
+errno_t DECLARE(hash_set_concurrent_contains)(hash_set_concurrent_t *const instance, const value_t item)
+{
+	uint64_t hash;
+	shard_state_t *shard;
+	bool_t found;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	hash = hash_compute(&instance->hash, item);
+	shard = select_shard(instance, hash);
+
+	lock_acquire(&shard->lock);
+	found = shard->instance->valid && contains_item(shard->instance, hash, item);
+	lock_release(&shard->lock);
+
+	return found ? 0 : ENOENT;
+}
+
+/* the shards are cleared one after another, so items that are inserted concurrently may or may not survive */
+errno_t DECLARE(hash_set_concurrent_clear)(hash_set_concurrent_t *const instance)
+{
+	size_t i;
+	errno_t error = EAGAIN;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	for (i = 0U; i < instance->shard_count; ++i)
+	{
+		shard_state_t *const shard = &instance->shards[i].state;
+		lock_acquire(&shard->lock);
+		if (shard->instance->valid || shard->instance->deleted)
+		{
+			const errno_t result = clear_set(shard->instance);
+			if (error != ENOMEM)
+			{
+				error = result;
+			}
+		}
+		lock_release(&shard->lock);
+	}
+
+	return error;
+}
+
+size_t DECLARE(hash_set_concurrent_size)(hash_set_concurrent_t *const instance)
+{
+	size_t i, total = 0U;
+
+	if (!instance)
+	{
+		return 0U;
+	}
+
+	for (i = 0U; i < instance->shard_count; ++i)
+	{
+		shard_state_t *const shard = &instance->shards[i].state;
+		lock_acquire(&shard->lock);
+		total += shard->instance->valid;
+		lock_release(&shard->lock);
+	}
+
+	return total;
+}
+
+hash_set_lockfree_t *DECLARE(hash_set_lockfree_create)(const size_t initial_capacity, const double load_factor, const uint64_t seed, const hash_options_t *const options)
+{
+	const hash_allocator_t *const allocator = options ? options->allocator : NULL;
+	hash_set_lockfree_t *instance;
+
+	if (!allocator_valid(allocator))
+	{
+		return NULL;
+	}
+
+	instance = (hash_set_lockfree_t*) heap_calloc(allocator, 1U, sizeof(hash_set_lockfree_t));
+	if (!instance)
+	{
+		return NULL;
+	}
+
+	if (allocator)
+	{
+		instance->allocator = *allocator;
+	}
+
+	instance->load_factor = (load_factor > DBL_EPSILON) ? BOUND(0.125, load_factor, 1.0) : DEFAULT_LOADFCTR;
+	instance->growth = growth_multiplier(options ? options->growth_factor : 0.0);
+	instance->memory = memory_config(options, options ? options->memory : HASHSET_MEMORY_DEFAULT, &instance->allocator);
+	hash_initialize(&instance->hash, options ? options->hash_function : HASHSET_HASH_DEFAULT, options ? options->probe_strategy : HASHSET_PROBE_DEFAULT, seed);
+
+	instance->size_block.memory = memory_config(NULL, HASHSET_MEMORY_HEAP, &instance->allocator);
+	instance->size = (counter_t*) alloc_block(MAX_STRIPES * sizeof(counter_t), &instance->size_block);
+	if (!instance->size)
+	{
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	instance->current = lockfree_alloc_table(instance, (initial_capacity > 0U) ? next_pow2(initial_capacity) : DEFAULT_CAPACITY);
+	if (!instance->current)
+	{
+		free_block(&instance->size_block);
+		heap_free(allocator, instance);
+		return NULL;
+	}
+
+	return instance;
+}
+
+void DECLARE(hash_set_lockfree_destroy)(hash_set_lockfree_t *const instance)
+{
+	if (instance)
+	{
+		const hash_allocator_t allocator = instance->allocator;
+		lockfree_table_t *table = instance->current, *next = table->next;
+		while (next)
+		{
+			lockfree_table_t *const following = next->next;
+			lockfree_free_table(next); /*a resize that has not been completed*/
+			next = following;
+		}
+		while (table)
+		{
+			lockfree_table_t *const previous = table->previous;
+			lockfree_free_table(table);
+			table = previous;
+		}
+		free_block(&instance->size_block);
+		zero_memory(instance, 1U, sizeof(hash_set_lockfree_t));
+		heap_free(&allocator, instance);
+	}
+}
+
+errno_t DECLARE(hash_set_lockfree_insert)(hash_set_lockfree_t *const instance, const value_t item)
+{
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	if (IS_SENTINEL(item))
+	{
+		return atomic_acquire32(&instance->escape[ESCAPE_SLOT(item)]) ? 0 : EEXIST;
+	}
+
+	return lockfree_insert(instance, hash_compute(&instance->hash, item), item);
+}
+
+errno_t DECLARE(hash_set_lockfree_contains)(const hash_set_lockfree_t *const instance, const value_t item)
+{
+	bool_t found;
+
+	if (!instance)
+	{
+		return EINVAL;
+	}
+
+	if (IS_SENTINEL(item))
+	{
+		found = (atomic_load_word(&instance->escape[ESCAPE_SLOT(item)], sizeof(uint32_t)) != 0U);
+	}
+	else
+	{
+		found = lockfree_find((const lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current), &instance->hash, hash_compute(&instance->hash, item), item);
+	}
+
+	return found ? 0 : ENOENT;
+}
+
+size_t DECLARE(hash_set_lockfree_size)(const hash_set_lockfree_t *const instance)
+{
+	size_t i, total;
+
+	if (!instance)
+	{
+		return 0U;
+	}
+
+	total = (size_t)atomic_load_word(&instance->escape[0U], sizeof(uint32_t)) + (size_t)atomic_load_word(&instance->escape[1U], sizeof(uint32_t));
+
+	for (i = 0U; i < MAX_STRIPES; ++i)
+	{
+		total += atomic_load_size(&instance->size[i].value);
+	}
+
+	return total;
+}
+
 #endif /*_LIBHASHSET_GENERIC_SET_INCLUDED*/
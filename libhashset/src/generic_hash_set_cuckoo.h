@@ -0,0 +1,209 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_SET_CUCKOO_INCLUDED
+#define _LIBHASHSET_GENERIC_SET_CUCKOO_INCLUDED
+
+/*
+ * Cuckoo engine: The slots are divided into buckets of BUCKET_SIZE slots, and
+ * each item can be stored in one of exactly *two* buckets. If both buckets
+ * are full, then a breadth-first search finds the shortest sequence of items
+ * that can be moved to their respective other bucket in order to make room.
+ * The few items that can not be placed are kept in a small "stash" that is
+ * located right after the last bucket. The "used" bitmap covers the stash too.
+ */
+
+static INLINE bool_t cuckoo_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t array_size = align_size(safe_mult(capacity + STASH_SIZE, sizeof(value_t)));
+	uint8_t *block;
+
+	assert(!(capacity % (2U * BUCKET_SIZE)));
+
+	block = alloc_block(safe_add(array_size, div_ceil(capacity + STASH_SIZE, 8U)), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	data->items = (value_t*) block;
+	data->used = block + array_size;
+	return TRUE;
+}
+
+static FORCE_INLINE bool_t cuckoo_find_in_bucket(const hash_data_t *const data, const size_t bucket, const value_t item, size_t *const index_out, size_t *const free_out)
+{
+	size_t k;
+
+	for (k = bucket * BUCKET_SIZE; k < (bucket + 1U) * BUCKET_SIZE; ++k)
+	{
+		if (get_flag(data->used, k))
+		{
+			if (data->items[k] == item)
+			{
+				SAFE_SET(index_out, k);
+				return TRUE;
+			}
+		}
+		else if (*free_out == SIZE_MAX)
+		{
+			*free_out = k;
+		}
+	}
+
+	return FALSE;
+}
+
+static FORCE_INLINE void cuckoo_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	const size_t bucket_count = data->capacity / BUCKET_SIZE;
+	const size_t first = bucket_first(hash, bucket_count), other = bucket_other(hash, first, bucket_count);
+	PREFETCH(&data->used[(first * BUCKET_SIZE) / 8U]);
+	PREFETCH(&data->used[(other * BUCKET_SIZE) / 8U]);
+	PREFETCH(&data->items[first * BUCKET_SIZE]);
+	PREFETCH(&data->items[other * BUCKET_SIZE]);
+}
+
+static INLINE bool_t cuckoo_find_slot(const hash_data_t *const data, const uint64_t hash, const value_t item, size_t *const index_out, bool_t *const reused_out)
+{
+	const size_t bucket_count = data->capacity / BUCKET_SIZE;
+	const size_t first = bucket_first(hash, bucket_count), other = bucket_other(hash, first, bucket_count);
+	size_t k, free_slot = SIZE_MAX;
+
+	PREFETCH(&data->items[other * BUCKET_SIZE]);
+	SAFE_SET(reused_out, FALSE);
+
+	if (cuckoo_find_in_bucket(data, first, item, index_out, &free_slot) || cuckoo_find_in_bucket(data, other, item, index_out, &free_slot))
+	{
+		return TRUE;
+	}
+
+	if (data->used[data->capacity / 8U])
+	{
+		for (k = data->capacity; k < data->capacity + STASH_SIZE; ++k)
+		{
+			if (get_flag(data->used, k) && (data->items[k] == item))
+			{
+				SAFE_SET(index_out, k);
+				return TRUE;
+			}
+		}
+	}
+
+	/* if both buckets are full, then point to the first bucket, the item will be placed by cuckoo_put_item() */
+	SAFE_SET(index_out, (free_slot != SIZE_MAX) ? free_slot : (first * BUCKET_SIZE));
+	return FALSE;
+}
+
+static INLINE bool_t cuckoo_make_room(hash_data_t *const data, const hash_param_t *const param, const uint64_t hash, size_t *const index_out)
+{
+	const size_t bucket_count = data->capacity / BUCKET_SIZE;
+	cuckoo_node_t queue[CUCKOO_MAX_NODES];
+	size_t head, tail = 0U, k;
+
+	queue[tail].bucket = bucket_first(hash, bucket_count);
+	queue[tail].parent = UINT16_MAX;
+	queue[tail].slot = queue[tail].depth = 0U;
+	queue[tail + 1U] = queue[tail];
+	queue[tail + 1U].bucket = bucket_other(hash, queue[tail].bucket, bucket_count);
+	tail += 2U;
+
+	for (head = 0U; head < tail; ++head)
+	{
+		const cuckoo_node_t node = queue[head];
+		for (k = 0U; k < BUCKET_SIZE; ++k)
+		{
+			const size_t index = (node.bucket * BUCKET_SIZE) + k;
+			if ((!get_flag(data->used, index)) && cuckoo_check_path(queue, head))
+			{
+				size_t current = head, target = index;
+				while (queue[current].parent != UINT16_MAX)
+				{
+					const size_t source = (queue[queue[current].parent].bucket * BUCKET_SIZE) + queue[current].slot;
+					assert(get_flag(data->used, source));
+					data->items[target] = data->items[source];
+					set_flag(data->used, target);
+					clear_flag(data->used, source);
+					target = source;
+					current = queue[current].parent;
+				}
+				*index_out = target;
+				return TRUE;
+			}
+		}
+		if (node.depth < CUCKOO_MAX_DEPTH)
+		{
+			for (k = 0U; (k < BUCKET_SIZE) && (tail < CUCKOO_MAX_NODES); ++k)
+			{
+				const size_t index = (node.bucket * BUCKET_SIZE) + k;
+				queue[tail].bucket = bucket_other(hash_compute(param, data->items[index]), node.bucket, bucket_count);
+				queue[tail].parent = (uint16_t)head;
+				queue[tail].slot = (uint8_t)k;
+				queue[tail++].depth = node.depth + 1U;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+/* returns FALSE, if neither the buckets nor the stash have room for the item, in which case the table remains unchanged */
+static INLINE bool_t cuckoo_put_item(hash_data_t *const data, const hash_param_t *const param, size_t index, const uint64_t hash, const value_t item)
+{
+	if (get_flag(data->used, index) && (!cuckoo_make_room(data, param, hash, &index)))
+	{
+		for (index = data->capacity; get_flag(data->used, index); ++index)
+		{
+			if (index >= data->capacity + STASH_SIZE - 1U)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	data->items[index] = item;
+	set_flag(data->used, index);
+	return TRUE;
+}
+
+/* the first bucket is tried first, then the other bucket, if that one is inside of the region too; making room is left to the sequential insertion */
+static INLINE place_t cuckoo_place_item(hash_data_t *const data, const uint64_t hash, const value_t item, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	const size_t bucket_count = data->capacity / BUCKET_SIZE;
+	const size_t first = bucket_first(hash, bucket_count);
+	size_t k;
+
+	for (; *steps < 2U; ++(*steps))
+	{
+		const size_t bucket = (*steps) ? bucket_other(hash, first, bucket_count) : first;
+		if (!in_region(region, bucket * BUCKET_SIZE))
+		{
+			return PLACE_DEFER;
+		}
+		for (k = bucket * BUCKET_SIZE; k < (bucket + 1U) * BUCKET_SIZE; ++k)
+		{
+			if (!get_flag(data->used, k))
+			{
+				data->items[k] = item;
+				set_flag(data->used, k);
+				return PLACE_DONE;
+			}
+			if (data->items[k] == item)
+			{
+				*index_out = k;
+				return PLACE_EXISTS;
+			}
+		}
+	}
+
+	return PLACE_SERIAL;
+}
+
+static INLINE void cuckoo_clear_data(hash_data_t *const data)
+{
+	zero_memory(data->used, div_ceil(data->capacity + STASH_SIZE, 8U), sizeof(uint8_t));
+}
+
+#endif /* _LIBHASHSET_GENERIC_SET_CUCKOO_INCLUDED */
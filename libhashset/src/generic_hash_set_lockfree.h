@@ -0,0 +1,299 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_SET_LOCKFREE_INCLUDED
+#define _LIBHASHSET_GENERIC_SET_LOCKFREE_INCLUDED
+
+/*
+ * Lock-free set: Items are never removed, so a slot only ever changes from
+ * "empty" to holding an item, which is done by a single compare-and-swap on
+ * the item itself. The two sentinel values are stored "out-of-band", as flags
+ * of the instance. When the table needs to grow, all threads that access it
+ * help to migrate it to the new table, one chunk of slots at a time. Each
+ * migrated "empty" slot is sealed with the "moved" sentinel, so that no item
+ * can be inserted into the old table after its slot has been migrated. A
+ * thread that finds no chunk left to migrate does not wait for the others:
+ * it seals the probe sequence of its own item in the old table, and then
+ * inserts the item into the new table right away.
+ */
+
+#define LOCKFREE_MOVED SENTINEL_DELETED /*never stored otherwise, because nothing is ever removed*/
+#define MIGRATE_CHUNK 1024U
+
+#define LOAD_ITEM(X) ((value_t)atomic_load_word(&(X), sizeof(value_t)))
+#define SWAP_ITEM(X,Y,Z) ((value_t)atomic_cas_word(&(X), sizeof(value_t), (Y), (Z)))
+
+static INLINE lockfree_table_t *lockfree_alloc_table(const hash_set_lockfree_t *const instance, const size_t capacity)
+{
+	const size_t header_size = align_size(sizeof(lockfree_table_t));
+	lockfree_table_t *table;
+	block_t block;
+	uint8_t *addr;
+
+	block.addr = NULL;
+	block.mapped = 0U;
+	block.memory = instance->memory;
+
+	addr = alloc_block(safe_add(header_size, safe_mult(capacity, sizeof(value_t))), &block);
+	if (!addr)
+	{
+		return NULL;
+	}
+
+	table = (lockfree_table_t*) addr;
+	table->items = (volatile value_t*) (addr + header_size);
+	table->capacity = capacity;
+	table->limit = compute_limit(capacity, instance->load_factor);
+	table->stripes = stripe_count(capacity);
+	table->chunks = div_ceil(capacity, MIGRATE_CHUNK);
+	table->block = block;
+
+	return table;
+}
+
+static INLINE void lockfree_free_table(lockfree_table_t *const table)
+{
+	block_t block = table->block; /*the block contains the table itself*/
+	free_block(&block);
+}
+
+/* returns 0, if the item has been inserted, EEXIST, if the table already contains the item, or EAGAIN, if the probe sequence ran into a sealed slot */
+static INLINE errno_t lockfree_claim(lockfree_table_t *const table, const hash_param_t *const param, const uint64_t hash, const value_t item)
+{
+	probe_t probe;
+	size_t count;
+
+	for (probe_init(&probe, param, hash, table->capacity), count = 0U; count < table->capacity; probe_next(&probe, table->capacity), ++count)
+	{
+		value_t current = LOAD_ITEM(table->items[probe.index]);
+		if (current == SENTINEL_EMPTY)
+		{
+			if ((current = SWAP_ITEM(table->items[probe.index], SENTINEL_EMPTY, item)) == SENTINEL_EMPTY)
+			{
+				return 0;
+			}
+		}
+		if (current == item)
+		{
+			return EEXIST;
+		}
+		if (current == LOCKFREE_MOVED)
+		{
+			return EAGAIN;
+		}
+	}
+
+	return EAGAIN; /*the table is full*/
+}
+
+/* seals the probe sequence of the item in a table that is being migrated, so that the item can no longer be inserted into that table; returns EEXIST, if the table already contains the item */
+static INLINE errno_t lockfree_seal(lockfree_table_t *const table, const hash_param_t *const param, const uint64_t hash, const value_t item)
+{
+	probe_t probe;
+	size_t count;
+
+	for (probe_init(&probe, param, hash, table->capacity), count = 0U; count < table->capacity; probe_next(&probe, table->capacity), ++count)
+	{
+		value_t current = LOAD_ITEM(table->items[probe.index]);
+		if (current == SENTINEL_EMPTY)
+		{
+			if ((current = SWAP_ITEM(table->items[probe.index], SENTINEL_EMPTY, LOCKFREE_MOVED)) == SENTINEL_EMPTY)
+			{
+				return 0;
+			}
+		}
+		if (current == item)
+		{
+			return EEXIST;
+		}
+		if (current == LOCKFREE_MOVED)
+		{
+			return 0;
+		}
+	}
+
+	return 0; /*the table is full*/
+}
+
+/* a sealed slot means that the item, if it was inserted at all, has been inserted into the next table */
+static INLINE bool_t lockfree_find(const lockfree_table_t *table, const hash_param_t *const param, const uint64_t hash, const value_t item)
+{
+	probe_t probe;
+	size_t count;
+
+	while (table)
+	{
+		for (probe_init(&probe, param, hash, table->capacity), count = 0U; count < table->capacity; probe_next(&probe, table->capacity), ++count)
+		{
+			const value_t current = LOAD_ITEM(table->items[probe.index]);
+			if (current == item)
+			{
+				return TRUE;
+			}
+			if (current == SENTINEL_EMPTY)
+			{
+				return FALSE;
+			}
+			if (current == LOCKFREE_MOVED)
+			{
+				break;
+			}
+		}
+		table = (const lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+	}
+
+	return FALSE;
+}
+
+/* publishes a larger table, unless another thread has done so already; the old table is kept until the instance is destroyed, because other threads may still be looking at it */
+static INLINE errno_t lockfree_grow(hash_set_lockfree_t *const instance, lockfree_table_t *const table)
+{
+	lockfree_table_t *next;
+
+	if (atomic_load_ptr((void *const volatile*)&table->next))
+	{
+		return 0;
+	}
+
+	if (table->capacity > (SIZE_MAX / sizeof(value_t)) / instance->growth)
+	{
+		return EFBIG;
+	}
+
+	next = lockfree_alloc_table(instance, table->capacity * instance->growth);
+	if (!next)
+	{
+		return ENOMEM;
+	}
+
+	next->previous = table;
+	if (!atomic_cas_ptr((void *volatile*)&table->next, NULL, next))
+	{
+		lockfree_free_table(next);
+	}
+
+	return 0;
+}
+
+/* copies a migrated item into the given table; if the table is being migrated itself meanwhile, the item is passed on to the next table */
+static INLINE void lockfree_forward(hash_set_lockfree_t *const instance, lockfree_table_t *table, const uint64_t hash, const value_t item)
+{
+	for (;;)
+	{
+		lockfree_table_t *next;
+		const errno_t error = lockfree_claim(table, &instance->hash, hash, item);
+		if (error != EAGAIN)
+		{
+			if (!error)
+			{
+				atomic_add_size(&table->used[shard_index(hash, table->stripes)].value, 1U);
+			}
+			return;
+		}
+		if ((next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next)) != NULL)
+		{
+			lockfree_seal(table, &instance->hash, hash, item);
+			table = next;
+		}
+		else if (lockfree_grow(instance, table) != 0)
+		{
+			thread_yield(); /*the migration can not be undone, so it is retried until memory is available*/
+		}
+	}
+}
+
+/* makes the first table whose migration has not been completed yet the current table */
+static INLINE void lockfree_advance(hash_set_lockfree_t *const instance)
+{
+	for (;;)
+	{
+		lockfree_table_t *const table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current);
+		lockfree_table_t *const next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+		if ((!next) || (atomic_load_size(&table->migrated) < table->chunks))
+		{
+			return;
+		}
+		atomic_cas_ptr((void *volatile*)&instance->current, table, next);
+	}
+}
+
+/* migrates chunks of the table, until every chunk has been claimed by one of the helping threads */
+static INLINE void lockfree_help(hash_set_lockfree_t *const instance, lockfree_table_t *const table, lockfree_table_t *const next)
+{
+	size_t chunk, index, limit;
+
+	while ((chunk = atomic_add_size(&table->claimed, 1U) - 1U) < table->chunks)
+	{
+		limit = ((chunk + 1U) * MIGRATE_CHUNK < table->capacity) ? ((chunk + 1U) * MIGRATE_CHUNK) : table->capacity;
+		for (index = chunk * MIGRATE_CHUNK; index < limit; ++index)
+		{
+			value_t current = LOAD_ITEM(table->items[index]);
+			if (current == SENTINEL_EMPTY)
+			{
+				current = SWAP_ITEM(table->items[index], SENTINEL_EMPTY, LOCKFREE_MOVED);
+			}
+			if ((current != SENTINEL_EMPTY) && (current != LOCKFREE_MOVED))
+			{
+				lockfree_forward(instance, next, hash_compute(&instance->hash, current), current);
+			}
+		}
+		if (atomic_add_size(&table->migrated, 1U) == table->chunks)
+		{
+			lockfree_advance(instance);
+		}
+	}
+}
+
+/* a thread that finds the table being migrated helps with the remaining chunks, then seals the probe sequence of its item and moves on to the next table, without waiting for the other helpers */
+static INLINE errno_t lockfree_insert(hash_set_lockfree_t *const instance, const uint64_t hash, const value_t item)
+{
+	lockfree_table_t *table = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&instance->current);
+
+	for (;;)
+	{
+		lockfree_table_t *const next = (lockfree_table_t*) atomic_load_ptr((void *const volatile*)&table->next);
+		const size_t stripe = shard_index(hash, table->stripes);
+		errno_t error;
+
+		if (next)
+		{
+			lockfree_help(instance, table, next);
+			if ((error = lockfree_seal(table, &instance->hash, hash, item)) != 0)
+			{
+				return error;
+			}
+			table = next;
+			continue;
+		}
+
+		if (atomic_load_size(&table->used[stripe].value) >= table->limit / table->stripes)
+		{
+			if ((error = lockfree_grow(instance, table)) != 0)
+			{
+				return error;
+			}
+			continue;
+		}
+
+		error = lockfree_claim(table, &instance->hash, hash, item);
+		if (error != EAGAIN)
+		{
+			if (!error)
+			{
+				atomic_add_size(&table->used[stripe].value, 1U);
+				atomic_add_size(&instance->size[shard_index(hash, MAX_STRIPES)].value, 1U);
+			}
+			return error;
+		}
+
+		/* unless a resize has sealed the slot, the table is full */
+		if ((!atomic_load_ptr((void *const volatile*)&table->next)) && ((error = lockfree_grow(instance, table)) != 0))
+		{
+			return error;
+		}
+	}
+}
+
+#endif /* _LIBHASHSET_GENERIC_SET_LOCKFREE_INCLUDED */
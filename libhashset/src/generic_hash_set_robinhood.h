@@ -0,0 +1,137 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _LIBHASHSET_GENERIC_SET_ROBINHOOD_INCLUDED
+#define _LIBHASHSET_GENERIC_SET_ROBINHOOD_INCLUDED
+
+/*
+ * Robin Hood engine: Linear probing, where each slot stores the distance of
+ * its item from the item's "home" slot, plus one (zero means "unused"). The
+ * items of a cluster are kept ordered by their home slot, so a lookup stops
+ * as soon as it meets an item that is closer to its home than the wanted
+ * item would be. Removal shifts the subsequent items back by one slot, so
+ * there never are any "deleted" slots.
+ */
+
+static INLINE bool_t robinhood_alloc_data(hash_data_t *const data, const size_t capacity)
+{
+	const size_t array_size = align_size(safe_mult(capacity, sizeof(value_t)));
+	uint8_t *const block = alloc_block(safe_add(array_size, capacity), &data->block);
+	if (!block)
+	{
+		return FALSE;
+	}
+
+	data->items = (value_t*) block;
+	data->dist = block + array_size;
+	return TRUE;
+}
+
+static FORCE_INLINE void robinhood_prefetch_slot(const hash_data_t *const data, const uint64_t hash)
+{
+	const size_t index = ((size_t)hash) & (data->capacity - 1U);
+	PREFETCH(&data->dist[index]);
+	PREFETCH(&data->items[index]);
+}
+
+static INLINE bool_t robinhood_find_slot(const hash_data_t *const data, const uint64_t hash, const value_t item, size_t *const index_out, bool_t *const reused_out)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t index, dist;
+
+	for (index = (size_t)hash & mask, dist = 1U; data->dist[index] >= dist; index = (index + 1U) & mask, ++dist)
+	{
+		if ((data->dist[index] == dist) && (data->items[index] == item))
+		{
+			SAFE_SET(index_out, index);
+			SAFE_SET(reused_out, FALSE);
+			return TRUE;
+		}
+	}
+
+	SAFE_SET(index_out, index);
+	SAFE_SET(reused_out, FALSE);
+	return FALSE;
+}
+
+/* returns FALSE, if a probe distance would overflow, in which case the table remains unchanged */
+static INLINE bool_t robinhood_put_item(hash_data_t *const data, const size_t index, const uint64_t hash, const value_t item)
+{
+	const size_t mask = data->capacity - 1U;
+	const size_t dist = ((index - (size_t)hash) & mask) + 1U;
+	size_t last, prev;
+
+	if (dist > DIST_MAX)
+	{
+		return FALSE;
+	}
+
+	for (last = index; data->dist[last] != DIST_EMPTY; last = (last + 1U) & mask)
+	{
+		if (data->dist[last] >= DIST_MAX)
+		{
+			return FALSE;
+		}
+	}
+
+	for (; last != index; last = prev)
+	{
+		prev = (last - 1U) & mask;
+		data->items[last] = data->items[prev];
+		data->dist[last] = data->dist[prev] + 1U;
+	}
+
+	data->items[index] = item;
+	data->dist[index] = (uint8_t)dist;
+	return TRUE;
+}
+
+static INLINE void robinhood_erase_item(hash_data_t *const data, size_t index)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t next;
+
+	for (next = (index + 1U) & mask; data->dist[next] > 1U; index = next, next = (next + 1U) & mask)
+	{
+		data->items[index] = data->items[next];
+		data->dist[index] = data->dist[next] - 1U;
+	}
+
+	data->dist[index] = DIST_EMPTY;
+}
+
+/* the item is inserted in the usual way, as long as neither the probe sequence nor the run of items that needs to be shifted leaves the region */
+static INLINE place_t robinhood_place_item(hash_data_t *const data, const uint64_t hash, const value_t item, const region_t *const region, size_t *const steps, size_t *const index_out)
+{
+	const size_t mask = data->capacity - 1U;
+	size_t index, last;
+
+	for (index = ((size_t)hash + *steps) & mask; in_region(region, index); index = (index + 1U) & mask, ++(*steps))
+	{
+		if (data->dist[index] <= *steps)
+		{
+			last = index;
+			while (in_region(region, last) && (data->dist[last] != DIST_EMPTY))
+			{
+				last = (last + 1U) & mask;
+			}
+			return (in_region(region, last) && robinhood_put_item(data, index, hash, item)) ? PLACE_DONE : PLACE_SERIAL;
+		}
+		if ((data->dist[index] == *steps + 1U) && (data->items[index] == item))
+		{
+			*index_out = index;
+			return PLACE_EXISTS;
+		}
+	}
+
+	return PLACE_DEFER;
+}
+
+static INLINE void robinhood_clear_data(hash_data_t *const data)
+{
+	zero_memory(data->dist, data->capacity, sizeof(uint8_t));
+}
+
+#endif /* _LIBHASHSET_GENERIC_SET_ROBINHOOD_INCLUDED */
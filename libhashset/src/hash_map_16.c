@@ -8,6 +8,11 @@
 #define NAME_SUFFIX 16
 typedef hash_map16_t hash_map_t;
 typedef hash_map_callback16_t hash_map_callback_t;
+typedef hash_map_worker16_t hash_map_worker_t;
+typedef hash_map_accumulator16_t hash_map_accumulator_t;
+typedef hash_map_reader16_t hash_map_reader_t;
+typedef hash_map_concurrent16_t hash_map_concurrent_t;
+typedef hash_map_lockfree16_t hash_map_lockfree_t;
 typedef uint16_t value_t;
 
 #include "generic_hash_map.h"
@@ -8,6 +8,11 @@
 #define NAME_SUFFIX 32
 typedef hash_map32_t hash_map_t;
 typedef hash_map_callback32_t hash_map_callback_t;
+typedef hash_map_worker32_t hash_map_worker_t;
+typedef hash_map_accumulator32_t hash_map_accumulator_t;
+typedef hash_map_reader32_t hash_map_reader_t;
+typedef hash_map_concurrent32_t hash_map_concurrent_t;
+typedef hash_map_lockfree32_t hash_map_lockfree_t;
 typedef uint32_t value_t;
 
 #include "generic_hash_map.h"
@@ -8,6 +8,11 @@
 #define NAME_SUFFIX 64
 typedef hash_map64_t hash_map_t;
 typedef hash_map_callback64_t hash_map_callback_t;
+typedef hash_map_worker64_t hash_map_worker_t;
+typedef hash_map_accumulator64_t hash_map_accumulator_t;
+typedef hash_map_reader64_t hash_map_reader_t;
+typedef hash_map_concurrent64_t hash_map_concurrent_t;
+typedef hash_map_lockfree64_t hash_map_lockfree_t;
 typedef uint64_t value_t;
 
 #include "generic_hash_map.h"
@@ -8,6 +8,10 @@
 #define NAME_SUFFIX 16
 typedef hash_set16_t hash_set_t;
 typedef hash_set_callback16_t hash_set_callback_t;
+typedef hash_set_worker16_t hash_set_worker_t;
+typedef hash_set_reader16_t hash_set_reader_t;
+typedef hash_set_concurrent16_t hash_set_concurrent_t;
+typedef hash_set_lockfree16_t hash_set_lockfree_t;
 typedef uint16_t value_t;
 
 #include "generic_hash_set.h"
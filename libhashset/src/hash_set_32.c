@@ -8,6 +8,10 @@
 #define NAME_SUFFIX 32
 typedef hash_set32_t hash_set_t;
 typedef hash_set_callback32_t hash_set_callback_t;
+typedef hash_set_worker32_t hash_set_worker_t;
+typedef hash_set_reader32_t hash_set_reader_t;
+typedef hash_set_concurrent32_t hash_set_concurrent_t;
+typedef hash_set_lockfree32_t hash_set_lockfree_t;
 typedef uint32_t value_t;
 
 #include "generic_hash_set.h"
@@ -8,6 +8,10 @@
 #define NAME_SUFFIX 64
 typedef hash_set64_t hash_set_t;
 typedef hash_set_callback64_t hash_set_callback_t;
+typedef hash_set_worker64_t hash_set_worker_t;
+typedef hash_set_reader64_t hash_set_reader_t;
+typedef hash_set_concurrent64_t hash_set_concurrent_t;
+typedef hash_set_lockfree64_t hash_set_lockfree_t;
 typedef uint64_t value_t;
 
 #include "generic_hash_set.h"
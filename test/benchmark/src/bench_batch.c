@@ -0,0 +1,266 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define CHUNK_SIZE 65536U
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_set(const hash_engine_t engine, const uint64_t *const items, const size_t count, uint8_t *const found, double *const single, double *const batch)
+{
+	size_t i, total = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+
+	hash_set = hash_set_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; i += 2U)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		total += hash_set_contains64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*single = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	if (hash_set_contains_batch64(hash_set, items, count, found) != ENOENT)
+	{
+		hash_set_destroy64(hash_set);
+		puts("Batch operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	*batch = NANOSECONDS(clock_query() - clk_begin, count);
+	hash_set_destroy64(hash_set);
+
+	return total ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int measure_map(const hash_engine_t engine, const uint64_t *const keys, const size_t count, uint64_t *const values, uint8_t *const found, double *const single, double *const batch)
+{
+	size_t i, total = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_map64_t *hash_map;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+
+	hash_map = hash_map_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_map)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; i += 2U)
+	{
+		if (hash_map_insert64(hash_map, keys[i], (uint64_t)i, 1) == ENOMEM)
+		{
+			hash_map_destroy64(hash_map);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		total += hash_map_get64(hash_map, keys[i], &values[i]) ? 0U : 1U;
+	}
+
+	*single = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	if (hash_map_get_batch64(hash_map, keys, count, values, found) != ENOENT)
+	{
+		hash_map_destroy64(hash_map);
+		puts("Batch operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	*batch = NANOSECONDS(clock_query() - clk_begin, count);
+	hash_map_destroy64(hash_map);
+
+	return total ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int measure_update(const hash_engine_t engine, const int batch, const uint64_t *const items, const size_t count, uint8_t *const result, double *const insert, double *const remove)
+{
+	size_t i, offset;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+
+	hash_set = hash_set_create_ex64(0U, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	clk_begin = clock_query();
+	for (offset = 0U; offset < count; offset += CHUNK_SIZE)
+	{
+		const size_t chunk = ((count - offset) < CHUNK_SIZE) ? (count - offset) : CHUNK_SIZE;
+		if (batch)
+		{
+			if (hash_set_insert_batch64(hash_set, items + offset, chunk, result) == ENOMEM)
+			{
+				goto failure;
+			}
+		}
+		else
+		{
+			for (i = 0U; i < chunk; ++i)
+			{
+				if (hash_set_insert64(hash_set, items[offset + i]) == ENOMEM)
+				{
+					goto failure;
+				}
+			}
+		}
+	}
+
+	*insert = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	for (offset = 0U; offset < count; offset += CHUNK_SIZE)
+	{
+		const size_t chunk = ((count - offset) < CHUNK_SIZE) ? (count - offset) : CHUNK_SIZE;
+		if (batch)
+		{
+			if (hash_set_remove_batch64(hash_set, items + offset, chunk, result) == ENOMEM)
+			{
+				goto failure;
+			}
+		}
+		else
+		{
+			for (i = 0U; i < chunk; ++i)
+			{
+				if (hash_set_remove64(hash_set, items[offset + i]) == ENOMEM)
+				{
+					goto failure;
+				}
+			}
+		}
+	}
+
+	*remove = NANOSECONDS(clock_query() - clk_begin, count);
+
+	hash_set_destroy64(hash_set);
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(hash_set);
+	puts("Update operation has failed!");
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_batch(const size_t count)
+{
+	size_t i, k;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	uint64_t *const values = (uint64_t*) malloc(count * sizeof(uint64_t));
+	uint8_t *const found = (uint8_t*) malloc(((count + 7U) / 8U) * sizeof(uint8_t));
+	if ((!items) || (!values) || (!found))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[BATCH] %-10s %-4s %12s %12s %12s %9s\n", "engine", "type", "items", "ns/single", "ns/batch", "speed-up");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		double single, batch;
+		if (measure_set(ENGINES[k].engine, items, count, found, &single, &batch) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+		printf("[BATCH] %-10s %-4s %12zu %12.2f %12.2f %8.2fx\n", ENGINES[k].name, "set", count, single, batch, single / batch);
+		if (measure_map(ENGINES[k].engine, items, count, values, found, &single, &batch) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+		printf("[BATCH] %-10s %-4s %12zu %12.2f %12.2f %8.2fx\n", ENGINES[k].name, "map", count, single, batch, single / batch);
+		fflush(stdout);
+	}
+
+	printf("[BATCH] %-10s %-6s %12s %12s %12s %12s\n", "engine", "type", "items", "ns/insert", "ns/remove", "chunk");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		int batch;
+		for (batch = 0; batch < 2; ++batch)
+		{
+			double insert, remove;
+			if (measure_update(ENGINES[k].engine, batch, items, count, found, &insert, &remove) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+			printf("[BATCH] %-10s %-6s %12zu %12.2f %12.2f %12u\n", ENGINES[k].name, batch ? "batch" : "single", count, insert, remove, CHUNK_SIZE);
+			fflush(stdout);
+		}
+	}
+
+	free(items);
+	free(values);
+	free(found);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(items);
+	free(values);
+	free(found);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,120 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_insert(const hash_engine_t engine, const size_t threads, const uint64_t *const items, const size_t count, double *const seconds)
+{
+	size_t i;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.thread_count = threads;
+
+	clk_begin = clock_query();
+
+	hash_set = hash_set_create_ex64(0U, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+	hash_set_destroy64(hash_set);
+
+	return EXIT_SUCCESS;
+}
+
+static int measure_build(const hash_engine_t engine, const size_t threads, const uint64_t *const items, const size_t count, double *const seconds)
+{
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.thread_count = threads;
+
+	clk_begin = clock_query();
+
+	hash_set = hash_set_create_from_array64(items, count, -1.0, clock_query(), &options, HASHSET_DUPLICATES_IGNORE);
+	if (!hash_set)
+	{
+		puts("Bulk construction has failed!");
+		return EXIT_FAILURE;
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+	hash_set_destroy64(hash_set);
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_build(const size_t count)
+{
+	size_t i, k;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[BUILD] %-10s %12s %12s %12s %12s %12s\n", "engine", "items", "insert/1", "insert/n", "build/1", "build/n");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		double insert_single, insert_multi, build_single, build_multi;
+		if ((measure_insert(ENGINES[k].engine, 1U, items, count, &insert_single) != EXIT_SUCCESS) || (measure_insert(ENGINES[k].engine, 0U, items, count, &insert_multi) != EXIT_SUCCESS) ||
+			(measure_build(ENGINES[k].engine, 1U, items, count, &build_single) != EXIT_SUCCESS) || (measure_build(ENGINES[k].engine, 0U, items, count, &build_multi) != EXIT_SUCCESS))
+		{
+			free(items);
+			return EXIT_FAILURE;
+		}
+		printf("[BUILD] %-10s %12zu %12.3f %12.3f %12.3f %12.3f\n", ENGINES[k].name, count, insert_single, insert_multi, build_single, build_multi);
+		fflush(stdout);
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
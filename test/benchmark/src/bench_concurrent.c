@@ -0,0 +1,198 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+static const struct
+{
+	size_t shard_count;
+	const char *name;
+}
+SHARDS[] =
+{
+	{ 1U, "single" },
+	{ 0U, "default" }
+};
+
+#define SHARD_COUNT (sizeof(SHARDS) / sizeof(SHARDS[0U]))
+
+#define MAX_WORKERS 64U
+
+/* ========================================================================= */
+/* Threads                                                                   */
+/* ========================================================================= */
+
+typedef struct
+{
+	hash_set_concurrent64_t *hash_set;
+	const uint64_t *items;
+	size_t begin, end, failed;
+	int lookup;
+}
+worker_t;
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_thread(void *const param)
+#else
+static void *worker_thread(void *const param)
+#endif
+{
+	worker_t *const worker = (worker_t*) param;
+	size_t i;
+
+	for (i = worker->begin; i < worker->end; ++i)
+	{
+		if (worker->lookup)
+		{
+			worker->failed += hash_set_concurrent_contains64(worker->hash_set, worker->items[i]) ? 1U : 0U;
+		}
+		else
+		{
+			worker->failed += (hash_set_concurrent_insert64(worker->hash_set, worker->items[i]) == ENOMEM) ? 1U : 0U;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+/* the items are split across the worker threads, which either all insert or all look up their items */
+static int measure_workers(hash_set_concurrent64_t *const hash_set, const size_t threads, const int lookup, const uint64_t *const items, const size_t count, double *const seconds)
+{
+	worker_t workers[MAX_WORKERS];
+#if defined(_WIN32)
+	HANDLE handles[MAX_WORKERS];
+#else
+	pthread_t handles[MAX_WORKERS];
+#endif
+	size_t r, failed = 0U;
+	uint64_t clk_begin;
+
+	clk_begin = clock_query();
+
+	for (r = 0U; r < threads; ++r)
+	{
+		memset(&workers[r], 0, sizeof(worker_t));
+		workers[r].hash_set = hash_set;
+		workers[r].items = items;
+		workers[r].begin = (count / threads) * r;
+		workers[r].end = (r + 1U < threads) ? ((count / threads) * (r + 1U)) : count;
+		workers[r].lookup = lookup;
+#if defined(_WIN32)
+		if (!(handles[r] = CreateThread(NULL, 0U, worker_thread, &workers[r], 0U, NULL)))
+#else
+		if (pthread_create(&handles[r], NULL, worker_thread, &workers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < threads; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(handles[r], INFINITE);
+		CloseHandle(handles[r]);
+#else
+		pthread_join(handles[r], NULL);
+#endif
+		failed += workers[r].failed;
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+
+	if (failed)
+	{
+		puts(lookup ? "Lookup operation has failed!" : "Insert operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_concurrent(const size_t count)
+{
+	size_t i, k, threads;
+	hash_options_t options;
+	hash_set_concurrent64_t *hash_set;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[CONCURRENT] %-10s %8s %12s %12s %12s\n", "shards", "threads", "items", "insert/s", "lookup/s");
+
+	for (k = 0U; k < SHARD_COUNT; ++k)
+	{
+		for (threads = 1U; threads <= MAX_WORKERS; threads *= 2U)
+		{
+			double insert_seconds, lookup_seconds;
+
+			memset(&options, 0, sizeof(hash_options_t));
+			options.shard_count = SHARDS[k].shard_count;
+
+			hash_set = hash_set_concurrent_create64(0U, -1.0, clock_query(), &options);
+			if (!hash_set)
+			{
+				puts("Allocation has failed!");
+				goto failure;
+			}
+
+			if ((measure_workers(hash_set, threads, 0, items, count, &insert_seconds) != EXIT_SUCCESS) || (measure_workers(hash_set, threads, 1, items, count, &lookup_seconds) != EXIT_SUCCESS))
+			{
+				hash_set_concurrent_destroy64(hash_set);
+				goto failure;
+			}
+
+			printf("[CONCURRENT] %-10s %8zu %12zu %12.2f %12.2f\n", SHARDS[k].name, threads, count, count / insert_seconds, count / lookup_seconds);
+			fflush(stdout);
+
+			hash_set_concurrent_destroy64(hash_set);
+		}
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(items);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,248 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+static const char *const VARIANTS[] =
+{
+	"lockfree", "locked"
+};
+
+#define VARIANT_COUNT (sizeof(VARIANTS) / sizeof(VARIANTS[0U]))
+
+#define MAX_WORKERS 64U
+#define KEY_COUNT 65536U
+
+/* ========================================================================= */
+/* Threads                                                                   */
+/* ========================================================================= */
+
+typedef struct
+{
+	hash_map_lockfree64_t *lockfree;
+	hash_map64_t *locked;
+#if defined(_WIN32)
+	SRWLOCK *lock;
+#else
+	pthread_mutex_t *lock;
+#endif
+	const uint64_t *keys;
+	size_t begin, end, failed;
+}
+worker_t;
+
+/* the "locked" variant is the classic approach: a lookup, followed by an update of the value, both under one global lock */
+static errno_t increment_locked(worker_t *const worker, const uint64_t key)
+{
+	uint64_t value = 0U;
+	errno_t error;
+
+#if defined(_WIN32)
+	AcquireSRWLockExclusive(worker->lock);
+#else
+	pthread_mutex_lock(worker->lock);
+#endif
+
+	hash_map_get64(worker->locked, key, &value);
+	error = hash_map_insert64(worker->locked, key, value + 1U, 1);
+
+#if defined(_WIN32)
+	ReleaseSRWLockExclusive(worker->lock);
+#else
+	pthread_mutex_unlock(worker->lock);
+#endif
+
+	return error;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_thread(void *const param)
+#else
+static void *worker_thread(void *const param)
+#endif
+{
+	worker_t *const worker = (worker_t*) param;
+	size_t i;
+	errno_t error;
+
+	for (i = worker->begin; i < worker->end; ++i)
+	{
+		error = worker->lockfree ? hash_map_lockfree_fetch_add64(worker->lockfree, worker->keys[i], 1U, NULL) : increment_locked(worker, worker->keys[i]);
+		if (error && (error != EEXIST))
+		{
+			++worker->failed;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+/* the keys are split across the worker threads; afterwards, the counts must add up to the total number of keys */
+static int measure_workers(hash_map_lockfree64_t *const lockfree, hash_map64_t *const locked, const size_t threads, const uint64_t *const keys, const size_t count, double *const seconds)
+{
+	worker_t workers[MAX_WORKERS];
+#if defined(_WIN32)
+	HANDLE handles[MAX_WORKERS];
+	SRWLOCK lock = SRWLOCK_INIT;
+#else
+	pthread_t handles[MAX_WORKERS];
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+	size_t r, failed = 0U;
+	uint64_t clk_begin, key, value, total = 0U;
+
+	clk_begin = clock_query();
+
+	for (r = 0U; r < threads; ++r)
+	{
+		memset(&workers[r], 0, sizeof(worker_t));
+		workers[r].lockfree = lockfree;
+		workers[r].locked = locked;
+		workers[r].lock = &lock;
+		workers[r].keys = keys;
+		workers[r].begin = (count / threads) * r;
+		workers[r].end = (r + 1U < threads) ? ((count / threads) * (r + 1U)) : count;
+#if defined(_WIN32)
+		if (!(handles[r] = CreateThread(NULL, 0U, worker_thread, &workers[r], 0U, NULL)))
+#else
+		if (pthread_create(&handles[r], NULL, worker_thread, &workers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < threads; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(handles[r], INFINITE);
+		CloseHandle(handles[r]);
+#else
+		pthread_join(handles[r], NULL);
+#endif
+		failed += workers[r].failed;
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+
+#if !defined(_WIN32)
+	pthread_mutex_destroy(&lock);
+#endif
+
+	if (lockfree)
+	{
+		for (r = 0U; r < KEY_COUNT; ++r)
+		{
+			total += hash_map_lockfree_get64(lockfree, r, &value) ? 0U : value;
+		}
+	}
+	else
+	{
+		for (r = 0U; !hash_map_iterate64(locked, &r, &key, &value); )
+		{
+			total += value;
+		}
+	}
+
+	if (failed || (total != count))
+	{
+		puts("Update operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_counting(const size_t count)
+{
+	size_t i, k, threads;
+	random_t random;
+
+	uint64_t *const keys = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!keys)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	/* a small, skewed key space, so that most of the updates hit existing keys */
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		keys[i] = (random_next(&random) % KEY_COUNT) & (random_next(&random) % KEY_COUNT);
+	}
+
+	printf("[COUNTING] %-10s %8s %12s %12s\n", "variant", "threads", "updates", "Mupdates/s");
+
+	for (k = 0U; k < VARIANT_COUNT; ++k)
+	{
+		for (threads = 1U; threads <= MAX_WORKERS; threads *= 2U)
+		{
+			hash_map_lockfree64_t *lockfree = NULL;
+			hash_map64_t *locked = NULL;
+			double seconds;
+			int result;
+
+			if (k ? (!(locked = hash_map_create64(0U, -1.0, clock_query()))) : (!(lockfree = hash_map_lockfree_create64(0U, -1.0, clock_query(), NULL))))
+			{
+				puts("Allocation has failed!");
+				goto failure;
+			}
+
+			result = measure_workers(lockfree, locked, threads, keys, count, &seconds);
+
+			if (lockfree)
+			{
+				hash_map_lockfree_destroy64(lockfree);
+			}
+			else
+			{
+				hash_map_destroy64(locked);
+			}
+
+			if (result != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			printf("[COUNTING] %-10s %8zu %12zu %12.2f\n", VARIANTS[k], threads, count, (count / seconds) / 1000000.0);
+			fflush(stdout);
+		}
+	}
+
+	free(keys);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(keys);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const struct
+{
+	hash_engine_t engine;
+	hash_probe_t probe;
+	const char *name;
+}
+LARGE_CONFIGS[] =
+{
+	{ HASHSET_ENGINE_BITMAP,    HASHSET_PROBE_DOUBLE, "bitmap"    },
+	{ HASHSET_ENGINE_BITMAP,    HASHSET_PROBE_LINEAR, "bitmap"    },
+	{ HASHSET_ENGINE_SENTINEL,  HASHSET_PROBE_DOUBLE, "sentinel"  },
+	{ HASHSET_ENGINE_SENTINEL,  HASHSET_PROBE_LINEAR, "sentinel"  },
+	{ HASHSET_ENGINE_SWISS,     HASHSET_PROBE_DOUBLE, "swiss"     },
+	{ HASHSET_ENGINE_SWISS,     HASHSET_PROBE_LINEAR, "swiss"     },
+	{ HASHSET_ENGINE_ROBINHOOD, HASHSET_PROBE_LINEAR, "robinhood" },
+	{ HASHSET_ENGINE_CUCKOO,    HASHSET_PROBE_LINEAR, "cuckoo"    }
+};
+
+#define LARGE_CONFIG_COUNT (sizeof(LARGE_CONFIGS) / sizeof(LARGE_CONFIGS[0U]))
+
+static const double LOAD_FACTORS[] = { 0.5, 0.75, 0.875, 0.95 };
+
+#define LOAD_FACTOR_COUNT (sizeof(LOAD_FACTORS) / sizeof(LOAD_FACTORS[0U]))
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_engine(const hash_engine_t engine, const hash_probe_t probe, const double load_factor, const uint64_t *const items, const size_t count, double *const insert, double *const hit, double *const miss, double *const remove)
+{
+	size_t i, capacity, total, found = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.probe_strategy = probe;
+
+	hash_set = hash_set_create_ex64(count, load_factor, clock_query(), &options);
+	if ((!hash_set) || hash_set_info64(hash_set, &capacity, NULL, NULL, NULL))
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	total = (size_t)(capacity * load_factor) - 1U;
+	total = (total < count) ? total : count;
+
+	clk_begin = clock_query();
+	for (i = 0U; i < total; ++i)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	*insert = NANOSECONDS(clock_query() - clk_begin, total);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < total; ++i)
+	{
+		found += hash_set_contains64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*hit = NANOSECONDS(clock_query() - clk_begin, total);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < total; ++i)
+	{
+		found += hash_set_contains64(hash_set, ~items[i]) ? 0U : 1U;
+	}
+
+	*miss = NANOSECONDS(clock_query() - clk_begin, total);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < total; ++i)
+	{
+		found += hash_set_remove64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*remove = NANOSECONDS(clock_query() - clk_begin, total);
+	hash_set_destroy64(hash_set);
+
+	return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+static uint64_t *random_items(const size_t count)
+{
+	size_t i;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	return items;
+}
+
+int benchmark_engine(const size_t count)
+{
+	size_t k, l;
+	uint64_t *const items = random_items(count);
+
+	printf("[ENGINE] %-10s %6s %12s %12s %12s %12s\n", "engine", "load", "ns/insert", "ns/hit", "ns/miss", "ns/remove");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		for (l = 0U; l < LOAD_FACTOR_COUNT; ++l)
+		{
+			double insert, hit, miss, remove;
+			if (measure_engine(ENGINES[k].engine, HASHSET_PROBE_DEFAULT, LOAD_FACTORS[l], items, count, &insert, &hit, &miss, &remove) != EXIT_SUCCESS)
+			{
+				free(items);
+				return EXIT_FAILURE;
+			}
+			printf("[ENGINE] %-10s %6.3f %12.2f %12.2f %12.2f %12.2f\n", ENGINES[k].name, LOAD_FACTORS[l], insert, hit, miss, remove);
+		}
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Large tables                                                              */
+/* ========================================================================= */
+
+int benchmark_large(const size_t count)
+{
+	size_t k;
+	uint64_t *const items = random_items(count);
+
+	printf("[LARGE] %-10s %-7s %12s %12s %12s %12s %12s\n", "engine", "probe", "items", "ns/insert", "ns/hit", "ns/miss", "ns/remove");
+
+	for (k = 0U; k < LARGE_CONFIG_COUNT; ++k)
+	{
+		double insert, hit, miss, remove;
+		if (measure_engine(LARGE_CONFIGS[k].engine, LARGE_CONFIGS[k].probe, 0.75, items, count, &insert, &hit, &miss, &remove) != EXIT_SUCCESS)
+		{
+			free(items);
+			return EXIT_FAILURE;
+		}
+		printf("[LARGE] %-10s %-7s %12zu %12.2f %12.2f %12.2f %12.2f\n", LARGE_CONFIGS[k].name, (LARGE_CONFIGS[k].probe == HASHSET_PROBE_LINEAR) ? "linear" : "double", count, insert, hit, miss, remove);
+		fflush(stdout);
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
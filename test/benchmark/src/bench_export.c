@@ -0,0 +1,146 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const size_t RETAINED[] = { 1U, 16U }; /*one out of N keys is retained*/
+
+#define RETAINED_COUNT (sizeof(RETAINED) / sizeof(RETAINED[0U]))
+
+#define CHUNK_SIZE 65536U
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_export(const hash_engine_t engine, const size_t retained, const uint64_t *const keys, const size_t count, uint64_t *const key_column, uint64_t *const value_column, size_t *const size, double *const single, double *const batch)
+{
+	size_t i, cursor, chunk, total;
+	uint64_t clk_begin, key, value, checksum[2U] = { 0U, 0U };
+	hash_options_t options;
+	hash_map64_t *hash_map;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.shrink = HASHSET_SHRINK_NEVER; /*keep the table sparse*/
+
+	hash_map = hash_map_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_map)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_map_insert64(hash_map, keys[i], (uint64_t)i, 1) == ENOMEM)
+		{
+			goto failure;
+		}
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if ((i % retained) && (hash_map_remove64(hash_map, keys[i], NULL) == EFAULT))
+		{
+			goto failure;
+		}
+	}
+
+	*size = hash_map_size64(hash_map);
+
+	clk_begin = clock_query();
+	for (cursor = 0U; !hash_map_iterate64(hash_map, &cursor, &key, &value); )
+	{
+		checksum[0U] += key ^ value;
+	}
+
+	*single = NANOSECONDS(clock_query() - clk_begin, *size);
+
+	clk_begin = clock_query();
+	for (cursor = 0U, total = 0U; !hash_map_export64(hash_map, &cursor, key_column, value_column, CHUNK_SIZE, &chunk); total += chunk)
+	{
+		for (i = 0U; i < chunk; ++i)
+		{
+			checksum[1U] += key_column[i] ^ value_column[i];
+		}
+	}
+
+	*batch = NANOSECONDS(clock_query() - clk_begin, *size);
+	hash_map_destroy64(hash_map);
+
+	if ((total != *size) || (checksum[0U] != checksum[1U]))
+	{
+		puts("Checksum mismatch has been detected!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(hash_map);
+	puts("Update operation has failed!");
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_export(const size_t count)
+{
+	size_t i, k, r, size;
+	random_t random;
+
+	uint64_t *const keys = (uint64_t*) malloc(count * sizeof(uint64_t));
+	uint64_t *const key_column = (uint64_t*) malloc(CHUNK_SIZE * sizeof(uint64_t));
+	uint64_t *const value_column = (uint64_t*) malloc(CHUNK_SIZE * sizeof(uint64_t));
+	if ((!keys) || (!key_column) || (!value_column))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		keys[i] = random_next(&random);
+	}
+
+	printf("[EXPORT] %-10s %8s %12s %12s %12s %9s\n", "engine", "retained", "entries", "ns/iterate", "ns/export", "speed-up");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		for (r = 0U; r < RETAINED_COUNT; ++r)
+		{
+			double single, batch;
+			if (measure_export(ENGINES[k].engine, RETAINED[r], keys, count, key_column, value_column, &size, &single, &batch) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+			printf("[EXPORT] %-10s %6s%02zu %12zu %12.2f %12.2f %8.2fx\n", ENGINES[k].name, "1/", RETAINED[r], size, single, batch, single / batch);
+			fflush(stdout);
+		}
+	}
+
+	free(keys);
+	free(key_column);
+	free(value_column);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(keys);
+	free(key_column);
+	free(value_column);
+	return EXIT_FAILURE;
+}
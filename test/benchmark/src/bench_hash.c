@@ -0,0 +1,161 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <common.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define HASH_ROUNDS 16U
+
+static const struct
+{
+	hash_function_t function;
+	const char *name;
+}
+HASH_FUNCTIONS[] =
+{
+	{ HASHSET_HASH_FNV1A,     "FNV-1a"      },
+	{ HASHSET_HASH_MIX64,     "Mix64"       },
+	{ HASHSET_HASH_SIPHASH13, "SipHash-1-3" },
+	{ HASHSET_HASH_CRC32C,    "CRC-32C"     },
+	{ HASHSET_HASH_AESNI,     "AES-NI"      }
+};
+
+#define HASH_FUNCTION_COUNT (sizeof(HASH_FUNCTIONS) / sizeof(HASH_FUNCTIONS[0U]))
+
+/* ========================================================================= */
+/* Hash function                                                             */
+/* ========================================================================= */
+
+static uint64_t measure_hash(const hash_param_t *const param, const size_t count, double *const cycles, double *const nanosec)
+{
+	size_t i, r;
+	uint64_t value = UINT64_C(0x243F6A8885A308D3);
+	const uint64_t clk_begin = clock_query(), cyc_begin = cycles_query();
+
+	for (r = 0U; r < HASH_ROUNDS; ++r)
+	{
+		for (i = 0U; i < count; ++i)
+		{
+			value = hash_compute(param, value);
+		}
+	}
+
+	*cycles = (cycles_query() - cyc_begin) / ((double)count * HASH_ROUNDS);
+	*nanosec = ((clock_query() - clk_begin) * 1000000000.0) / ((double)clock_frequency() * count * HASH_ROUNDS);
+
+	return value;
+}
+
+/* ========================================================================= */
+/* Lookup                                                                    */
+/* ========================================================================= */
+
+static int measure_lookup(const hash_function_t function, const uint64_t *const items, const size_t count, double *const nanosec)
+{
+	size_t i, found = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.hash_function = function;
+	hash_set = hash_set_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		hash_set_insert64(hash_set, items[i]);
+	}
+
+	clk_begin = clock_query();
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (!hash_set_contains64(hash_set, items[i]))
+		{
+			++found;
+		}
+		if (!hash_set_contains64(hash_set, ~items[i]))
+		{
+			++found;
+		}
+	}
+
+	*nanosec = ((clock_query() - clk_begin) * 1000000000.0) / ((double)clock_frequency() * 2U * count);
+	hash_set_destroy64(hash_set);
+
+	if (found < count)
+	{
+		puts("Lookup has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_hash(const size_t count)
+{
+	size_t k, i;
+	uint64_t *items, checksum = 0U;
+	random_t random;
+
+	items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[HASH] %-12s %12s %12s %14s\n", "function", "cycles/hash", "ns/hash", "ns/contains");
+
+	for (k = 0U; k < HASH_FUNCTION_COUNT; ++k)
+	{
+		hash_param_t param;
+		double cycles, nanosec, lookup;
+
+		if (!hash_supported(HASH_FUNCTIONS[k].function))
+		{
+			printf("[HASH] %-12s %12s %12s %14s\n", HASH_FUNCTIONS[k].name, "n/a", "n/a", "n/a");
+			continue;
+		}
+
+		hash_initialize(&param, HASH_FUNCTIONS[k].function, HASHSET_PROBE_DEFAULT, clock_query());
+		checksum ^= measure_hash(&param, count, &cycles, &nanosec);
+
+		if (measure_lookup(HASH_FUNCTIONS[k].function, items, count, &lookup) != EXIT_SUCCESS)
+		{
+			free(items);
+			return EXIT_FAILURE;
+		}
+
+		printf("[HASH] %-12s %12.2f %12.2f %14.2f\n", HASH_FUNCTIONS[k].name, cycles, nanosec, lookup);
+	}
+
+	free(items);
+	printf("[HASH] checksum: %016" PRIX64 "\n", checksum);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_layout(const hash_engine_t engine, const hash_layout_t layout, const uint64_t *const keys, const size_t count, double *const insert, double *const hit, double *const miss)
+{
+	size_t i, found = 0U;
+	uint64_t clk_begin, value, checksum = 0U;
+	hash_options_t options;
+	hash_map64_t *hash_map;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.layout = layout;
+
+	hash_map = hash_map_create_ex64(count, 0.875, clock_query(), &options);
+	if (!hash_map)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_map_insert64(hash_map, keys[i], (uint64_t)i, 1) == ENOMEM)
+		{
+			hash_map_destroy64(hash_map);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	*insert = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		if (!hash_map_get64(hash_map, keys[i], &value))
+		{
+			checksum += value;
+			++found;
+		}
+	}
+
+	*hit = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		if (!hash_map_get64(hash_map, ~keys[i], &value))
+		{
+			checksum += value;
+		}
+	}
+
+	*miss = NANOSECONDS(clock_query() - clk_begin, count);
+	hash_map_destroy64(hash_map);
+
+	return (found && (checksum != UINT64_MAX)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_layout(const size_t count)
+{
+	size_t i, k;
+	random_t random;
+
+	uint64_t *const keys = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!keys)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		keys[i] = random_next(&random);
+	}
+
+	printf("[LAYOUT] %-10s %-6s %12s %12s %12s\n", "engine", "layout", "ns/insert", "ns/hit", "ns/miss");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		hash_layout_t layout;
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			double insert, hit, miss;
+			if (measure_layout(ENGINES[k].engine, layout, keys, count, &insert, &hit, &miss) != EXIT_SUCCESS)
+			{
+				free(keys);
+				return EXIT_FAILURE;
+			}
+			printf("[LAYOUT] %-10s %-6s %12.2f %12.2f %12.2f\n", ENGINES[k].name, (layout == HASHSET_LAYOUT_SOA) ? "soa" : "aos", insert, hit, miss);
+			fflush(stdout);
+		}
+	}
+
+	free(keys);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
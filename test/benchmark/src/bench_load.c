@@ -0,0 +1,194 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+typedef struct
+{
+	double rebuild, save, read, mmap, lookup;
+}
+timings_t;
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static hash_map64_t *build_map(const hash_options_t *const options, const uint64_t *const keys, const size_t count)
+{
+	hash_map64_t *hash_map;
+	size_t i;
+
+	hash_map = hash_map_create_ex64(0U, -1.0, clock_query(), options);
+	if (!hash_map)
+	{
+		return NULL;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_map_insert64(hash_map, keys[i], (uint64_t)i, 1) == ENOMEM)
+		{
+			hash_map_destroy64(hash_map);
+			return NULL;
+		}
+	}
+
+	return hash_map;
+}
+
+static hash_map64_t *load_map(FILE *const file, const hash_load_t mode, const hash_options_t *const options, double *const elapsed)
+{
+	hash_map64_t *hash_map;
+	uint64_t clk_begin;
+
+	fseek(file, 0L, SEEK_SET);
+	clk_begin = clock_query();
+	hash_map = hash_map_load64(fileno(file), mode, options);
+	*elapsed = MILLISECONDS(clock_query() - clk_begin);
+
+	return hash_map;
+}
+
+/* the first lookups after a memory-mapped load fault in the pages of the table */
+static int lookup_all(const hash_map64_t *const hash_map, const uint64_t *const keys, const size_t count, uint64_t *const checksum)
+{
+	uint64_t value;
+	size_t i;
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_map_get64(hash_map, keys[i], &value))
+		{
+			return EXIT_FAILURE;
+		}
+		*checksum += value;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static int measure_load(const hash_engine_t engine, const uint64_t *const keys, const size_t count, timings_t *const timings)
+{
+	uint64_t clk_begin, checksum[2U] = { 0U, 0U };
+	hash_map64_t *hash_map = NULL;
+	hash_options_t options;
+	FILE *file;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+
+	if (!(file = tmpfile()))
+	{
+		puts("Failed to create the temporary file!");
+		return EXIT_FAILURE;
+	}
+
+	clk_begin = clock_query();
+	hash_map = build_map(&options, keys, count);
+	timings->rebuild = MILLISECONDS(clock_query() - clk_begin);
+	if (!hash_map)
+	{
+		goto failure;
+	}
+
+	clk_begin = clock_query();
+	if (hash_map_save64(hash_map, fileno(file)))
+	{
+		goto failure;
+	}
+
+	timings->save = MILLISECONDS(clock_query() - clk_begin);
+	hash_map_destroy64(hash_map);
+
+	if ((!(hash_map = load_map(file, HASHSET_LOAD_READ, &options, &timings->read))) || lookup_all(hash_map, keys, count, &checksum[0U]))
+	{
+		goto failure;
+	}
+
+	hash_map_destroy64(hash_map);
+
+	if (!(hash_map = load_map(file, HASHSET_LOAD_MMAP, &options, &timings->mmap)))
+	{
+		goto failure;
+	}
+
+	clk_begin = clock_query();
+	if (lookup_all(hash_map, keys, count, &checksum[1U]))
+	{
+		goto failure;
+	}
+
+	timings->lookup = NANOSECONDS(clock_query() - clk_begin, count);
+	hash_map_destroy64(hash_map);
+	fclose(file);
+
+	if (checksum[0U] != checksum[1U])
+	{
+		puts("Checksum mismatch has been detected!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+
+failure:
+	if (hash_map)
+	{
+		hash_map_destroy64(hash_map);
+	}
+	fclose(file);
+	puts("Save or load operation has failed!");
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_load(const size_t count)
+{
+	size_t i, k;
+	random_t random;
+	timings_t timings;
+
+	uint64_t *const keys = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!keys)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		keys[i] = random_next(&random);
+	}
+
+	printf("[LOAD] %-10s %12s %12s %12s %12s %12s %12s\n", "engine", "entries", "ms/rebuild", "ms/save", "ms/read", "ms/mmap", "ns/lookup");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		if (measure_load(ENGINES[k].engine, keys, count, &timings) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+		printf("[LOAD] %-10s %12zu %12.2f %12.2f %12.2f %12.2f %12.2f\n", ENGINES[k].name, count, timings.rebuild, timings.save, timings.read, timings.mmap, timings.lookup);
+		fflush(stdout);
+	}
+
+	free(keys);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(keys);
+	return EXIT_FAILURE;
+}
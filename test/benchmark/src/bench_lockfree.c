@@ -0,0 +1,209 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+static const char *const VARIANTS[] =
+{
+	"lockfree", "sharded"
+};
+
+#define VARIANT_COUNT (sizeof(VARIANTS) / sizeof(VARIANTS[0U]))
+
+#define MAX_WORKERS 64U
+#define DUPLICATES 4U
+
+/* ========================================================================= */
+/* Threads                                                                   */
+/* ========================================================================= */
+
+typedef struct
+{
+	hash_set_lockfree64_t *lockfree;
+	hash_set_concurrent64_t *sharded;
+	const uint64_t *items;
+	size_t begin, end, inserted, failed;
+}
+worker_t;
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_thread(void *const param)
+#else
+static void *worker_thread(void *const param)
+#endif
+{
+	worker_t *const worker = (worker_t*) param;
+	size_t i;
+	errno_t error;
+
+	for (i = worker->begin; i < worker->end; ++i)
+	{
+		error = worker->lockfree ? hash_set_lockfree_insert64(worker->lockfree, worker->items[i]) : hash_set_concurrent_insert64(worker->sharded, worker->items[i]);
+		if (!error)
+		{
+			++worker->inserted;
+		}
+		else if (error != EEXIST)
+		{
+			++worker->failed;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+/* the items are split across the worker threads; the number of items that have been reported as "new" must match the number of distinct items */
+static int measure_workers(hash_set_lockfree64_t *const lockfree, hash_set_concurrent64_t *const sharded, const size_t threads, const uint64_t *const items, const size_t count, double *const seconds, size_t *const inserted)
+{
+	worker_t workers[MAX_WORKERS];
+#if defined(_WIN32)
+	HANDLE handles[MAX_WORKERS];
+#else
+	pthread_t handles[MAX_WORKERS];
+#endif
+	size_t r, failed = 0U;
+	uint64_t clk_begin;
+
+	*inserted = 0U;
+	clk_begin = clock_query();
+
+	for (r = 0U; r < threads; ++r)
+	{
+		memset(&workers[r], 0, sizeof(worker_t));
+		workers[r].lockfree = lockfree;
+		workers[r].sharded = sharded;
+		workers[r].items = items;
+		workers[r].begin = (count / threads) * r;
+		workers[r].end = (r + 1U < threads) ? ((count / threads) * (r + 1U)) : count;
+#if defined(_WIN32)
+		if (!(handles[r] = CreateThread(NULL, 0U, worker_thread, &workers[r], 0U, NULL)))
+#else
+		if (pthread_create(&handles[r], NULL, worker_thread, &workers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < threads; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(handles[r], INFINITE);
+		CloseHandle(handles[r]);
+#else
+		pthread_join(handles[r], NULL);
+#endif
+		failed += workers[r].failed;
+		*inserted += workers[r].inserted;
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+
+	if (failed)
+	{
+		puts("Insert operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_lockfree(const size_t count)
+{
+	size_t i, k, threads, distinct = 0U;
+	hash_options_t options;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	/* every distinct item occurs about DUPLICATES times, in random order */
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random) % ((count / DUPLICATES) + 1U);
+	}
+
+	printf("[LOCKFREE] %-10s %8s %12s %12s %12s\n", "variant", "threads", "items", "distinct", "Mitems/s");
+
+	for (k = 0U; k < VARIANT_COUNT; ++k)
+	{
+		for (threads = 1U; threads <= MAX_WORKERS; threads *= 2U)
+		{
+			hash_set_lockfree64_t *lockfree = NULL;
+			hash_set_concurrent64_t *sharded = NULL;
+			double seconds;
+			size_t inserted;
+			int result;
+
+			memset(&options, 0, sizeof(hash_options_t));
+
+			if (k ? (!(sharded = hash_set_concurrent_create64(0U, -1.0, clock_query(), &options))) : (!(lockfree = hash_set_lockfree_create64(0U, -1.0, clock_query(), &options))))
+			{
+				puts("Allocation has failed!");
+				goto failure;
+			}
+
+			result = measure_workers(lockfree, sharded, threads, items, count, &seconds, &inserted);
+
+			if (lockfree)
+			{
+				hash_set_lockfree_destroy64(lockfree);
+			}
+			else
+			{
+				hash_set_concurrent_destroy64(sharded);
+			}
+
+			if ((result != EXIT_SUCCESS) || (distinct && (inserted != distinct)))
+			{
+				puts("Deduplication has failed!");
+				goto failure;
+			}
+
+			distinct = inserted;
+			printf("[LOCKFREE] %-10s %8zu %12zu %12zu %12.2f\n", VARIANTS[k], threads, count, inserted, (count / seconds) / 1000000.0);
+			fflush(stdout);
+		}
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(items);
+	return EXIT_FAILURE;
+}
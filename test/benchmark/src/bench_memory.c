@@ -0,0 +1,128 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const struct
+{
+	hash_memory_t memory;
+	const char *name;
+}
+MEMORY[] =
+{
+	{ HASHSET_MEMORY_HEAP,      "heap"      },
+	{ HASHSET_MEMORY_MMAP,      "mmap"      },
+	{ HASHSET_MEMORY_HUGEPAGES, "hugepages" }
+};
+
+#define MEMORY_COUNT (sizeof(MEMORY) / sizeof(MEMORY[0U]))
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_memory(const hash_engine_t engine, const hash_memory_t memory, const uint64_t *const items, const size_t count, double *const insert, double *const hit, double *const miss)
+{
+	size_t i, found = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.memory = memory;
+	options.prefault = 1;
+
+	clk_begin = clock_query();
+
+	hash_set = hash_set_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	*insert = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		found += hash_set_contains64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*hit = NANOSECONDS(clock_query() - clk_begin, count);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		found += hash_set_contains64(hash_set, ~items[i]) ? 0U : 1U;
+	}
+
+	*miss = NANOSECONDS(clock_query() - clk_begin, count);
+	hash_set_destroy64(hash_set);
+
+	return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_memory(const size_t count)
+{
+	size_t i, k, m;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[MEMORY] %-10s %-10s %12s %12s %12s %12s\n", "engine", "memory", "items", "ns/insert", "ns/hit", "ns/miss");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		for (m = 0U; m < MEMORY_COUNT; ++m)
+		{
+			double insert, hit, miss;
+			if (measure_memory(ENGINES[k].engine, MEMORY[m].memory, items, count, &insert, &hit, &miss) != EXIT_SUCCESS)
+			{
+				free(items);
+				return EXIT_FAILURE;
+			}
+			printf("[MEMORY] %-10s %-10s %12zu %12.2f %12.2f %12.2f\n", ENGINES[k].name, MEMORY[m].name, count, insert, hit, miss);
+			fflush(stdout);
+		}
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,235 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#if defined(__linux__)
+#  define _GNU_SOURCE 1
+#endif
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(__linux__)
+#  include <sched.h>
+#endif
+
+static const struct
+{
+	hash_numa_t numa;
+	const char *name;
+}
+POLICIES[] =
+{
+	{ HASHSET_NUMA_DEFAULT,     "default"     },
+	{ HASHSET_NUMA_INTERLEAVE,  "interleave"  },
+	{ HASHSET_NUMA_BIND,        "bind"        },
+	{ HASHSET_NUMA_FIRST_TOUCH, "first-touch" }
+};
+
+#define POLICY_COUNT (sizeof(POLICIES) / sizeof(POLICIES[0U]))
+
+#define MAX_NODES 64U
+#define MAX_CPUS 1024U
+
+/* ========================================================================= */
+/* Topology                                                                  */
+/* ========================================================================= */
+
+/* expands a list, such as "0-3,8", into the given array; returns the number of values */
+static size_t read_list(const char *const path, unsigned int *const values, const size_t max_count)
+{
+	size_t count = 0U;
+	unsigned int first, last;
+	int separator = ',';
+
+	FILE *const file = fopen(path, "r");
+	if (!file)
+	{
+		return 0U;
+	}
+
+	while ((separator == ',') && (fscanf(file, "%u", &first) == 1))
+	{
+		last = first;
+		separator = fgetc(file);
+		if ((separator == '-') && (fscanf(file, "%u", &last) == 1))
+		{
+			separator = fgetc(file);
+		}
+		for (; (first <= last) && (count < max_count); ++first)
+		{
+			values[count++] = first;
+		}
+	}
+
+	fclose(file);
+	return count;
+}
+
+static size_t numa_nodes(unsigned int *const nodes)
+{
+	const size_t count = read_list("/sys/devices/system/node/online", nodes, MAX_NODES);
+	if (!count)
+	{
+		nodes[0U] = 0U; /*unknown topology, assume a single node*/
+		return 1U;
+	}
+
+	return count;
+}
+
+/* restricts the calling thread to the CPUs of the given node; returns FALSE, if not supported */
+static int bind_to_node(const unsigned int node)
+{
+#if defined(__linux__)
+	char path[64U];
+	unsigned int cpus[MAX_CPUS];
+	size_t i, count;
+	cpu_set_t mask;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+	count = read_list(path, cpus, MAX_CPUS);
+	if (!count)
+	{
+		return 0;
+	}
+
+	CPU_ZERO(&mask);
+	for (i = 0U; i < count; ++i)
+	{
+		if (cpus[i] < CPU_SETSIZE)
+		{
+			CPU_SET(cpus[i], &mask);
+		}
+	}
+
+	return (sched_setaffinity(0, sizeof(cpu_set_t), &mask) == 0);
+#else
+	(void)node;
+	return 0;
+#endif
+}
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_node(const hash_set64_t *const hash_set, const unsigned int node, const uint64_t *const items, const size_t count, double *const hit, int *const pinned)
+{
+	size_t i, found = 0U;
+	uint64_t clk_begin;
+
+	*pinned = bind_to_node(node);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		found += hash_set_contains64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*hit = NANOSECONDS(clock_query() - clk_begin, count);
+
+	return (found == count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int measure_numa(const hash_numa_t numa, const char *const name, const unsigned int *const nodes, const size_t node_count, const uint64_t *const items, const size_t count)
+{
+	size_t i;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.numa = numa;
+	options.numa_node = nodes[0U];
+
+	hash_set = hash_set_create_ex64(count, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (i = 0U; i < node_count; ++i)
+	{
+		double hit;
+		int pinned;
+		if (measure_node(hash_set, nodes[i], items, count, &hit, &pinned) != EXIT_SUCCESS)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Lookup operation has failed!");
+			return EXIT_FAILURE;
+		}
+		printf("[NUMA] %-12s %6u %12zu %12.2f %12.2f%s\n", name, nodes[i], count, hit, 1000.0 / hit, pinned ? "" : " (not pinned)");
+		fflush(stdout);
+	}
+
+	hash_set_destroy64(hash_set);
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_numa(const size_t count)
+{
+	size_t i, k, node_count;
+	unsigned int nodes[MAX_NODES];
+	random_t random;
+#if defined(__linux__)
+	cpu_set_t original;
+	const int restore = (sched_getaffinity(0, sizeof(cpu_set_t), &original) == 0);
+#endif
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	node_count = numa_nodes(nodes);
+	printf("[NUMA] %-12s %6s %12s %12s %12s\n", "policy", "node", "items", "ns/hit", "Mops/s");
+
+	for (k = 0U; k < POLICY_COUNT; ++k)
+	{
+		if (measure_numa(POLICIES[k].numa, POLICIES[k].name, nodes, node_count, items, count) != EXIT_SUCCESS)
+		{
+			free(items);
+			return EXIT_FAILURE;
+		}
+#if defined(__linux__)
+		if (restore)
+		{
+			sched_setaffinity(0, sizeof(cpu_set_t), &original);
+		}
+#endif
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
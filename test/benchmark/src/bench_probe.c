@@ -0,0 +1,126 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const struct
+{
+	hash_probe_t strategy;
+	const char *name;
+}
+PROBE_STRATEGIES[] =
+{
+	{ HASHSET_PROBE_DOUBLE,    "double"    },
+	{ HASHSET_PROBE_LINEAR,    "linear"    },
+	{ HASHSET_PROBE_QUADRATIC, "quadratic" }
+};
+
+#define PROBE_STRATEGY_COUNT (sizeof(PROBE_STRATEGIES) / sizeof(PROBE_STRATEGIES[0U]))
+
+static const double LOAD_FACTORS[] = { 0.5, 0.75, 0.9 };
+
+#define LOAD_FACTOR_COUNT (sizeof(LOAD_FACTORS) / sizeof(LOAD_FACTORS[0U]))
+
+/* ========================================================================= */
+/* Lookup                                                                    */
+/* ========================================================================= */
+
+static int measure_probe(const hash_probe_t strategy, const double load_factor, const uint64_t *const items, const size_t count, double *const hit, double *const miss)
+{
+	size_t i, capacity, found = 0U;
+	uint64_t clk_begin;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.probe_strategy = strategy;
+
+	hash_set = hash_set_create_ex64(count, load_factor, clock_query(), &options);
+	if ((!hash_set) || hash_set_info64(hash_set, &capacity, NULL, NULL, NULL))
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; (i < count) && (hash_set_size64(hash_set) < (size_t)(capacity * load_factor) - 1U); ++i)
+	{
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		found += hash_set_contains64(hash_set, items[i]) ? 0U : 1U;
+	}
+
+	*hit = ((clock_query() - clk_begin) * 1000000000.0) / ((double)clock_frequency() * count);
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		found += hash_set_contains64(hash_set, ~items[i]) ? 0U : 1U;
+	}
+
+	*miss = ((clock_query() - clk_begin) * 1000000000.0) / ((double)clock_frequency() * count);
+	hash_set_destroy64(hash_set);
+
+	return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_probe(const size_t count)
+{
+	size_t k, l, i;
+	uint64_t *items;
+	random_t random;
+
+	items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[PROBE] %-10s %6s %12s %12s\n", "strategy", "load", "ns/hit", "ns/miss");
+
+	for (k = 0U; k < PROBE_STRATEGY_COUNT; ++k)
+	{
+		for (l = 0U; l < LOAD_FACTOR_COUNT; ++l)
+		{
+			double hit, miss;
+			if (measure_probe(PROBE_STRATEGIES[k].strategy, LOAD_FACTORS[l], items, count, &hit, &miss) != EXIT_SUCCESS)
+			{
+				free(items);
+				return EXIT_FAILURE;
+			}
+			printf("[PROBE] %-10s %6.2f %12.2f %12.2f\n", PROBE_STRATEGIES[k].name, LOAD_FACTORS[l], hit, miss);
+		}
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,246 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+static const struct
+{
+	hash_engine_t engine;
+	const char *name;
+}
+READER_ENGINES[] =
+{
+	{ HASHSET_ENGINE_BITMAP, "bitmap" },
+	{ HASHSET_ENGINE_SWISS,  "swiss"  }
+};
+
+#define READER_ENGINE_COUNT (sizeof(READER_ENGINES) / sizeof(READER_ENGINES[0U]))
+
+#define MAX_READERS 64U
+#define CHURN_COUNT 4096U
+
+/* ========================================================================= */
+/* Threads                                                                   */
+/* ========================================================================= */
+
+typedef struct
+{
+	hash_set64_t *hash_set;
+	const uint64_t *items;
+	size_t begin, end, missed;
+	volatile int finished;
+}
+reader_t;
+
+#if defined(_WIN32)
+static DWORD WINAPI reader_thread(void *const param)
+#else
+static void *reader_thread(void *const param)
+#endif
+{
+	reader_t *const reader = (reader_t*) param;
+	hash_set_reader64_t *const handle = hash_set_reader_attach64(reader->hash_set);
+	size_t i;
+
+	if (handle)
+	{
+		for (i = reader->begin; i < reader->end; ++i)
+		{
+			reader->missed += hash_set_reader_contains64(handle, reader->items[i]) ? 1U : 0U;
+		}
+		hash_set_reader_detach64(handle);
+	}
+	else
+	{
+		reader->missed = reader->end - reader->begin;
+	}
+
+	reader->finished = 1;
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int all_finished(const reader_t *const readers, const size_t count)
+{
+	size_t r;
+	for (r = 0U; r < count; ++r)
+	{
+		if (!readers[r].finished)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+/* the lookups are split across the reader threads; optionally, the calling thread keeps inserting and removing items meanwhile */
+static int measure_readers(hash_set64_t *const hash_set, const size_t threads, const int writer, const uint64_t *const items, const size_t count, double *const seconds, size_t *const updates)
+{
+	reader_t readers[MAX_READERS];
+#if defined(_WIN32)
+	HANDLE handles[MAX_READERS];
+#else
+	pthread_t handles[MAX_READERS];
+#endif
+	size_t r, i, missed = 0U;
+	uint64_t clk_begin;
+
+	*updates = 0U;
+	clk_begin = clock_query();
+
+	for (r = 0U; r < threads; ++r)
+	{
+		memset(&readers[r], 0, sizeof(reader_t));
+		readers[r].hash_set = hash_set;
+		readers[r].items = items;
+		readers[r].begin = (count / threads) * r;
+		readers[r].end = (r + 1U < threads) ? ((count / threads) * (r + 1U)) : count;
+#if defined(_WIN32)
+		if (!(handles[r] = CreateThread(NULL, 0U, reader_thread, &readers[r], 0U, NULL)))
+#else
+		if (pthread_create(&handles[r], NULL, reader_thread, &readers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	while (writer && (!all_finished(readers, threads)))
+	{
+		for (i = 0U; i < CHURN_COUNT; ++i)
+		{
+			if (hash_set_insert64(hash_set, ~((uint64_t)i)) == ENOMEM)
+			{
+				abort(); /*insert operation has failed!*/
+			}
+		}
+		for (i = 0U; i < CHURN_COUNT; ++i)
+		{
+			hash_set_remove64(hash_set, ~((uint64_t)i));
+		}
+		*updates += 2U * CHURN_COUNT;
+	}
+
+	for (r = 0U; r < threads; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(handles[r], INFINITE);
+		CloseHandle(handles[r]);
+#else
+		pthread_join(handles[r], NULL);
+#endif
+		missed += readers[r].missed;
+	}
+
+	*seconds = SECONDS(clock_query() - clk_begin);
+
+	if (missed)
+	{
+		puts("Lookup operation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_readers(const size_t count)
+{
+	size_t i, k, threads;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+	random_t random;
+	int writer;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random) >> 1; /*the churn items have the highest bit set*/
+	}
+
+	printf("[READERS] %-10s %8s %6s %12s %12s %12s\n", "engine", "threads", "writer", "lookups", "Mops/s", "updates/s");
+
+	for (k = 0U; k < READER_ENGINE_COUNT; ++k)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = READER_ENGINES[k].engine;
+		options.concurrency = HASHSET_CONCURRENCY_READERS;
+
+		hash_set = hash_set_create_ex64(count, -1.0, clock_query(), &options);
+		if (!hash_set)
+		{
+			puts("Allocation has failed!");
+			goto failure;
+		}
+
+		for (i = 0U; i < count; ++i)
+		{
+			if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+			{
+				hash_set_destroy64(hash_set);
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+
+		for (writer = 0; writer < 2; ++writer)
+		{
+			for (threads = 1U; threads <= MAX_READERS; threads *= 2U)
+			{
+				double seconds;
+				size_t updates;
+				if (measure_readers(hash_set, threads, writer, items, count, &seconds, &updates) != EXIT_SUCCESS)
+				{
+					hash_set_destroy64(hash_set);
+					goto failure;
+				}
+				printf("[READERS] %-10s %8zu %6s %12zu %12.2f %12.2f\n", READER_ENGINES[k].name, threads, writer ? "yes" : "no", count, (count / seconds) / 1000000.0, updates / seconds);
+				fflush(stdout);
+			}
+		}
+
+		hash_set_destroy64(hash_set);
+	}
+
+	free(items);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(items);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int compare_ticks(const void *const a, const void *const b)
+{
+	const uint64_t x = *((const uint64_t*)a), y = *((const uint64_t*)b);
+	return (x < y) ? (-1) : ((x > y) ? 1 : 0);
+}
+
+static int measure_resize(const hash_engine_t engine, const hash_resize_t resize, const uint64_t *const items, const size_t count, uint64_t *const ticks, double *const total, double *const p99, double *const p999, double *const worst)
+{
+	size_t i;
+	uint64_t clk_begin, clk_end, sum = 0U;
+	hash_options_t options;
+	hash_set64_t *hash_set;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+	options.resize = resize;
+
+	hash_set = hash_set_create_ex64(0U, -1.0, clock_query(), &options);
+	if (!hash_set)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		clk_begin = clock_query();
+		if (hash_set_insert64(hash_set, items[i]) == ENOMEM)
+		{
+			hash_set_destroy64(hash_set);
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+		clk_end = clock_query();
+		sum += (ticks[i] = clk_end - clk_begin);
+	}
+
+	hash_set_destroy64(hash_set);
+	qsort(ticks, count, sizeof(uint64_t), compare_ticks);
+
+	*total = MICROSECONDS(sum) / 1000000.0;
+	*p99 = MICROSECONDS(ticks[(count / 100U) * 99U]);
+	*p999 = MICROSECONDS(ticks[(count / 1000U) * 999U]);
+	*worst = MICROSECONDS(ticks[count - 1U]);
+
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_resize(const size_t count)
+{
+	size_t i, k;
+	random_t random;
+
+	uint64_t *const items = (uint64_t*) malloc(count * sizeof(uint64_t));
+	uint64_t *const ticks = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if ((!items) || (!ticks))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		items[i] = random_next(&random);
+	}
+
+	printf("[RESIZE] %-10s %-11s %12s %10s %12s %12s %12s\n", "engine", "mode", "items", "s/total", "us/p99", "us/p99.9", "us/max");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		hash_resize_t resize;
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			double total, p99, p999, worst;
+			if (measure_resize(ENGINES[k].engine, resize, items, count, ticks, &total, &p99, &p999, &worst) != EXIT_SUCCESS)
+			{
+				free(items);
+				free(ticks);
+				return EXIT_FAILURE;
+			}
+			printf("[RESIZE] %-10s %-11s %12zu %10.3f %12.2f %12.2f %12.2f\n", ENGINES[k].name, (resize == HASHSET_RESIZE_INCREMENTAL) ? "incremental" : "blocking", count, total, p99, p999, worst);
+			fflush(stdout);
+		}
+	}
+
+	free(items);
+	free(ticks);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define MAX_WORKERS 64U
+
+/* ========================================================================= */
+/* Callback                                                                  */
+/* ========================================================================= */
+
+/* each part has its own accumulator, so that no synchronization is required */
+typedef struct
+{
+	uint64_t sum[MAX_WORKERS];
+	size_t count[MAX_WORKERS];
+}
+totals_t;
+
+static int sum_values(const uint64_t *const keys, const uint64_t *const values, const size_t count, const size_t part, void *const context)
+{
+	totals_t *const totals = (totals_t*) context;
+	uint64_t sum = 0U;
+	size_t i;
+
+	for (i = 0U; i < count; ++i)
+	{
+		sum += keys[i] ^ values[i];
+	}
+
+	totals->sum[part] += sum;
+	totals->count[part] += count;
+	return 1;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_scan(const size_t count)
+{
+	size_t i, threads, entries;
+	uint64_t clk_begin, sum, expected = 0U;
+	double baseline = 0.0;
+	hash_map64_t *hash_map;
+	random_t random;
+	totals_t totals;
+
+	hash_map = hash_map_create64(count, -1.0, clock_query());
+	if (!hash_map)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		const uint64_t key = random_next(&random);
+		if (hash_map_insert64(hash_map, key, (uint64_t)i, 1) == ENOMEM)
+		{
+			puts("Insert operation has failed!");
+			goto failure;
+		}
+	}
+
+	printf("[SCAN] %8s %12s %12s %9s\n", "threads", "entries", "ns/entry", "speed-up");
+
+	for (threads = 1U; threads <= MAX_WORKERS; threads *= 2U)
+	{
+		double elapsed;
+
+		memset(&totals, 0, sizeof(totals_t));
+		clk_begin = clock_query();
+		if (hash_map_parallel_for64(hash_map, threads, sum_values, &totals))
+		{
+			puts("Parallel scan has failed!");
+			goto failure;
+		}
+
+		elapsed = NANOSECONDS(clock_query() - clk_begin, hash_map_size64(hash_map));
+
+		for (i = 0U, sum = 0U, entries = 0U; i < MAX_WORKERS; ++i)
+		{
+			sum += totals.sum[i];
+			entries += totals.count[i];
+		}
+
+		if ((entries != hash_map_size64(hash_map)) || ((threads > 1U) && (sum != expected)))
+		{
+			puts("Checksum mismatch has been detected!");
+			goto failure;
+		}
+
+		if (threads == 1U)
+		{
+			expected = sum;
+			baseline = elapsed;
+		}
+
+		printf("[SCAN] %8zu %12zu %12.2f %8.2fx\n", threads, entries, elapsed, baseline / elapsed);
+		fflush(stdout);
+	}
+
+	hash_map_destroy64(hash_map);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(hash_map);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_map.h>
+#include <random_in.h>
+#include <time_in.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+typedef enum
+{
+	METHOD_GET_INSERT,
+	METHOD_UPSERT,
+	METHOD_GET_OR_INSERT
+}
+method_t;
+
+static const char *const METHODS[] = { "get+insert", "upsert", "get_or_insert" };
+
+#define METHOD_COUNT (sizeof(METHODS) / sizeof(METHODS[0U]))
+
+#define KEY_SPACE(N) (((N) / 16U) + 1U)
+
+/* ========================================================================= */
+/* Operations                                                                */
+/* ========================================================================= */
+
+static int measure_updates(const hash_engine_t engine, const method_t method, const uint64_t *const keys, const size_t count, double *const elapsed, uint64_t *const checksum)
+{
+	size_t i;
+	uint64_t clk_begin, value, *slot;
+	hash_options_t options;
+	hash_map64_t *hash_map;
+	errno_t error;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = engine;
+
+	hash_map = hash_map_create_ex64(0U, -1.0, clock_query(), &options);
+	if (!hash_map)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	clk_begin = clock_query();
+	for (i = 0U; i < count; ++i)
+	{
+		switch (method)
+		{
+		case METHOD_UPSERT:
+			error = hash_map_upsert64(hash_map, keys[i], 1U, HASHSET_ACCUMULATE_ADD);
+			break;
+		case METHOD_GET_OR_INSERT:
+			if ((!(error = hash_map_get_or_insert64(hash_map, keys[i], 0U, &slot))) || (error == EEXIST))
+			{
+				++(*slot);
+			}
+			break;
+		default:
+			value = 0U;
+			hash_map_get64(hash_map, keys[i], &value);
+			error = hash_map_insert64(hash_map, keys[i], value + 1U, 1);
+		}
+		if ((error) && (error != EEXIST))
+		{
+			hash_map_destroy64(hash_map);
+			puts("Update operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	*elapsed = NANOSECONDS(clock_query() - clk_begin, count);
+
+	for (i = 0U, *checksum = 0U; i < count; ++i)
+	{
+		if (!hash_map_get64(hash_map, keys[i], &value))
+		{
+			*checksum += value;
+		}
+	}
+
+	hash_map_destroy64(hash_map);
+	return EXIT_SUCCESS;
+}
+
+/* ========================================================================= */
+/* Benchmark                                                                 */
+/* ========================================================================= */
+
+int benchmark_upsert(const size_t count)
+{
+	size_t i, k, m;
+	random_t random;
+	uint64_t expected = 0U;
+
+	uint64_t *const keys = (uint64_t*) malloc(count * sizeof(uint64_t));
+	if (!keys)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	random_init(&random);
+	for (i = 0U; i < count; ++i)
+	{
+		keys[i] = random_next(&random) % KEY_SPACE(count);
+	}
+
+	printf("[UPSERT] %-10s %-14s %12s %12s %12s\n", "engine", "method", "updates", "keys", "ns/update");
+
+	for (k = 0U; k < ENGINE_COUNT; ++k)
+	{
+		for (m = 0U; m < METHOD_COUNT; ++m)
+		{
+			double elapsed;
+			uint64_t checksum;
+			if (measure_updates(ENGINES[k].engine, (method_t)m, keys, count, &elapsed, &checksum) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+			if ((k == 0U) && (m == 0U))
+			{
+				expected = checksum;
+			}
+			else if (checksum != expected)
+			{
+				puts("Checksum mismatch has been detected!");
+				goto failure;
+			}
+			printf("[UPSERT] %-10s %-14s %12zu %12zu %12.2f\n", ENGINES[k].name, METHODS[m], count, (size_t)KEY_SPACE(count), elapsed);
+			fflush(stdout);
+		}
+	}
+
+	free(keys);
+	puts("---------");
+
+	return EXIT_SUCCESS;
+
+failure:
+	free(keys);
+	return EXIT_FAILURE;
+}
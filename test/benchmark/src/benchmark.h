@@ -0,0 +1,51 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#ifndef _TEST_BENCHMARK_INCLUDED
+#define _TEST_BENCHMARK_INCLUDED
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <hash_set.h>
+
+/* conversion of the clock ticks, as returned by clock_query(), into units of time */
+#define SECONDS(X) (((double)(X)) / ((double)clock_frequency()))
+#define MILLISECONDS(X) ((((double)(X)) * 1000.0) / ((double)clock_frequency()))
+#define MICROSECONDS(X) ((((double)(X)) * 1000000.0) / ((double)clock_frequency()))
+#define NANOSECONDS(X,N) ((((double)(X)) * 1000000000.0) / ((double)clock_frequency() * (N)))
+
+typedef struct
+{
+	hash_engine_t engine;
+	const char *name;
+}
+bench_engine_t;
+
+#define ENGINE_COUNT 5U
+
+extern const bench_engine_t ENGINES[ENGINE_COUNT];
+
+uint64_t cycles_query(void);
+
+int benchmark_hash(const size_t count);
+int benchmark_probe(const size_t count);
+int benchmark_engine(const size_t count);
+int benchmark_large(const size_t count);
+int benchmark_layout(const size_t count);
+int benchmark_batch(const size_t count);
+int benchmark_build(const size_t count);
+int benchmark_resize(const size_t count);
+int benchmark_memory(const size_t count);
+int benchmark_numa(const size_t count);
+int benchmark_readers(const size_t count);
+int benchmark_concurrent(const size_t count);
+int benchmark_lockfree(const size_t count);
+int benchmark_counting(const size_t count);
+int benchmark_upsert(const size_t count);
+int benchmark_export(const size_t count);
+int benchmark_scan(const size_t count);
+int benchmark_load(const size_t count);
+
+#endif /*_TEST_BENCHMARK_INCLUDED*/
@@ -0,0 +1,218 @@
+/******************************************************************************/
+/* HashSet for C99, by LoRd_MuldeR <MuldeR2@GMX.de>                           */
+/* This work has been released under the CC0 1.0 Universal license!           */
+/******************************************************************************/
+
+#include "benchmark.h"
+#include <hash_set.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define HAVE_RDTSC 1
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define HAVE_RDTSC 1
+#endif
+
+#define IS_MODE(X) ((argc < 2) || (!strcmp(argv[1], (X))) || (!strcmp(argv[1], "all")))
+
+/* ========================================================================= */
+/* Utilities                                                                 */
+/* ========================================================================= */
+
+const bench_engine_t ENGINES[ENGINE_COUNT] =
+{
+	{ HASHSET_ENGINE_BITMAP,    "bitmap"    },
+	{ HASHSET_ENGINE_SWISS,     "swiss"     },
+	{ HASHSET_ENGINE_ROBINHOOD, "robinhood" },
+	{ HASHSET_ENGINE_CUCKOO,    "cuckoo"    },
+	{ HASHSET_ENGINE_SENTINEL,  "sentinel"  }
+};
+
+uint64_t cycles_query(void)
+{
+#ifdef HAVE_RDTSC
+	return __rdtsc();
+#else
+	return 0U;
+#endif
+}
+
+static size_t parse_count(const int argc, char *const argv[], const size_t default_count)
+{
+	if (argc > 2)
+	{
+		const unsigned long long value = strtoull(argv[2], NULL, 10);
+		if (value > 0U)
+		{
+			return (size_t)value;
+		}
+	}
+
+	return default_count;
+}
+
+/* ========================================================================= */
+/* MAIN                                                                      */
+/* ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+	printf("LibHashSet Benchmark v%" PRIu16 ".%" PRIu16 ".%" PRIu16 " [%s]\n\n",
+		HASHSET_VERSION_MAJOR, HASHSET_VERSION_MINOR, HASHSET_VERSION_PATCH, HASHSET_BUILD_DATE);
+
+	if (IS_MODE("hash"))
+	{
+		if (benchmark_hash(parse_count(argc, argv, 1000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("probe"))
+	{
+		if (benchmark_probe(parse_count(argc, argv, 1000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("engine"))
+	{
+		if (benchmark_engine(parse_count(argc, argv, 1000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("layout"))
+	{
+		if (benchmark_layout(parse_count(argc, argv, 1000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("batch"))
+	{
+		if (benchmark_batch(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("build"))
+	{
+		if (benchmark_build(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("resize"))
+	{
+		if (benchmark_resize(parse_count(argc, argv, 4000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("memory"))
+	{
+		if (benchmark_memory(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("numa"))
+	{
+		if (benchmark_numa(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("readers"))
+	{
+		if (benchmark_readers(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("concurrent"))
+	{
+		if (benchmark_concurrent(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("lockfree"))
+	{
+		if (benchmark_lockfree(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("counting"))
+	{
+		if (benchmark_counting(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("upsert"))
+	{
+		if (benchmark_upsert(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("export"))
+	{
+		if (benchmark_export(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("scan"))
+	{
+		if (benchmark_scan(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if (IS_MODE("load"))
+	{
+		if (benchmark_load(parse_count(argc, argv, 10000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	if ((argc > 1) && (!strcmp(argv[1], "large")))
+	{
+		if (benchmark_large(parse_count(argc, argv, 100000000U)) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+	}
+
+	puts("Benchmark completed successfully.\n");
+	return EXIT_SUCCESS;
+
+failure:
+	puts("\nSomething went wrong !!!\n");
+	return EXIT_FAILURE;
+}
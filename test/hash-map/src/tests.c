@@ -12,7 +12,14 @@
 #include <string.h>
 #include <errno.h>
 
-#define TEST_COUNT 4
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+#define TEST_COUNT 24
 
 /* ========================================================================= */
 /* Utilities                                                                 */
@@ -32,6 +39,52 @@
 } \
 while(0)
 
+/* creates a map with the given engine, resize mode and layout, then inserts the keys (index - 1), so that the first two keys are the sentinel values; stops right after the table has grown, once at least the given minimum number of entries has been inserted, so that an incremental resize is still pending */
+static hash_map64_t *fill_until_grown(hash_options_t *const options, const int engine, const int resize, const hash_layout_t layout, uint8_t *const test, const size_t size, const size_t minimum, uint64_t (*const value)(const size_t index))
+{
+	size_t j, capacity, previous = 0U;
+	hash_map64_t *instance;
+	errno_t error;
+
+	memset(options, 0, sizeof(hash_options_t));
+	options->engine = (hash_engine_t)engine;
+	options->resize = (hash_resize_t)resize;
+	options->layout = layout;
+
+	instance = hash_map_create_ex64(0U, -1.0, clock(), options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return NULL;
+	}
+
+	if (test)
+	{
+		memset(test, 0, size * sizeof(uint8_t));
+	}
+
+	for (j = 0U; j < size; ++j)
+	{
+		if ((error = hash_map_insert64(instance, ((uint64_t)j) - 1U, value(j), 0)))
+		{
+			printf("Insert operation has failed! (error: %d)\n", error);
+			hash_map_destroy64(instance);
+			return NULL;
+		}
+		if (test)
+		{
+			test[j] = 1U;
+		}
+		if ((!hash_map_info64(instance, &capacity, NULL, NULL, NULL)) && (capacity != previous) && (j >= minimum))
+		{
+			break;
+		}
+		previous = capacity;
+	}
+
+	return instance;
+}
+
 /* ========================================================================= */
 /* TEST #1                                                                   */
 /* ========================================================================= */
@@ -440,3 +493,3300 @@ int test_function_4(hash_map64_t *const hash_map)
 
 	return EXIT_SUCCESS;
 }
+
+/* ========================================================================= */
+/* TEST #5                                                                   */
+/* ========================================================================= */
+
+#define ENGINE_SIZE 65521U
+
+int test_function_5(hash_map64_t *const hash_map)
+{
+	size_t r, j, cursor, count, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t key, value, *test_val;
+	uint8_t *test_key;
+	int engine, layout;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test_key = (uint8_t*) malloc(ENGINE_SIZE * sizeof(uint8_t));
+	if (!test_key)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	test_val = (uint64_t*) malloc(ENGINE_SIZE * sizeof(uint64_t));
+	if (!test_val)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.layout = (hash_layout_t)layout;
+
+			instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				return EXIT_FAILURE;
+			}
+
+			memset(test_key, 0, ENGINE_SIZE * sizeof(uint8_t));
+
+			for (r = 0U; r < 64U * ENGINE_SIZE; ++r)
+			{
+				const size_t rnd = random_next(&random) % ENGINE_SIZE;
+				if (test_key[rnd])
+				{
+					const errno_t error = hash_map_remove64(instance, rnd, &value);
+					if (error || (value != test_val[rnd]))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+				else
+				{
+					const errno_t error = hash_map_insert64(instance, rnd, test_val[rnd] = random_next(&random), 0);
+					if (error)
+					{
+						printf("Insert operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+				INVERT(test_key[rnd]);
+			}
+
+			for (j = 0U, count = 0U; j < ENGINE_SIZE; ++j)
+			{
+				const errno_t error = hash_map_get64(instance, j, &value);
+				if (error != (test_key[j] ? 0 : ENOENT))
+				{
+					printf("Get operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				if (test_key[j])
+				{
+					if (value != test_val[j])
+					{
+						puts("Value mismatch has been detected!");
+						goto failure;
+					}
+					++count;
+				}
+			}
+
+			if (hash_map_size64(instance) != count)
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+
+			for (cursor = 0U; !hash_map_iterate64(instance, &cursor, &key, &value); --count)
+			{
+				if ((key >= ENGINE_SIZE) || (!test_key[key]) || (value != test_val[key]))
+				{
+					puts("Iteration has returned an invalid entry!");
+					goto failure;
+				}
+			}
+
+			if (count)
+			{
+				puts("Iteration has missed some entries!");
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, layout: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 5, TEST_COUNT, engine, layout, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+		}
+	}
+
+	free(test_key);
+	free(test_val);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test_key);
+	free(test_val);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #6                                                                   */
+/* ========================================================================= */
+
+#define BATCH_COUNT 65521U
+
+int test_function_6(hash_map64_t *const hash_map)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *keys, *values;
+	uint8_t *test, *found;
+	int engine, layout;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	keys = (uint64_t*) malloc(BATCH_COUNT * sizeof(uint64_t));
+	values = (uint64_t*) malloc(BATCH_COUNT * sizeof(uint64_t));
+	test = (uint8_t*) malloc(BATCH_COUNT * sizeof(uint8_t));
+	found = (uint8_t*) malloc(((BATCH_COUNT + 7U) / 8U) * sizeof(uint8_t));
+	if ((!keys) || (!values) || (!test) || (!found))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.layout = (hash_layout_t)layout;
+
+			instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				free(keys);
+				free(values);
+				free(test);
+				free(found);
+				return EXIT_FAILURE;
+			}
+
+			for (j = 0U; j < BATCH_COUNT; ++j)
+			{
+				keys[j] = random_next(&random);
+				if ((test[j] = (uint8_t)(keys[j] & 1U)))
+				{
+					const errno_t error = hash_map_insert64(instance, keys[j], ~keys[j], 1);
+					if (error && (error != EEXIST))
+					{
+						printf("Insert operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+				hash_map_prefetch64(instance, keys[j]);
+			}
+
+			if (hash_map_get_batch64(instance, keys, BATCH_COUNT, values, found) != ENOENT)
+			{
+				puts("Batch operation has failed!");
+				goto failure;
+			}
+
+			for (j = 0U; j < BATCH_COUNT; ++j)
+			{
+				if ((!((found[j / 8U] >> (j % 8U)) & 1U)) != (!test[j]))
+				{
+					puts("Batch operation has returned an invalid result!");
+					goto failure;
+				}
+				if (test[j] && (values[j] != ~keys[j]))
+				{
+					puts("Value mismatch has been detected!");
+					goto failure;
+				}
+			}
+
+			for (j = 0U; j < BATCH_COUNT; ++j)
+			{
+				if ((!test[j]) && hash_map_insert64(instance, keys[j], ~keys[j], 1))
+				{
+					puts("Insert operation has failed!");
+					goto failure;
+				}
+			}
+
+			memset(values, 0, BATCH_COUNT * sizeof(uint64_t));
+
+			if (hash_map_get_batch64(instance, keys, BATCH_COUNT, values, NULL))
+			{
+				puts("Batch operation has failed!");
+				goto failure;
+			}
+
+			for (j = 0U; j < BATCH_COUNT; ++j)
+			{
+				if (values[j] != ~keys[j])
+				{
+					puts("Value mismatch has been detected!");
+					goto failure;
+				}
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, layout: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 6, TEST_COUNT, engine, layout, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+		}
+	}
+
+	free(keys);
+	free(values);
+	free(test);
+	free(found);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(keys);
+	free(values);
+	free(test);
+	free(found);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #7                                                                   */
+/* ========================================================================= */
+
+#define CHUNK_SIZE 4096U
+
+/* a batch of keys that are all present already must not make the map grow */
+static int check_reinsert(const hash_options_t *const options)
+{
+	size_t j, capacity[2U], valid, deleted, limit;
+	hash_map64_t *instance;
+	uint64_t keys[CHUNK_SIZE];
+
+	instance = hash_map_create_ex64(0U, -1.0, clock(), options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (j = 0U; j < CHUNK_SIZE; ++j)
+	{
+		if (hash_map_insert64(instance, keys[j] = (uint64_t)j, (uint64_t)j, 0))
+		{
+			puts("Insert operation has failed!");
+			goto failure;
+		}
+	}
+
+	if (hash_map_info64(instance, &capacity[0U], &valid, &deleted, &limit) || (hash_map_insert_batch64(instance, keys, keys, CHUNK_SIZE, 1, NULL) != EEXIST) || hash_map_info64(instance, &capacity[1U], &valid, &deleted, &limit))
+	{
+		puts("Batch operation has failed!");
+		goto failure;
+	}
+
+	if ((capacity[1U] != capacity[0U]) || (valid != CHUNK_SIZE))
+	{
+		puts("Map has grown for keys that were present already!");
+		goto failure;
+	}
+
+	hash_map_destroy64(instance);
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+int test_function_7(hash_map64_t *const hash_map)
+{
+	size_t r, j, expected, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t keys[CHUNK_SIZE], values[CHUNK_SIZE], value, *test_val;
+	uint8_t *test_key, result[CHUNK_SIZE / 8U];
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test_key = (uint8_t*) malloc(BATCH_COUNT * sizeof(uint8_t));
+	test_val = (uint64_t*) malloc(BATCH_COUNT * sizeof(uint64_t));
+	if ((!test_key) || (!test_val))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			return EXIT_FAILURE;
+		}
+
+		memset(test_key, 0, BATCH_COUNT * sizeof(uint8_t));
+
+		for (r = 0U, expected = 0U; r < 256U; ++r)
+		{
+			const int insert = (r < 16U) || (random_next(&random) & 1U);
+			errno_t error, error_expected = 0;
+
+			for (j = 0U; j < CHUNK_SIZE; ++j)
+			{
+				keys[j] = random_next(&random) % BATCH_COUNT;
+				values[j] = insert ? random_next(&random) : 0U;
+			}
+
+			error = insert ? hash_map_insert_batch64(instance, keys, values, CHUNK_SIZE, 0, result) : hash_map_remove_batch64(instance, keys, CHUNK_SIZE, values, result);
+
+			for (j = 0U; j < CHUNK_SIZE; ++j)
+			{
+				const int success = (int)((result[j / 8U] >> (j % 8U)) & 1U);
+				if (success != (insert ? (!test_key[keys[j]]) : test_key[keys[j]]))
+				{
+					puts("Batch operation has returned an invalid result!");
+					goto failure;
+				}
+				if (success)
+				{
+					if (insert)
+					{
+						test_val[keys[j]] = values[j];
+					}
+					else if (values[j] != test_val[keys[j]])
+					{
+						puts("Value mismatch has been detected!");
+						goto failure;
+					}
+					INVERT(test_key[keys[j]]);
+					expected = insert ? (expected + 1U) : (expected - 1U);
+				}
+				else
+				{
+					error_expected = insert ? EEXIST : ENOENT;
+				}
+			}
+
+			if (error != error_expected)
+			{
+				printf("Batch operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+
+			if (hash_map_size64(instance) != expected)
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			const errno_t error = hash_map_get64(instance, j, &value);
+			if ((error != (test_key[j] ? 0 : ENOENT)) || (test_key[j] && (value != test_val[j])))
+			{
+				puts("Get operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (check_reinsert(&options) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[MAP %d/%d] engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 7, TEST_COUNT, engine, capacity, valid, deleted, limit);
+		}
+
+		hash_map_destroy64(instance);
+	}
+
+	free(test_key);
+	free(test_val);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test_key);
+	free(test_val);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #8                                                                   */
+/* ========================================================================= */
+
+#define BUILD_COUNT 300007U
+#define BUILD_RANGE 262139U
+
+int test_function_8(hash_map64_t *const hash_map)
+{
+	size_t j, threads, distinct, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *keys, *values, *first_val, *last_val, value;
+	uint8_t *test;
+	int engine, update;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	keys = (uint64_t*) malloc(BUILD_COUNT * sizeof(uint64_t));
+	values = (uint64_t*) malloc(BUILD_COUNT * sizeof(uint64_t));
+	first_val = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	last_val = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	if ((!keys) || (!values) || (!first_val) || (!last_val) || (!test))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+
+	for (j = 0U, distinct = 0U; j < BUILD_COUNT; ++j)
+	{
+		keys[j] = random_next(&random) % BUILD_RANGE;
+		values[j] = random_next(&random);
+		if (!test[keys[j]])
+		{
+			first_val[keys[j]] = values[j];
+			test[keys[j]] = 1U;
+			++distinct;
+		}
+		last_val[keys[j]] = values[j];
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (threads = 1U; threads <= 4U; ++threads)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.thread_count = threads;
+			options.probe_strategy = (hash_probe_t)(threads - 1U); /*each of the probe strategies with a different number of threads*/
+
+			instance = hash_map_create_from_arrays64(keys, values, BUILD_COUNT, -1.0, clock(), &options, HASHSET_DUPLICATES_FAIL);
+			if (instance)
+			{
+				puts("Duplicate keys have not been detected!");
+				goto failure;
+			}
+
+			for (update = 0; update < 2; ++update)
+			{
+				instance = hash_map_create_from_arrays64(keys, values, BUILD_COUNT, -1.0, clock(), &options, update ? HASHSET_DUPLICATES_UPDATE : HASHSET_DUPLICATES_IGNORE);
+				if (!instance)
+				{
+					puts("Allocation has failed!");
+					return EXIT_FAILURE;
+				}
+
+				if (hash_map_size64(instance) != distinct)
+				{
+					puts("Invalid size!");
+					goto failure;
+				}
+
+				for (j = 0U; j < BUILD_RANGE; ++j)
+				{
+					const errno_t error = hash_map_get64(instance, j, &value);
+					if ((error != (test[j] ? 0 : ENOENT)) || (test[j] && (value != (update ? last_val[j] : first_val[j]))))
+					{
+						puts("Get operation has failed!");
+						goto failure;
+					}
+				}
+
+				if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+				{
+					fprintf(stdout, "[MAP %d/%d] engine: %d, threads: %zu, probe: %d, update: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 8, TEST_COUNT, engine, threads, (int)options.probe_strategy, update, capacity, valid, deleted, limit);
+				}
+
+				hash_map_destroy64(instance);
+			}
+		}
+	}
+
+	free(keys);
+	free(values);
+	free(first_val);
+	free(last_val);
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(keys);
+	free(values);
+	free(first_val);
+	free(last_val);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #9                                                                   */
+/* ========================================================================= */
+
+#define REBUILD_COUNT 393241U
+
+int test_function_9(hash_map64_t *const hash_map)
+{
+	size_t j, threads, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *keys, value;
+	int engine, layout;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	keys = (uint64_t*) malloc(REBUILD_COUNT * sizeof(uint64_t));
+	if (!keys)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (j = 0U; j < REBUILD_COUNT; ++j)
+	{
+		keys[j] = (random_next(&random) << 20) | j;
+	}
+
+	keys[0U] = 0U;
+	keys[1U] = UINT64_MAX;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			for (threads = 1U; threads <= 4U; ++threads)
+			{
+				memset(&options, 0, sizeof(hash_options_t));
+				options.engine = (hash_engine_t)engine;
+				options.layout = (hash_layout_t)layout;
+				options.thread_count = threads;
+				options.probe_strategy = (hash_probe_t)(threads - 1U); /*each of the probe strategies with a different number of threads*/
+
+				instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+				if (!instance)
+				{
+					puts("Allocation has failed!");
+					free(keys);
+					return EXIT_FAILURE;
+				}
+
+				for (j = 0U; j < REBUILD_COUNT; ++j)
+				{
+					if (hash_map_insert64(instance, keys[j], ~keys[j], 0))
+					{
+						puts("Insert operation has failed!");
+						goto failure;
+					}
+				}
+
+				for (j = 1U; j < REBUILD_COUNT; j += 2U)
+				{
+					if (hash_map_remove64(instance, keys[j], NULL))
+					{
+						puts("Remove operation has failed!");
+						goto failure;
+					}
+				}
+
+				for (j = 0U; j < REBUILD_COUNT; ++j)
+				{
+					const errno_t error = hash_map_get64(instance, keys[j], &value);
+					if ((error != ((j & 1U) ? ENOENT : 0)) || ((!error) && (value != ~keys[j])))
+					{
+						puts("Get operation has failed!");
+						goto failure;
+					}
+				}
+
+				if (hash_map_size64(instance) != ((REBUILD_COUNT + 1U) / 2U))
+				{
+					puts("Invalid size!");
+					goto failure;
+				}
+
+				if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+				{
+					fprintf(stdout, "[MAP %d/%d] engine: %d, layout: %d, threads: %zu, probe: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 9, TEST_COUNT, engine, layout, threads, (int)options.probe_strategy, capacity, valid, deleted, limit);
+				}
+
+				hash_map_destroy64(instance);
+			}
+		}
+	}
+
+	free(keys);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(keys);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #10                                                                  */
+/* ========================================================================= */
+
+#define RESIZE_STEPS 1048576U
+
+static int verify_contents(const hash_map64_t *const instance, const uint8_t *const test, const uint64_t *const expected, const size_t count)
+{
+	size_t j, cursor = 0U;
+	uint64_t key, value;
+
+	for (j = 0U; j < BUILD_RANGE; ++j)
+	{
+		const errno_t error = hash_map_get64(instance, j, &value);
+		if ((error != (test[j] ? 0 : ENOENT)) || (test[j] && (value != expected[j])))
+		{
+			puts("Get operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (j = 0U; !hash_map_iterate64(instance, &cursor, &key, &value); ++j)
+	{
+		if ((key >= BUILD_RANGE) || (!test[key]) || (value != expected[key]))
+		{
+			puts("Iteration has returned an unexpected entry!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (j != count)
+	{
+		puts("Iteration has returned a wrong number of entries!");
+		return EXIT_FAILURE;
+	}
+
+	if (hash_map_size64(instance) != count)
+	{
+		puts("Invalid size!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_10(hash_map64_t *const hash_map)
+{
+	size_t j, count, resizes, capacity, valid, deleted, limit, previous;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t key, value, *expected;
+	uint8_t *test;
+	errno_t error;
+	int engine, layout, update;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.layout = (hash_layout_t)layout;
+			options.resize = HASHSET_RESIZE_INCREMENTAL;
+
+			instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				free(test);
+				free(expected);
+				return EXIT_FAILURE;
+			}
+
+			memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+			count = resizes = previous = 0U;
+
+			for (j = 0U; j < RESIZE_STEPS; ++j)
+			{
+				key = random_next(&random) % BUILD_RANGE;
+				switch (random_next(&random) % 4U)
+				{
+				case 0U:
+					error = hash_map_remove64(instance, key, &value);
+					if ((error != (test[key] ? 0 : ENOENT)) || ((!error) && (value != expected[key])))
+					{
+						puts("Remove operation has failed!");
+						goto failure;
+					}
+					if (!error)
+					{
+						test[key] = 0U;
+						--count;
+					}
+					break;
+				case 1U:
+					error = hash_map_get64(instance, key, &value);
+					if ((error != (test[key] ? 0 : ENOENT)) || ((!error) && (value != expected[key])))
+					{
+						puts("Get operation has failed!");
+						goto failure;
+					}
+					break;
+				default:
+					value = random_next(&random);
+					update = (int)(value & 1U);
+					error = hash_map_insert64(instance, key, value, update);
+					if (error != (test[key] ? EEXIST : 0))
+					{
+						puts("Insert operation has failed!");
+						goto failure;
+					}
+					if ((!error) || update)
+					{
+						expected[key] = value;
+					}
+					if (!error)
+					{
+						test[key] = 1U;
+						++count;
+					}
+				}
+
+				if (hash_map_size64(instance) != count)
+				{
+					puts("Invalid size!");
+					goto failure;
+				}
+
+				if ((!hash_map_info64(instance, &capacity, &valid, &deleted, &limit)) && (capacity != previous))
+				{
+					if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+					{
+						goto failure;
+					}
+					previous = capacity;
+					++resizes;
+				}
+			}
+
+			if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, layout: %d, resizes: %zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 10, TEST_COUNT, engine, layout, resizes, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+		}
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #11                                                                  */
+/* ========================================================================= */
+
+#define SIZING_COUNT 196613U
+
+static hash_map64_t *create_sizing(const int engine, const double growth_factor, const hash_shrink_t shrink, const double shrink_threshold)
+{
+	hash_options_t options;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = (hash_engine_t)engine;
+	options.growth_factor = growth_factor;
+	options.shrink = shrink;
+	options.shrink_threshold = shrink_threshold;
+
+	return hash_map_create_ex64(0U, -1.0, clock(), &options);
+}
+
+static int insert_range(hash_map64_t *const instance, const size_t first, const size_t last, const size_t growth)
+{
+	size_t j, capacity, valid, deleted, limit, previous = 0U;
+
+	for (j = first; j < last; ++j)
+	{
+		if (hash_map_insert64(instance, j, j + 1U, 0))
+		{
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			if (previous && (capacity != previous) && ((!growth) || (capacity < (previous * growth))))
+			{
+				puts("Capacity has changed unexpectedly!");
+				return EXIT_FAILURE;
+			}
+			previous = capacity;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_11(hash_map64_t *const hash_map)
+{
+	size_t j, capacity, valid, deleted, limit, peak;
+	hash_map64_t *instance = NULL;
+	uint64_t value;
+	int engine;
+
+	UNUSED(hash_map);
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		/* growth factor and keep-on-clear */
+		instance = create_sizing(engine, 4.0, HASHSET_SHRINK_KEEP_ON_CLEAR, 0.0);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 4U) != EXIT_SUCCESS) || hash_map_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		if (hash_map_clear64(instance) || hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak) || valid)
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		if ((insert_range(instance, 0U, SIZING_COUNT, 0U) != EXIT_SUCCESS) || hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak))
+		{
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+
+		/* no shrinking, explicit shrink_to_fit and reserve */
+		instance = create_sizing(engine, 0.0, HASHSET_SHRINK_NEVER, 0.0);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 2U) != EXIT_SUCCESS) || hash_map_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_map_remove64(instance, j, NULL))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak))
+		{
+			puts("Capacity has been reduced unexpectedly!");
+			goto failure;
+		}
+
+		if (hash_map_shrink_to_fit64(instance) || hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak) || deleted)
+		{
+			puts("Shrink operation has failed!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			const errno_t error = hash_map_get64(instance, j, &value);
+			if ((error != ((j % 16U) ? ENOENT : 0)) || ((!error) && (value != (j + 1U))))
+			{
+				puts("Get operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_map_reserve64(instance, SIZING_COUNT) || hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (limit < SIZING_COUNT))
+		{
+			puts("Reserve operation has failed!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_map_insert64(instance, j, j + 1U, 0))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_map_info64(instance, &peak, &valid, &deleted, &limit) || (peak != capacity) || (valid != SIZING_COUNT))
+		{
+			puts("Capacity has changed after reserve!");
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+
+		/* automatic shrinking with threshold */
+		instance = create_sizing(engine, 0.0, HASHSET_SHRINK_AUTO, 0.25);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 2U) != EXIT_SUCCESS) || hash_map_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_map_remove64(instance, j, NULL))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak) || (valid != ((SIZING_COUNT + 15U) / 16U)))
+		{
+			puts("Capacity has not been reduced!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			const errno_t error = hash_map_get64(instance, j, &value);
+			if ((error != ((j % 16U) ? ENOENT : 0)) || ((!error) && (value != (j + 1U))))
+			{
+				puts("Get operation has failed!");
+				goto failure;
+			}
+		}
+
+		fprintf(stdout, "[MAP %d/%d] engine: %d, peak: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 11, TEST_COUNT, engine, peak, capacity, valid, deleted, limit);
+
+		if (hash_map_clear64(instance) || hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak))
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #12                                                                  */
+/* ========================================================================= */
+
+#define PURGE_ROUNDS 8U
+
+static const hash_engine_t PURGE_ENGINES[] = { HASHSET_ENGINE_BITMAP, HASHSET_ENGINE_SWISS, HASHSET_ENGINE_SENTINEL }; /*the other engines never leave "deleted" slots behind*/
+
+int test_function_12(hash_map64_t *const hash_map)
+{
+	size_t j, k, round, count, purges, capacity, valid, deleted, limit, initial, previous;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *expected;
+	uint8_t *test;
+	int layout, probe;
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (k = 0U; k < sizeof(PURGE_ENGINES) / sizeof(PURGE_ENGINES[0U]); ++k)
+	{
+		for (layout = HASHSET_LAYOUT_AOS; layout <= HASHSET_LAYOUT_SOA; ++layout)
+		{
+			for (probe = HASHSET_PROBE_DEFAULT; probe <= HASHSET_PROBE_QUADRATIC; ++probe)
+			{
+				memset(&options, 0, sizeof(hash_options_t));
+				options.engine = PURGE_ENGINES[k];
+				options.layout = (hash_layout_t)layout;
+				options.probe_strategy = (hash_probe_t)probe;
+				options.shrink = HASHSET_SHRINK_NEVER;
+
+				/* high load factor, because the swiss engine only leaves "deleted" slots behind in full groups */
+				instance = hash_map_create_ex64(0U, 0.9375, clock(), &options);
+				if ((!instance) || hash_map_reserve64(instance, BUILD_RANGE / 2U) || hash_map_info64(instance, &initial, &valid, &deleted, &limit))
+				{
+					puts("Allocation has failed!");
+					hash_map_destroy64(instance);
+					free(test);
+					free(expected);
+					return EXIT_FAILURE;
+				}
+
+				memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+				count = purges = 0U;
+
+				for (round = 0U; round < PURGE_ROUNDS; ++round)
+				{
+					/* fill the table right up to the limit, so that it does not grow */
+					for (j = 0U; (j < BUILD_RANGE) && (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit)) && (valid + deleted + 1U < limit); ++j)
+					{
+						expected[j] = ~((uint64_t)j);
+						if ((!test[j]) && hash_map_insert64(instance, j, expected[j], 0))
+						{
+							puts("Insert operation has failed!");
+							goto failure;
+						}
+						test[j] = 1U;
+					}
+
+					/* the "deleted" slots are purged once they exceed half of the limit */
+					for (j = 0U, previous = deleted; j < BUILD_RANGE; ++j)
+					{
+						if (test[j] && ((j % PURGE_ROUNDS) != round))
+						{
+							if (hash_map_remove64(instance, j, NULL))
+							{
+								puts("Remove operation has failed!");
+								goto failure;
+							}
+							test[j] = 0U;
+							if (hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != initial))
+							{
+								puts("Capacity has changed unexpectedly!");
+								goto failure;
+							}
+							if (deleted < previous)
+							{
+								++purges;
+							}
+							previous = deleted;
+						}
+					}
+
+					for (j = count = 0U; j < BUILD_RANGE; ++j)
+					{
+						count += test[j];
+					}
+
+					if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+					{
+						goto failure;
+					}
+				}
+
+				if (hash_map_info64(instance, &capacity, &valid, &deleted, &limit) || (purges < PURGE_ROUNDS))
+				{
+					puts("Deleted slots have not been purged!");
+					goto failure;
+				}
+
+				fprintf(stdout, "[MAP %d/%d] engine: %d, layout: %d, probe: %d, purges: %zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 12, TEST_COUNT, PURGE_ENGINES[k], layout, probe, purges, capacity, valid, deleted, limit);
+				hash_map_destroy64(instance);
+			}
+		}
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #13                                                                  */
+/* ========================================================================= */
+
+int test_function_13(hash_map64_t *const hash_map)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *expected;
+	uint8_t *test;
+	int engine, memory, prefault;
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (memory = HASHSET_MEMORY_HEAP; memory <= HASHSET_MEMORY_HUGEPAGES; ++memory)
+	{
+		for (prefault = 0; prefault < 2; ++prefault)
+		{
+			for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+			{
+				memset(&options, 0, sizeof(hash_options_t));
+				options.engine = (hash_engine_t)engine;
+				options.memory = (hash_memory_t)memory;
+				options.prefault = prefault;
+
+				instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+				if (!instance)
+				{
+					puts("Allocation has failed!");
+					free(test);
+					free(expected);
+					return EXIT_FAILURE;
+				}
+
+				memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+
+				for (j = 0U; j < BUILD_RANGE; ++j)
+				{
+					expected[j] = ~((uint64_t)j);
+					if (hash_map_insert64(instance, j, expected[j], 0))
+					{
+						puts("Insert operation has failed!");
+						goto failure;
+					}
+					test[j] = 1U;
+				}
+
+				for (j = count = 0U; j < BUILD_RANGE; ++j)
+				{
+					if (j % 3U)
+					{
+						if (hash_map_remove64(instance, j, NULL))
+						{
+							puts("Remove operation has failed!");
+							goto failure;
+						}
+						test[j] = 0U;
+					}
+					else
+					{
+						++count;
+					}
+				}
+
+				if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+				{
+					goto failure;
+				}
+
+				if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+				{
+					fprintf(stdout, "[MAP %d/%d] memory: %d, prefault: %d, engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 13, TEST_COUNT, memory, prefault, engine, capacity, valid, deleted, limit);
+				}
+
+				hash_map_destroy64(instance);
+			}
+		}
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #14                                                                  */
+/* ========================================================================= */
+
+#define BUFFER_SIZE 1048576U
+
+typedef struct
+{
+	size_t allocs, frees;
+}
+alloc_stats_t;
+
+static void *counting_alloc(void *const context, const size_t size)
+{
+	++((alloc_stats_t*)context)->allocs;
+	return malloc(size);
+}
+
+static void counting_free(void *const context, void *const addr)
+{
+	if (addr)
+	{
+		++((alloc_stats_t*)context)->frees;
+	}
+	free(addr);
+}
+
+int test_function_14(hash_map64_t *const hash_map)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_map64_t *instance = NULL;
+	hash_allocator_t allocator;
+	hash_options_t options;
+	alloc_stats_t stats;
+	void *buffer;
+	uint64_t *expected;
+	uint8_t *test;
+	int engine;
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	buffer = malloc(BUFFER_SIZE);
+	if ((!test) || (!expected) || (!buffer))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	memset(&allocator, 0, sizeof(hash_allocator_t));
+	allocator.free = counting_free;
+	memset(&options, 0, sizeof(hash_options_t));
+	options.allocator = &allocator;
+
+	if (hash_map_create_ex64(0U, -1.0, clock(), &options))
+	{
+		puts("Invalid allocator was accepted!");
+		goto failure;
+	}
+
+	allocator.alloc = counting_alloc;
+	allocator.context = &stats;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&stats, 0, sizeof(alloc_stats_t));
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			free(test);
+			free(expected);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+
+		for (j = 0U; j < BUILD_RANGE; ++j)
+		{
+			expected[j] = ~((uint64_t)j);
+			if (hash_map_insert64(instance, j, expected[j], 0))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+			test[j] = 1U;
+		}
+
+		for (j = count = 0U; j < BUILD_RANGE; ++j)
+		{
+			if (j % 3U)
+			{
+				if (hash_map_remove64(instance, j, NULL))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+				test[j] = 0U;
+			}
+			else
+			{
+				++count;
+			}
+		}
+
+		if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+		instance = NULL;
+
+		if ((stats.allocs < 2U) || (stats.allocs != stats.frees))
+		{
+			printf("Allocator mismatch: allocs=%zu, frees=%zu\n", stats.allocs, stats.frees);
+			free(test);
+			free(expected);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		fprintf(stdout, "[MAP %d/%d] engine: %d, allocs: %010zu, frees: %010zu\n", 14, TEST_COUNT, engine, stats.allocs, stats.frees);
+	}
+
+	options.allocator = NULL;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		options.engine = (hash_engine_t)engine;
+
+		if (hash_map_init_in_buffer64(buffer, 16U, -1.0, clock(), &options))
+		{
+			puts("Undersized buffer was accepted!");
+			goto failure;
+		}
+
+		instance = hash_map_init_in_buffer64(buffer, BUFFER_SIZE, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Initialization has failed!");
+			free(test);
+			free(expected);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+
+		for (j = count = 0U; j < BUILD_RANGE; ++j, ++count)
+		{
+			expected[j] = ~((uint64_t)j);
+			if (hash_map_insert64(instance, j, expected[j], 0))
+			{
+				break;
+			}
+			test[j] = 1U;
+		}
+
+		if ((count < 1U) || (count >= BUILD_RANGE) || (hash_map_info64(instance, &capacity, &valid, &deleted, &limit)) || (valid != count))
+		{
+			puts("Buffer-backed instance did not fill up as expected!");
+			goto failure;
+		}
+
+		if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < BUILD_RANGE; j += 2U)
+		{
+			if (test[j])
+			{
+				if (hash_map_remove64(instance, j, NULL))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+				test[j] = 0U;
+				--count;
+			}
+		}
+
+		if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[MAP %d/%d] engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 14, TEST_COUNT, engine, capacity, valid, deleted, limit);
+		}
+
+		if (hash_map_clear64(instance) || hash_map_info64(instance, &j, &valid, &deleted, &limit) || (j != capacity) || valid)
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+	free(expected);
+	free(buffer);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test);
+	free(expected);
+	free(buffer);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #15                                                                  */
+/* ========================================================================= */
+
+int test_function_15(hash_map64_t *const hash_map)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t *expected;
+	uint8_t *test;
+	int engine, numa;
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (numa = HASHSET_NUMA_DEFAULT; numa <= HASHSET_NUMA_FIRST_TOUCH; ++numa)
+	{
+		for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.numa = (hash_numa_t)numa;
+			options.thread_count = 4U;
+
+			instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				free(test);
+				free(expected);
+				return EXIT_FAILURE;
+			}
+
+			memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+
+			for (j = 0U; j < BUILD_RANGE; ++j)
+			{
+				expected[j] = ~((uint64_t)j);
+				if (hash_map_insert64(instance, j, expected[j], 0))
+				{
+					puts("Insert operation has failed!");
+					goto failure;
+				}
+				test[j] = 1U;
+			}
+
+			for (j = count = 0U; j < BUILD_RANGE; ++j)
+			{
+				if (j % 3U)
+				{
+					if (hash_map_remove64(instance, j, NULL))
+					{
+						puts("Remove operation has failed!");
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+				else
+				{
+					++count;
+				}
+			}
+
+			if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] numa: %d, engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 15, TEST_COUNT, numa, engine, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+		}
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #16                                                                  */
+/* ========================================================================= */
+
+#define READER_COUNT 4U
+#define STABLE_COUNT 65536U
+#define CHURN_COUNT 262144U
+#define CHURN_ROUNDS 8U
+
+typedef struct
+{
+	hash_map64_t *instance;
+	volatile int *stop;
+	size_t id, lookups, errors;
+}
+reader_t;
+
+/* the keys of the "stable" range must always be found, the keys beyond the "churn" range must never be found */
+#if defined(_WIN32)
+static DWORD WINAPI reader_thread(void *const param)
+#else
+static void *reader_thread(void *const param)
+#endif
+{
+	reader_t *const reader = (reader_t*) param;
+	hash_map_reader64_t *const handle = hash_map_reader_attach64(reader->instance);
+	uint64_t value;
+	size_t k;
+
+	if (!handle)
+	{
+		++reader->errors;
+	}
+	else
+	{
+		for (k = reader->id; !(*reader->stop); k += 7919U)
+		{
+			if (hash_map_reader_get64(handle, k % STABLE_COUNT, &value) || (value != (((k % STABLE_COUNT) * 3U) + 1U)))
+			{
+				++reader->errors;
+			}
+			if (!hash_map_reader_contains64(handle, (STABLE_COUNT + CHURN_COUNT) + (k % STABLE_COUNT)))
+			{
+				++reader->errors;
+			}
+			reader->lookups += 2U;
+		}
+		hash_map_reader_detach64(handle);
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_readers(hash_map64_t *const instance, size_t *const lookups)
+{
+	reader_t readers[READER_COUNT];
+	size_t j, r, errors = 0U;
+	volatile int stop = 0;
+#if defined(_WIN32)
+	HANDLE threads[READER_COUNT];
+#else
+	pthread_t threads[READER_COUNT];
+#endif
+
+	for (j = 0U; j < STABLE_COUNT; ++j)
+	{
+		if (hash_map_insert64(instance, j, (j * 3U) + 1U, 0))
+		{
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (r = 0U; r < READER_COUNT; ++r)
+	{
+		memset(&readers[r], 0, sizeof(reader_t));
+		readers[r].instance = instance;
+		readers[r].stop = &stop;
+		readers[r].id = r;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, reader_thread, &readers[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, reader_thread, &readers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	/* the churn range grows the table, then the "deleted" slots force rebuilds at the same capacity */
+	for (r = 0U; r < CHURN_ROUNDS; ++r)
+	{
+		for (j = STABLE_COUNT; j < STABLE_COUNT + CHURN_COUNT; ++j)
+		{
+			if (hash_map_insert64(instance, j, j, 0))
+			{
+				puts("Insert operation has failed!");
+				errors = 1U;
+			}
+		}
+		for (j = STABLE_COUNT; j < STABLE_COUNT + CHURN_COUNT; ++j)
+		{
+			if (hash_map_remove64(instance, j, NULL))
+			{
+				puts("Remove operation has failed!");
+				errors = 1U;
+			}
+		}
+	}
+
+	stop = 1;
+
+	for (r = 0U; r < READER_COUNT; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += readers[r].errors;
+		*lookups += readers[r].lookups;
+	}
+
+	if (errors)
+	{
+		puts("Concurrent lookup has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return (hash_map_size64(instance) == STABLE_COUNT) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* a reader that stays attached, but is idle, must not hold back the release of the retired tables */
+static int check_idle_reader(const hash_options_t *const options)
+{
+	size_t j, r, live = 0U, allocs = 0U;
+	hash_map64_t *instance;
+	hash_map_reader64_t *reader;
+	hash_allocator_t allocator;
+	hash_options_t idle_options;
+	alloc_stats_t stats;
+	uint64_t value;
+
+	memset(&stats, 0, sizeof(alloc_stats_t));
+	memset(&allocator, 0, sizeof(hash_allocator_t));
+	allocator.alloc = counting_alloc;
+	allocator.free = counting_free;
+	allocator.context = &stats;
+	idle_options = *options;
+	idle_options.allocator = &allocator;
+
+	instance = hash_map_create_ex64(0U, -1.0, clock(), &idle_options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	reader = hash_map_reader_attach64(instance);
+	if ((!reader) || (hash_map_reader_get64(reader, 0U, &value) != ENOENT))
+	{
+		puts("Concurrent lookup has failed!");
+		goto failure;
+	}
+
+	for (r = 0U; r < CHURN_ROUNDS; ++r)
+	{
+		for (j = 0U; j < CHURN_COUNT; ++j)
+		{
+			if (hash_map_insert64(instance, j, j, 0))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+		for (j = 0U; j < CHURN_COUNT; ++j)
+		{
+			if (hash_map_remove64(instance, j, NULL))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+		if (!r)
+		{
+			live = stats.allocs - stats.frees;
+			allocs = stats.allocs;
+		}
+		else if (stats.allocs - stats.frees > live)
+		{
+			puts("Retired tables have not been released!");
+			goto failure;
+		}
+	}
+
+	if (stats.allocs == allocs)
+	{
+		puts("Table has not been re-built!");
+		goto failure;
+	}
+
+	hash_map_reader_detach64(reader);
+	hash_map_destroy64(instance);
+	return (stats.allocs == stats.frees) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+failure:
+	if (reader)
+	{
+		hash_map_reader_detach64(reader);
+	}
+	hash_map_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+int test_function_16(hash_map64_t *const hash_map)
+{
+	size_t lookups, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_map_reader64_t *readers[2U];
+	hash_options_t options;
+	int engine;
+
+	if (hash_map_reader_attach64(hash_map))
+	{
+		puts("Reader attached to an instance without concurrency support!");
+		return EXIT_FAILURE;
+	}
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = HASHSET_ENGINE_ROBINHOOD;
+	options.concurrency = HASHSET_CONCURRENCY_READERS;
+
+	instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+	if (instance)
+	{
+		puts("Unsupported engine has been accepted!");
+		hash_map_destroy64(instance);
+		return EXIT_FAILURE;
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SWISS; ++engine)
+	{
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			return EXIT_FAILURE;
+		}
+
+		readers[0U] = hash_map_reader_attach64(instance);
+		readers[1U] = hash_map_reader_attach64(instance);
+		if ((!readers[0U]) || (!readers[1U]) || (readers[0U] == readers[1U]))
+		{
+			puts("Reader could not be attached!");
+			goto failure;
+		}
+
+		hash_map_reader_detach64(readers[0U]);
+		hash_map_reader_detach64(readers[1U]);
+
+		lookups = 0U;
+		if (run_readers(instance, &lookups) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (check_idle_reader(&options) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[MAP %d/%d] engine: %d, lookups: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 16, TEST_COUNT, engine, lookups, capacity, valid, deleted, limit);
+		}
+
+		if (hash_map_clear64(instance) || hash_map_size64(instance) || (!hash_map_contains64(instance, 0U)))
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_map_destroy64(instance);
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #17                                                                  */
+/* ========================================================================= */
+
+#define WRITER_COUNT 4U
+#define WRITER_ITEMS 262144U
+#define SHARED_ITEMS 65536U
+
+typedef struct
+{
+	hash_map_concurrent64_t *instance;
+	size_t id, inserted, errors;
+}
+writer_t;
+
+/* each writer inserts its own share of the keys, then all writers race to insert (or update) the same keys; finally, each writer removes every other key of its own share */
+#if defined(_WIN32)
+static DWORD WINAPI writer_thread(void *const param)
+#else
+static void *writer_thread(void *const param)
+#endif
+{
+	writer_t *const writer = (writer_t*) param;
+	size_t k;
+	uint64_t value;
+	errno_t error;
+
+	for (k = writer->id; k < WRITER_ITEMS; k += WRITER_COUNT)
+	{
+		if (hash_map_concurrent_insert64(writer->instance, k, (k * 3U) + 1U, 0))
+		{
+			++writer->errors;
+		}
+	}
+
+	for (k = WRITER_ITEMS; k < WRITER_ITEMS + SHARED_ITEMS; ++k)
+	{
+		if (!(error = hash_map_concurrent_insert64(writer->instance, k, (k * 3U) + 1U, 1)))
+		{
+			++writer->inserted;
+		}
+		else if (error != EEXIST)
+		{
+			++writer->errors;
+		}
+	}
+
+	for (k = writer->id; k < WRITER_ITEMS; k += WRITER_COUNT)
+	{
+		if (((k / WRITER_COUNT) & 1U) && (hash_map_concurrent_remove64(writer->instance, k, &value) || (value != (k * 3U) + 1U)))
+		{
+			++writer->errors;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_writers(hash_map_concurrent64_t *const instance)
+{
+	writer_t writers[WRITER_COUNT];
+	size_t r, k, inserted = 0U, errors = 0U;
+	uint64_t value;
+#if defined(_WIN32)
+	HANDLE threads[WRITER_COUNT];
+#else
+	pthread_t threads[WRITER_COUNT];
+#endif
+
+	for (r = 0U; r < WRITER_COUNT; ++r)
+	{
+		memset(&writers[r], 0, sizeof(writer_t));
+		writers[r].instance = instance;
+		writers[r].id = r;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, writer_thread, &writers[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, writer_thread, &writers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < WRITER_COUNT; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += writers[r].errors;
+		inserted += writers[r].inserted;
+	}
+
+	if (errors || (inserted != SHARED_ITEMS))
+	{
+		puts("Concurrent update has failed!");
+		return EXIT_FAILURE;
+	}
+
+	if (hash_map_concurrent_size64(instance) != (WRITER_ITEMS / 2U) + SHARED_ITEMS)
+	{
+		puts("Invalid size!");
+		return EXIT_FAILURE;
+	}
+
+	for (k = 0U; k < WRITER_ITEMS + SHARED_ITEMS; ++k)
+	{
+		if ((k < WRITER_ITEMS) && ((k / WRITER_COUNT) & 1U))
+		{
+			if (hash_map_concurrent_contains64(instance, k) != ENOENT)
+			{
+				puts("Removed key has been found!");
+				return EXIT_FAILURE;
+			}
+		}
+		else if (hash_map_concurrent_get64(instance, k, &value) || (value != (k * 3U) + 1U))
+		{
+			puts("Lookup operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_17(hash_map64_t *const hash_map)
+{
+	static const size_t SHARD_COUNT[] = { 1U, 0U, 1000U };
+	hash_map_concurrent64_t *instance;
+	hash_options_t options;
+	size_t s;
+	int engine;
+
+	UNUSED(hash_map);
+	memset(&options, 0, sizeof(hash_options_t));
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (s = 0U; s < sizeof(SHARD_COUNT) / sizeof(SHARD_COUNT[0U]); ++s)
+		{
+			options.engine = (hash_engine_t)engine;
+			options.shard_count = SHARD_COUNT[s];
+
+			instance = hash_map_concurrent_create64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				return EXIT_FAILURE;
+			}
+
+			if (run_writers(instance) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			fprintf(stdout, "[MAP %d/%d] engine: %d, shards: %04zu, size: %010zu\n", 17, TEST_COUNT, engine, SHARD_COUNT[s], hash_map_concurrent_size64(instance));
+
+			if (hash_map_concurrent_clear64(instance) || hash_map_concurrent_size64(instance) || (!hash_map_concurrent_contains64(instance, 0U)) || (hash_map_concurrent_clear64(instance) != EAGAIN))
+			{
+				puts("Clear operation has failed!");
+				goto failure;
+			}
+
+			hash_map_concurrent_destroy64(instance);
+		}
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_concurrent_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #18                                                                  */
+/* ========================================================================= */
+
+#define COUNTER_THREADS 4U
+#define COUNTER_KEYS 131072U
+
+#define COUNTER_KEY(K,X) (((uint64_t)(K) * UINT64_C(0x9E3779B97F4A7C15)) + (X))
+
+#define OWNER_KEYS 1024U
+#define OWNER_ROUNDS 64U
+
+typedef struct
+{
+	hash_map_lockfree64_t *instance;
+	size_t id, inserted, errors;
+	int owner;
+}
+counter_t;
+
+/* each thread owns its keys, so that the previous value of every update is known exactly, even though the other threads keep the table growing meanwhile */
+static void update_owned(counter_t *const counter)
+{
+	size_t r, k;
+	uint64_t previous;
+	errno_t error;
+
+	for (r = 0U; r < OWNER_ROUNDS; ++r)
+	{
+		for (k = 0U; k < OWNER_KEYS; ++k)
+		{
+			error = hash_map_lockfree_fetch_add64(counter->instance, COUNTER_KEY((counter->id * OWNER_KEYS) + k, 2), 1U, &previous);
+			if ((error != (r ? EEXIST : 0)) || (previous != r))
+			{
+				++counter->errors;
+			}
+			if (hash_map_lockfree_fetch_or64(counter->instance, COUNTER_KEY((((r * COUNTER_THREADS) + counter->id) * OWNER_KEYS) + k, 3), 1U, NULL))
+			{
+				++counter->errors;
+			}
+			counter->inserted += (!error) ? 2U : 1U;
+		}
+	}
+}
+
+/* all threads update the same keys, starting at different offsets; every key is only ever updated by one kind of operation */
+static void update_shared(counter_t *const counter)
+{
+	size_t i, j, k;
+	errno_t error[3U];
+
+	for (i = 0U; i < COUNTER_KEYS; ++i)
+	{
+		k = (i + (counter->id * (COUNTER_KEYS / COUNTER_THREADS))) % COUNTER_KEYS;
+		error[0U] = hash_map_lockfree_fetch_add64(counter->instance, COUNTER_KEY(k, -1), 1U, NULL);
+		error[1U] = hash_map_lockfree_fetch_max64(counter->instance, COUNTER_KEY(k, 0), (counter->id * COUNTER_KEYS) + k, NULL);
+		error[2U] = hash_map_lockfree_fetch_or64(counter->instance, COUNTER_KEY(k, 1), UINT64_C(1) << counter->id, NULL);
+		for (j = 0U; j < 3U; ++j)
+		{
+			if (!error[j])
+			{
+				++counter->inserted;
+			}
+			else if (error[j] != EEXIST)
+			{
+				++counter->errors;
+			}
+		}
+	}
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI counter_thread(void *const param)
+#else
+static void *counter_thread(void *const param)
+#endif
+{
+	counter_t *const counter = (counter_t*) param;
+
+	if (counter->owner)
+	{
+		update_owned(counter);
+	}
+	else
+	{
+		update_shared(counter);
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_counters(hash_map_lockfree64_t *const instance, const int owner)
+{
+	const size_t expected = owner ? (COUNTER_THREADS * OWNER_KEYS * (OWNER_ROUNDS + 1U)) : (3U * COUNTER_KEYS);
+	counter_t counters[COUNTER_THREADS];
+	size_t r, inserted = 0U, errors = 0U;
+#if defined(_WIN32)
+	HANDLE threads[COUNTER_THREADS];
+#else
+	pthread_t threads[COUNTER_THREADS];
+#endif
+
+	for (r = 0U; r < COUNTER_THREADS; ++r)
+	{
+		memset(&counters[r], 0, sizeof(counter_t));
+		counters[r].instance = instance;
+		counters[r].id = r;
+		counters[r].owner = owner;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, counter_thread, &counters[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, counter_thread, &counters[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < COUNTER_THREADS; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += counters[r].errors;
+		inserted += counters[r].inserted;
+	}
+
+	if (errors || (inserted != expected) || (hash_map_lockfree_size64(instance) != expected))
+	{
+		puts("Concurrent update has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static int check_counters(const hash_map_lockfree64_t *const instance, const hash_map64_t *const snapshot)
+{
+	size_t k, j;
+	uint64_t value[2U];
+
+	for (k = 0U; k < COUNTER_KEYS; ++k)
+	{
+		static const int64_t OFFSET[3U] = { -1, 0, 1 };
+		const uint64_t expected[3U] = { COUNTER_THREADS, ((COUNTER_THREADS - 1U) * COUNTER_KEYS) + k, (UINT64_C(1) << COUNTER_THREADS) - 1U };
+		for (j = 0U; j < 3U; ++j)
+		{
+			if (hash_map_lockfree_get64(instance, COUNTER_KEY(k, OFFSET[j]), &value[0U]) || hash_map_get64(snapshot, COUNTER_KEY(k, OFFSET[j]), &value[1U]) || (value[0U] != expected[j]) || (value[1U] != expected[j]))
+			{
+				puts("Lookup operation has failed!");
+				return EXIT_FAILURE;
+			}
+		}
+		if (hash_map_lockfree_get64(instance, COUNTER_KEY(k, 2), NULL) != ENOENT)
+		{
+			puts("Lookup operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_18(hash_map64_t *const hash_map)
+{
+	hash_map_lockfree64_t *instance = NULL;
+	hash_map64_t *snapshot;
+	hash_options_t options;
+	uint64_t previous;
+	int probe;
+
+	UNUSED(hash_map);
+	memset(&options, 0, sizeof(hash_options_t));
+
+	snapshot = hash_map_create64(0U, -1.0, clock());
+	if (!snapshot)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (probe = HASHSET_PROBE_DEFAULT; probe <= HASHSET_PROBE_QUADRATIC; ++probe)
+	{
+		options.probe_strategy = (hash_probe_t)probe;
+
+		instance = hash_map_lockfree_create64(1U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			goto failure;
+		}
+
+		if (run_counters(instance, 0) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (hash_map_lockfree_snapshot64(instance, snapshot) || (hash_map_size64(snapshot) != 3U * COUNTER_KEYS) || (check_counters(instance, snapshot) != EXIT_SUCCESS))
+		{
+			puts("Snapshot has failed!");
+			goto failure;
+		}
+
+		if (hash_map_lockfree_fetch_add64(instance, COUNTER_KEY(1U, 0), 42U, &previous) != EEXIST || (previous != ((COUNTER_THREADS - 1U) * COUNTER_KEYS) + 1U) || hash_map_lockfree_fetch_max64(instance, 42U, 7U, &previous) || (previous != 0U))
+		{
+			puts("Update operation has failed!");
+			goto failure;
+		}
+
+		fprintf(stdout, "[MAP %d/%d] probe: %d, size: %010zu\n", 18, TEST_COUNT, probe, hash_map_lockfree_size64(instance));
+		hash_map_lockfree_destroy64(instance);
+
+		/* the previous values must be exact, while the entries are migrated to a larger table over and over again */
+		instance = hash_map_lockfree_create64(1U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			goto failure;
+		}
+
+		if (run_counters(instance, 1) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		hash_map_lockfree_destroy64(instance);
+		instance = NULL;
+	}
+
+	hash_map_destroy64(snapshot);
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_lockfree_destroy64(instance);
+	}
+	hash_map_destroy64(snapshot);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #19                                                                  */
+/* ========================================================================= */
+
+#define UPSERT_SIZE 65521U
+
+#define UPSERT_KEY(X) (((uint64_t)(X)) - 1U) /*the first two keys are the sentinel values*/
+
+static uint64_t upsert_callback(const uint64_t key, const uint64_t current, const uint64_t value, void *const context)
+{
+	UNUSED(key);
+	++(*((size_t*)context));
+	return (current * 3U) + value;
+}
+
+int test_function_19(hash_map64_t *const hash_map)
+{
+	size_t r, j, calls, expected_calls, capacity, valid, deleted, limit;
+	hash_map64_t *instance;
+	hash_options_t options;
+	uint64_t value, previous, *slot, *test_val;
+	uint8_t *test_key;
+	int engine, resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test_key = (uint8_t*) malloc(UPSERT_SIZE * sizeof(uint8_t));
+	if (!test_key)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	test_val = (uint64_t*) malloc(UPSERT_SIZE * sizeof(uint64_t));
+	if (!test_val)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.resize = (hash_resize_t)resize;
+
+			instance = hash_map_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				return EXIT_FAILURE;
+			}
+
+			memset(test_key, 0, UPSERT_SIZE * sizeof(uint8_t));
+			calls = expected_calls = 0U;
+
+			for (r = 0U; r < 32U * UPSERT_SIZE; ++r)
+			{
+				const size_t rnd = random_next(&random) % UPSERT_SIZE;
+				const uint64_t key = UPSERT_KEY(rnd), operand = random_next(&random);
+				const uint64_t current = test_key[rnd] ? test_val[rnd] : 0U;
+				switch (random_next(&random) % 8U)
+				{
+				case 0U:
+					error = hash_map_upsert64(instance, key, operand, HASHSET_ACCUMULATE_ADD);
+					test_val[rnd] = test_key[rnd] ? (current + operand) : operand;
+					break;
+				case 1U:
+					error = hash_map_upsert64(instance, key, operand, HASHSET_ACCUMULATE_MIN);
+					test_val[rnd] = (test_key[rnd] && (current < operand)) ? current : operand;
+					break;
+				case 2U:
+					error = hash_map_upsert64(instance, key, operand, HASHSET_ACCUMULATE_MAX);
+					test_val[rnd] = (test_key[rnd] && (current > operand)) ? current : operand;
+					break;
+				case 3U:
+					error = hash_map_upsert64(instance, key, operand, HASHSET_ACCUMULATE_XOR);
+					test_val[rnd] = current ^ operand;
+					break;
+				case 4U:
+					error = hash_map_upsert_callback64(instance, key, operand, upsert_callback, &calls);
+					test_val[rnd] = test_key[rnd] ? ((current * 3U) + operand) : operand;
+					expected_calls += test_key[rnd] ? 1U : 0U;
+					break;
+				case 5U:
+					slot = NULL;
+					if ((!(error = hash_map_get_or_insert64(instance, key, operand, &slot)) || (error == EEXIST)) && slot)
+					{
+						*slot += 1U;
+					}
+					test_val[rnd] = (test_key[rnd] ? current : operand) + 1U;
+					break;
+				case 6U:
+					previous = ~current;
+					error = hash_map_exchange64(instance, key, operand, &previous);
+					if (test_key[rnd] && (previous != current))
+					{
+						puts("Exchange operation has returned a wrong value!");
+						goto failure;
+					}
+					test_val[rnd] = operand;
+					break;
+				default:
+					error = hash_map_remove64(instance, key, &value);
+					if (error != (test_key[rnd] ? 0 : ENOENT))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+					test_key[rnd] = 0U;
+					continue;
+				}
+				if (error != (test_key[rnd] ? EEXIST : 0))
+				{
+					printf("Upsert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test_key[rnd] = 1U;
+			}
+
+			for (j = 0U; j < UPSERT_SIZE; ++j)
+			{
+				error = hash_map_get64(instance, UPSERT_KEY(j), &value);
+				if ((error != (test_key[j] ? 0 : ENOENT)) || (test_key[j] && (value != test_val[j])))
+				{
+					puts("Value mismatch has been detected!");
+					goto failure;
+				}
+			}
+
+			if (calls != expected_calls)
+			{
+				puts("Callback has been invoked a wrong number of times!");
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 19, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+		}
+	}
+
+	free(test_key);
+	free(test_val);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_map_destroy64(instance);
+	free(test_key);
+	free(test_val);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #20                                                                  */
+/* ========================================================================= */
+
+#define EXPORT_SIZE 262144U
+
+#define EXPORT_KEY(X) (((uint64_t)(X)) - 1U) /*the first two keys are the sentinel values*/
+#define EXPORT_VALUE(X) ((((uint64_t)(X)) * UINT64_C(0x9E3779B97F4A7C15)) ^ UINT64_C(0x5555))
+
+static uint64_t export_value(const size_t index)
+{
+	return EXPORT_VALUE(EXPORT_KEY(index));
+}
+
+static const size_t EXPORT_CHUNKS[] = { 1U, 7U, 64U, 4093U, EXPORT_SIZE };
+
+static int verify_export(const hash_map64_t *const instance, const uint8_t *const test, uint64_t *const expected, uint64_t *const actual)
+{
+	size_t k, cursor, count, total, chunk;
+	uint64_t key, value;
+	errno_t error;
+
+	for (cursor = 0U, count = 0U; !hash_map_iterate64(instance, &cursor, &key, &value); ++count)
+	{
+		if ((count >= EXPORT_SIZE) || (!test[(size_t)(key + 1U)]) || (value != EXPORT_VALUE(key)))
+		{
+			puts("Iteration has returned an unexpected entry!");
+			return EXIT_FAILURE;
+		}
+		expected[count] = key;
+		expected[EXPORT_SIZE + count] = value;
+	}
+
+	if (count != hash_map_size64(instance))
+	{
+		puts("Iteration has returned a wrong number of entries!");
+		return EXIT_FAILURE;
+	}
+
+	for (k = 0U; k < 3U * (sizeof(EXPORT_CHUNKS) / sizeof(EXPORT_CHUNKS[0U])); ++k)
+	{
+		const size_t limit = EXPORT_CHUNKS[k / 3U], columns = k % 3U; /*0: keys and values, 1: keys only, 2: values only*/
+		memset(actual, 0, 2U * EXPORT_SIZE * sizeof(uint64_t));
+		for (cursor = 0U, total = 0U; !(error = hash_map_export64(instance, &cursor, (columns != 2U) ? (actual + total) : NULL, (columns != 1U) ? (actual + EXPORT_SIZE + total) : NULL, limit, &chunk)); total += chunk)
+		{
+			if ((!chunk) || (chunk > limit) || (total + chunk > count))
+			{
+				puts("Export has returned a wrong number of entries!");
+				return EXIT_FAILURE;
+			}
+		}
+		if ((error != ENOENT) || (cursor != SIZE_MAX) || (total != count))
+		{
+			puts("Export has returned a wrong number of entries!");
+			return EXIT_FAILURE;
+		}
+		if (((columns != 2U) && memcmp(expected, actual, count * sizeof(uint64_t))) || ((columns != 1U) && memcmp(expected + EXPORT_SIZE, actual + EXPORT_SIZE, count * sizeof(uint64_t))))
+		{
+			puts("Export has returned unexpected entries!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_20(hash_map64_t *const hash_map)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_map64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected, *actual, value;
+	uint8_t *test;
+	int engine, resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(EXPORT_SIZE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(2U * EXPORT_SIZE * sizeof(uint64_t));
+	actual = (uint64_t*) malloc(2U * EXPORT_SIZE * sizeof(uint64_t));
+	if ((!test) || (!expected) || (!actual))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, HASHSET_LAYOUT_DEFAULT, test, EXPORT_SIZE, EXPORT_SIZE / 4U, export_value)))
+			{
+				goto failure;
+			}
+
+			if (verify_export(instance, test, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			/* remove most of the keys, so that the table is sparse */
+			for (j = 0U; j < EXPORT_SIZE; ++j)
+			{
+				if (test[j] && (random_next(&random) % 16U))
+				{
+					if ((error = hash_map_remove64(instance, EXPORT_KEY(j), &value)))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+			}
+
+			if (verify_export(instance, test, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 20, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+			instance = NULL;
+		}
+	}
+
+	free(test);
+	free(expected);
+	free(actual);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_destroy64(instance);
+	}
+	free(test);
+	free(expected);
+	free(actual);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #21                                                                  */
+/* ========================================================================= */
+
+#define SCAN_SIZE 524288U
+#define SCAN_CHUNK 1000U
+#define SCAN_THREADS 4U
+#define SCAN_PARTS 64U
+
+#define SCAN_KEY(X) (((uint64_t)(X)) - 1U) /*the first two keys are the sentinel values*/
+#define SCAN_VALUE(X) ((((uint64_t)(X)) * UINT64_C(0x9E3779B97F4A7C15)) ^ UINT64_C(0x3333))
+
+static uint64_t scan_value(const size_t index)
+{
+	return SCAN_VALUE(SCAN_KEY(index));
+}
+
+static const size_t SCAN_SPLITS[] = { 1U, 3U, 8U, 61U };
+
+typedef struct
+{
+	size_t count[SCAN_PARTS];
+	uint64_t checksum[SCAN_PARTS];
+	size_t calls, limit;
+}
+scan_state_t;
+
+static int scan_callback(const uint64_t *const keys, const uint64_t *const values, const size_t count, const size_t part, void *const context)
+{
+	scan_state_t *const state = (scan_state_t*) context;
+	size_t i;
+
+	if ((part >= SCAN_PARTS) || (!count))
+	{
+		abort(); /*this should never happen!*/
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		if (values[i] != SCAN_VALUE(keys[i]))
+		{
+			abort(); /*value mismatch!*/
+		}
+		state->checksum[part] += keys[i] ^ (values[i] >> 7);
+	}
+
+	state->count[part] += count;
+	return (state->limit == SIZE_MAX) || (++state->calls < state->limit); /*the calls are counted only in single-threaded scans*/
+}
+
+static int verify_scan(const hash_map64_t *const instance, uint64_t *const expected, uint64_t *const actual)
+{
+	size_t j, k, cursor, count, total, chunk;
+	size_t bounds[SCAN_PARTS + 1U];
+	uint64_t key, value, checksum = 0U;
+	scan_state_t state;
+	errno_t error;
+
+	for (cursor = 0U, count = 0U; !hash_map_iterate64(instance, &cursor, &key, &value); ++count)
+	{
+		expected[count] = key;
+		expected[SCAN_SIZE + count] = value;
+		checksum += key ^ (value >> 7);
+	}
+
+	/* the ranges, concatenated in order, must yield the same sequence as the plain iteration */
+	for (k = 0U; k < sizeof(SCAN_SPLITS) / sizeof(SCAN_SPLITS[0U]); ++k)
+	{
+		if (hash_map_split64(instance, SCAN_SPLITS[k], bounds) || bounds[0U])
+		{
+			puts("Split operation has failed!");
+			return EXIT_FAILURE;
+		}
+		for (j = 0U, total = 0U; j < SCAN_SPLITS[k]; ++j)
+		{
+			if (bounds[j] > bounds[j + 1U])
+			{
+				puts("Split operation has returned overlapping ranges!");
+				return EXIT_FAILURE;
+			}
+			for (cursor = bounds[j]; !(error = hash_map_export_range64(instance, &cursor, bounds[j + 1U], actual + total, actual + SCAN_SIZE + total, SCAN_CHUNK, &chunk)); total += chunk)
+			{
+				if ((!chunk) || (chunk > SCAN_CHUNK) || (total + chunk > count) || (cursor > bounds[j + 1U]))
+				{
+					puts("Range export has returned a wrong number of entries!");
+					return EXIT_FAILURE;
+				}
+			}
+			if (error != ENOENT)
+			{
+				printf("Range export has failed! (error: %d)\n", error);
+				return EXIT_FAILURE;
+			}
+		}
+		if ((total != count) || memcmp(expected, actual, count * sizeof(uint64_t)) || memcmp(expected + SCAN_SIZE, actual + SCAN_SIZE, count * sizeof(uint64_t)))
+		{
+			puts("Range export has returned unexpected entries!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	memset(&state, 0, sizeof(scan_state_t));
+	state.limit = SIZE_MAX;
+	if ((error = hash_map_parallel_for64(instance, SCAN_THREADS, scan_callback, &state)))
+	{
+		printf("Parallel scan has failed! (error: %d)\n", error);
+		return EXIT_FAILURE;
+	}
+
+	for (j = 0U, total = 0U, key = 0U; j < SCAN_PARTS; ++j)
+	{
+		total += state.count[j];
+		key += state.checksum[j];
+	}
+
+	if ((total != count) || (key != checksum))
+	{
+		puts("Parallel scan has returned unexpected entries!");
+		return EXIT_FAILURE;
+	}
+
+	memset(&state, 0, sizeof(scan_state_t));
+	state.limit = 1U;
+	if ((error = hash_map_parallel_for64(instance, 1U, scan_callback, &state)) != ECANCELED)
+	{
+		printf("Parallel scan was not cancelled! (error: %d)\n", error);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_21(hash_map64_t *const hash_map)
+{
+	size_t capacity, valid, deleted, limit;
+	hash_map64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected, *actual;
+	int engine, resize;
+
+	UNUSED(hash_map);
+
+	expected = (uint64_t*) malloc(2U * SCAN_SIZE * sizeof(uint64_t));
+	actual = (uint64_t*) malloc(2U * SCAN_SIZE * sizeof(uint64_t));
+	if ((!expected) || (!actual))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, HASHSET_LAYOUT_DEFAULT, NULL, SCAN_SIZE, SCAN_SIZE / 2U, scan_value)))
+			{
+				goto failure;
+			}
+
+			if (verify_scan(instance, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 21, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+			instance = NULL;
+		}
+	}
+
+	free(expected);
+	free(actual);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_destroy64(instance);
+	}
+	free(expected);
+	free(actual);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #22                                                                  */
+/* ========================================================================= */
+
+#define SAVE_SIZE 262144U
+
+#define SAVE_KEY(X) (((uint64_t)(X)) - 1U) /*the first two keys are the sentinel values*/
+#define SAVE_VALUE(X,Y) (((((uint64_t)(X)) * UINT64_C(0x9E3779B97F4A7C15)) ^ UINT64_C(0x7777)) + (Y))
+
+static uint64_t save_value(const size_t index)
+{
+	return SAVE_VALUE(index, 1U);
+}
+
+static int verify_load(const hash_map64_t *const instance, const uint8_t *const test)
+{
+	size_t j, count;
+	uint64_t value;
+	errno_t error;
+
+	for (j = 0U, count = 0U; j < SAVE_SIZE; ++j)
+	{
+		if ((error = hash_map_get64(instance, SAVE_KEY(j), &value)) != (test[j] ? 0 : ENOENT))
+		{
+			printf("Loaded map has returned a wrong result! (error: %d)\n", error);
+			return EXIT_FAILURE;
+		}
+		if (test[j] && (value != SAVE_VALUE(j, test[j])))
+		{
+			puts("Loaded map has returned a wrong value!");
+			return EXIT_FAILURE;
+		}
+		count += (test[j] != 0U);
+	}
+
+	if (hash_map_size64(instance) != count)
+	{
+		puts("Loaded map has a wrong size!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_22(hash_map64_t *const hash_map)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_map64_t *instance = NULL;
+	hash_options_t options;
+	FILE *file = NULL;
+	uint64_t value;
+	uint8_t *test, *saved;
+	int engine, resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(SAVE_SIZE * sizeof(uint8_t));
+	saved = (uint8_t*) malloc(SAVE_SIZE * sizeof(uint8_t));
+	if ((!test) || (!saved))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, (resize == HASHSET_RESIZE_BLOCKING) ? HASHSET_LAYOUT_SOA : HASHSET_LAYOUT_AOS, test, SAVE_SIZE, SAVE_SIZE / 4U, save_value)))
+			{
+				goto failure;
+			}
+
+			for (j = 0U; j < SAVE_SIZE; ++j)
+			{
+				if (test[j] && (!(random_next(&random) % 4U)))
+				{
+					if ((error = hash_map_remove64(instance, SAVE_KEY(j), &value)))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+			}
+
+			if (!(file = tmpfile()))
+			{
+				puts("Failed to create the temporary file!");
+				goto failure;
+			}
+
+			if ((error = hash_map_save64(instance, fileno(file))))
+			{
+				printf("Save operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+
+			hash_map_destroy64(instance);
+			instance = NULL;
+			memcpy(saved, test, SAVE_SIZE * sizeof(uint8_t));
+
+			/* the table of the mapped map is modified, which must not affect the file */
+			fseek(file, 0L, SEEK_SET);
+			if (!(instance = hash_map_load64(fileno(file), HASHSET_LOAD_MMAP, &options)))
+			{
+				puts("Load operation has failed!");
+				goto failure;
+			}
+
+			if (verify_load(instance, test) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			for (j = 0U; j < SAVE_SIZE; ++j)
+			{
+				if (test[j] && (!(j % 3U)))
+				{
+					error = hash_map_remove64(instance, SAVE_KEY(j), &value);
+					test[j] = 0U;
+				}
+				else
+				{
+					error = hash_map_insert64(instance, SAVE_KEY(j), SAVE_VALUE(j, 2U), 1);
+					error = (error == EEXIST) ? 0 : error;
+					test[j] = 2U;
+				}
+				if (error)
+				{
+					printf("Update of the loaded map has failed! (error: %d)\n", error);
+					goto failure;
+				}
+			}
+
+			if (verify_load(instance, test) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			hash_map_destroy64(instance);
+			instance = NULL;
+
+			fseek(file, 0L, SEEK_SET);
+			if (!(instance = hash_map_load64(fileno(file), HASHSET_LOAD_READ, &options)))
+			{
+				puts("Load operation has failed!");
+				goto failure;
+			}
+
+			if (verify_load(instance, saved) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[MAP %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 22, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_map_destroy64(instance);
+			instance = NULL;
+
+			/* a file that was written for a different key size must be rejected */
+			fseek(file, 0L, SEEK_SET);
+			if (hash_map_load32(fileno(file), HASHSET_LOAD_READ, &options))
+			{
+				puts("Mismatching file has been loaded!");
+				goto failure;
+			}
+
+			fclose(file);
+			file = NULL;
+		}
+	}
+
+	free(test);
+	free(saved);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_destroy64(instance);
+	}
+	if (file)
+	{
+		fclose(file);
+	}
+	free(test);
+	free(saved);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #23                                                                  */
+/* ========================================================================= */
+
+#define STASH_SIZE 8U
+#define STASH_ITEMS 4096U
+#define STASH_ATTEMPTS 4096U
+
+/* the stash of the cuckoo engine is located right after the last bucket, i.e., it starts at the capacity */
+static size_t stash_count(const hash_map64_t *const instance)
+{
+	uint64_t keys[STASH_SIZE], values[STASH_SIZE];
+	size_t capacity, cursor, count;
+
+	if (hash_map_info64(instance, &capacity, NULL, NULL, NULL))
+	{
+		return 0U;
+	}
+
+	cursor = capacity;
+	return hash_map_export_range64(instance, &cursor, capacity + STASH_SIZE, keys, values, STASH_SIZE, &count) ? 0U : count;
+}
+
+static int remove_random(hash_map64_t *const instance, uint8_t *const test, const uint64_t *const expected, size_t *const count, random_t *const random)
+{
+	size_t j;
+	uint64_t value;
+	errno_t error;
+
+	for (j = 0U; j < BUILD_RANGE; ++j)
+	{
+		if (test[j] && (!(random_next(random) % 2U)))
+		{
+			if ((error = hash_map_remove64(instance, (uint64_t)j, &value)) || (value != expected[j]))
+			{
+				printf("Remove operation has failed! (error: %d)\n", error);
+				return EXIT_FAILURE;
+			}
+			test[j] = 0U;
+			--*count;
+		}
+	}
+
+	return verify_contents(instance, test, expected, *count);
+}
+
+int test_function_23(hash_map64_t *const hash_map)
+{
+	size_t j, count, attempt, capacity, valid, deleted, limit, initial, stashed;
+	hash_map64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected;
+	uint8_t *test;
+	int resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = HASHSET_ENGINE_CUCKOO;
+		options.resize = (hash_resize_t)resize;
+
+		/* at this load factor, a small table often runs out of room in both buckets of a key before it grows, so that the entry ends up in the stash; retry with a different seed otherwise */
+		for (attempt = 0U, stashed = 0U; (attempt < STASH_ATTEMPTS) && (!stashed); ++attempt)
+		{
+			if (instance)
+			{
+				hash_map_destroy64(instance);
+			}
+
+			instance = hash_map_create_ex64(1U, 0.95, random_next(&random), &options);
+			if ((!instance) || hash_map_info64(instance, &initial, NULL, NULL, NULL))
+			{
+				puts("Allocation has failed!");
+				goto failure;
+			}
+
+			memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+			for (count = 0U; (count < STASH_ITEMS) && (!stashed); ++count)
+			{
+				expected[count] = random_next(&random);
+				if ((error = hash_map_insert64(instance, (uint64_t)count, expected[count], 0)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[count] = 1U;
+				if (hash_map_info64(instance, &capacity, NULL, NULL, NULL) || (capacity != initial))
+				{
+					break;
+				}
+				stashed = stash_count(instance);
+			}
+		}
+
+		if (!stashed)
+		{
+			puts("The stash has not been used!");
+			goto failure;
+		}
+
+		/* the entries in the stash must remain reachable, while other entries are removed and the table grows */
+		if ((verify_contents(instance, test, expected, count) != EXIT_SUCCESS) || (remove_random(instance, test, expected, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < STASH_ITEMS; ++j)
+		{
+			if (!test[j])
+			{
+				expected[j] = random_next(&random);
+				if ((error = hash_map_insert64(instance, (uint64_t)j, expected[j], 0)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[j] = 1U;
+				++count;
+			}
+		}
+
+		if (hash_map_info64(instance, &capacity, NULL, NULL, NULL) || (capacity == initial))
+		{
+			puts("The table has not grown!");
+			goto failure;
+		}
+
+		if ((verify_contents(instance, test, expected, count) != EXIT_SUCCESS) || (remove_random(instance, test, expected, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[MAP %d/%d] resize: %d, attempts: %04zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 23, TEST_COUNT, resize, attempt, capacity, valid, deleted, limit);
+		}
+
+		hash_map_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_destroy64(instance);
+	}
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #24                                                                  */
+/* ========================================================================= */
+
+int test_function_24(hash_map64_t *const hash_map)
+{
+	size_t j, count, inserted, capacity, valid, deleted, limit, previous[3U];
+	hash_map64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected;
+	uint8_t *test;
+	int resize, overflow;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_map);
+
+	test = (uint8_t*) malloc(BUILD_RANGE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(BUILD_RANGE * sizeof(uint64_t));
+	if ((!test) || (!expected))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = HASHSET_ENGINE_ROBINHOOD;
+		options.resize = (hash_resize_t)resize;
+
+		/* at this load factor, the probe distance of some entry exceeds DIST_MAX long before the table is full */
+		instance = hash_map_create_ex64(1U, 1.0, random_next(&random), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			goto failure;
+		}
+
+		/* a table that grows before its limit has been reached can only have run out of probe distance */
+		memset(test, 0, BUILD_RANGE * sizeof(uint8_t));
+		memset(previous, 0, sizeof(previous));
+		for (inserted = 0U, overflow = 0; (inserted < BUILD_RANGE) && (!overflow); ++inserted)
+		{
+			expected[inserted] = random_next(&random);
+			if ((error = hash_map_insert64(instance, (uint64_t)inserted, expected[inserted], 0)))
+			{
+				printf("Insert operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+			test[inserted] = 1U;
+			if (!hash_map_info64(instance, &capacity, &valid, NULL, &limit))
+			{
+				overflow = previous[0U] && (capacity != previous[0U]) && (previous[1U] + 1U < previous[2U]);
+				previous[0U] = capacity;
+				previous[1U] = valid;
+				previous[2U] = limit;
+			}
+		}
+
+		if (!overflow)
+		{
+			puts("The probe distance has not overflowed!");
+			goto failure;
+		}
+
+		count = inserted;
+		if ((verify_contents(instance, test, expected, count) != EXIT_SUCCESS) || (remove_random(instance, test, expected, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < inserted; ++j)
+		{
+			if (!test[j])
+			{
+				expected[j] = random_next(&random);
+				if ((error = hash_map_insert64(instance, (uint64_t)j, expected[j], 0)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[j] = 1U;
+				++count;
+			}
+		}
+
+		if (verify_contents(instance, test, expected, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_map_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[MAP %d/%d] resize: %d, inserted: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 24, TEST_COUNT, resize, inserted, capacity, valid, deleted, limit);
+		}
+
+		hash_map_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+	free(expected);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_map_destroy64(instance);
+	}
+	free(test);
+	free(expected);
+	return EXIT_FAILURE;
+}
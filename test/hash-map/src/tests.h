@@ -12,5 +12,25 @@ int test_function_1(hash_map64_t *const hash_set);
 int test_function_2(hash_map64_t *const hash_set);
 int test_function_3(hash_map64_t *const hash_set);
 int test_function_4(hash_map64_t *const hash_set);
+int test_function_5(hash_map64_t *const hash_set);
+int test_function_6(hash_map64_t *const hash_set);
+int test_function_7(hash_map64_t *const hash_set);
+int test_function_8(hash_map64_t *const hash_set);
+int test_function_9(hash_map64_t *const hash_set);
+int test_function_10(hash_map64_t *const hash_set);
+int test_function_11(hash_map64_t *const hash_set);
+int test_function_12(hash_map64_t *const hash_set);
+int test_function_13(hash_map64_t *const hash_set);
+int test_function_14(hash_map64_t *const hash_set);
+int test_function_15(hash_map64_t *const hash_set);
+int test_function_16(hash_map64_t *const hash_set);
+int test_function_17(hash_map64_t *const hash_set);
+int test_function_18(hash_map64_t *const hash_set);
+int test_function_19(hash_map64_t *const hash_set);
+int test_function_20(hash_map64_t *const hash_set);
+int test_function_21(hash_map64_t *const hash_set);
+int test_function_22(hash_map64_t *const hash_set);
+int test_function_23(hash_map64_t *const hash_set);
+int test_function_24(hash_map64_t *const hash_set);
 
 #endif /*_TEST_TESTS_INCLUDED*/
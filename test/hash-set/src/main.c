@@ -43,6 +43,25 @@ int main(void)
 	RUN_TEST_CASE(2);
 	RUN_TEST_CASE(3);
 	RUN_TEST_CASE(4);
+	RUN_TEST_CASE(5);
+	RUN_TEST_CASE(6);
+	RUN_TEST_CASE(7);
+	RUN_TEST_CASE(8);
+	RUN_TEST_CASE(9);
+	RUN_TEST_CASE(10);
+	RUN_TEST_CASE(11);
+	RUN_TEST_CASE(12);
+	RUN_TEST_CASE(13);
+	RUN_TEST_CASE(14);
+	RUN_TEST_CASE(15);
+	RUN_TEST_CASE(16);
+	RUN_TEST_CASE(17);
+	RUN_TEST_CASE(18);
+	RUN_TEST_CASE(19);
+	RUN_TEST_CASE(20);
+	RUN_TEST_CASE(21);
+	RUN_TEST_CASE(22);
+	RUN_TEST_CASE(23);
 
 	hash_set_destroy64(hash_set);
 	clk_end = clock_query();
@@ -12,7 +12,14 @@
 #include <string.h>
 #include <errno.h>
 
-#define TEST_COUNT 4
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN 1
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+#define TEST_COUNT 23
 
 /* ========================================================================= */
 /* Utilities                                                                 */
@@ -32,6 +39,51 @@
 } \
 while(0)
 
+/* creates a set with the given engine and resize mode, then inserts the items (index - 1), so that the first two items are the sentinel values; stops right after the table has grown, once at least the given minimum number of items has been inserted, so that an incremental resize is still pending */
+static hash_set64_t *fill_until_grown(hash_options_t *const options, const int engine, const int resize, uint8_t *const test, const size_t size, const size_t minimum)
+{
+	size_t j, capacity, previous = 0U;
+	hash_set64_t *instance;
+	errno_t error;
+
+	memset(options, 0, sizeof(hash_options_t));
+	options->engine = (hash_engine_t)engine;
+	options->resize = (hash_resize_t)resize;
+
+	instance = hash_set_create_ex64(0U, -1.0, clock(), options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return NULL;
+	}
+
+	if (test)
+	{
+		memset(test, 0, size * sizeof(uint8_t));
+	}
+
+	for (j = 0U; j < size; ++j)
+	{
+		if ((error = hash_set_insert64(instance, ((uint64_t)j) - 1U)))
+		{
+			printf("Insert operation has failed! (error: %d)\n", error);
+			hash_set_destroy64(instance);
+			return NULL;
+		}
+		if (test)
+		{
+			test[j] = 1U;
+		}
+		if ((!hash_set_info64(instance, &capacity, NULL, NULL, NULL)) && (capacity != previous) && (j >= minimum))
+		{
+			break;
+		}
+		previous = capacity;
+	}
+
+	return instance;
+}
+
 /* ========================================================================= */
 /* TEST #1                                                                   */
 /* ========================================================================= */
@@ -408,3 +460,2835 @@ int test_function_4(hash_set64_t *const hash_set)
 
 	return EXIT_SUCCESS;
 }
+
+/* ========================================================================= */
+/* TEST #5                                                                   */
+/* ========================================================================= */
+
+#define HASH_COUNT 262139U
+
+int test_function_5(hash_set64_t *const hash_set)
+{
+	size_t capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	int function, probe, engine;
+	uint64_t value;
+
+	UNUSED(hash_set);
+
+	for (function = HASHSET_HASH_DEFAULT; function <= HASHSET_HASH_AESNI; ++function)
+	{
+		for (probe = HASHSET_PROBE_DEFAULT; probe <= HASHSET_PROBE_QUADRATIC; ++probe)
+		{
+			for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+			{
+				memset(&options, 0, sizeof(hash_options_t));
+				options.hash_function = (hash_function_t)function;
+				options.probe_strategy = (hash_probe_t)probe;
+				options.engine = (hash_engine_t)engine;
+
+				instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+				if (!instance)
+				{
+					puts("Allocation has failed!");
+					return EXIT_FAILURE;
+				}
+
+				for (value = 0U; value < HASH_COUNT; ++value)
+				{
+					const errno_t error = hash_set_insert64(instance, value * UINT64_C(0x9E3779B97F4A7C15));
+					if (error)
+					{
+						printf("Insert operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+
+				for (value = 0U; value < 2U * HASH_COUNT; ++value)
+				{
+					const errno_t error = hash_set_contains64(instance, value * UINT64_C(0x9E3779B97F4A7C15));
+					if (error != ((value < HASH_COUNT) ? 0 : ENOENT))
+					{
+						printf("Contains operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+
+				for (value = 0U; value < HASH_COUNT; ++value)
+				{
+					const errno_t error = hash_set_remove64(instance, value * UINT64_C(0x9E3779B97F4A7C15));
+					if (error)
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+				}
+
+				if (hash_set_size64(instance) != 0U)
+				{
+					puts("Invalid size!");
+					goto failure;
+				}
+
+				if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+				{
+					fprintf(stdout, "[SET %d/%d] function: %d, probe: %d, engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 5, TEST_COUNT, function, probe, engine, capacity, valid, deleted, limit);
+				}
+
+				hash_set_destroy64(instance);
+			}
+		}
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #6                                                                   */
+/* ========================================================================= */
+
+#define BATCH_COUNT 65521U
+
+int test_function_6(hash_set64_t *const hash_set)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint64_t *items;
+	uint8_t *test, *found;
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	items = (uint64_t*) malloc(BATCH_COUNT * sizeof(uint64_t));
+	test = (uint8_t*) malloc(BATCH_COUNT * sizeof(uint8_t));
+	found = (uint8_t*) malloc(((BATCH_COUNT + 7U) / 8U) * sizeof(uint8_t));
+	if ((!items) || (!test) || (!found))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			free(items);
+			free(test);
+			free(found);
+			return EXIT_FAILURE;
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			items[j] = random_next(&random);
+			test[j] = (uint8_t)(items[j] & 1U);
+		}
+
+		if (hash_set_contains_batch64(instance, items, BATCH_COUNT, found) != ENOENT)
+		{
+			puts("Batch operation has failed on an empty set!");
+			goto failure;
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			if (test[j])
+			{
+				const errno_t error = hash_set_insert64(instance, items[j]);
+				if (error && (error != EEXIST))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+			}
+			hash_set_prefetch64(instance, items[j]);
+		}
+
+		if (hash_set_contains_batch64(instance, items, BATCH_COUNT, found) != ENOENT)
+		{
+			puts("Batch operation has failed!");
+			goto failure;
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			if ((!((found[j / 8U] >> (j % 8U)) & 1U)) != (!test[j]))
+			{
+				puts("Batch operation has returned an invalid result!");
+				goto failure;
+			}
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			if ((!test[j]) && hash_set_insert64(instance, items[j]))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_set_contains_batch64(instance, items, BATCH_COUNT, NULL) || hash_set_contains_batch64(instance, items, 0U, NULL))
+		{
+			puts("Batch operation has failed!");
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 6, TEST_COUNT, engine, capacity, valid, deleted, limit);
+		}
+
+		hash_set_destroy64(instance);
+	}
+
+	free(items);
+	free(test);
+	free(found);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(items);
+	free(test);
+	free(found);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #7                                                                   */
+/* ========================================================================= */
+
+#define CHUNK_SIZE 4096U
+
+/* a batch of items that are all present already must not make the set grow */
+static int check_reinsert(const hash_options_t *const options)
+{
+	size_t j, capacity[2U], valid, deleted, limit;
+	hash_set64_t *instance;
+	uint64_t items[CHUNK_SIZE];
+
+	instance = hash_set_create_ex64(0U, -1.0, clock(), options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (j = 0U; j < CHUNK_SIZE; ++j)
+	{
+		if (hash_set_insert64(instance, items[j] = (uint64_t)j))
+		{
+			puts("Insert operation has failed!");
+			goto failure;
+		}
+	}
+
+	if (hash_set_info64(instance, &capacity[0U], &valid, &deleted, &limit) || (hash_set_insert_batch64(instance, items, CHUNK_SIZE, NULL) != EEXIST) || hash_set_info64(instance, &capacity[1U], &valid, &deleted, &limit))
+	{
+		puts("Batch operation has failed!");
+		goto failure;
+	}
+
+	if ((capacity[1U] != capacity[0U]) || (valid != CHUNK_SIZE))
+	{
+		puts("Set has grown for items that were present already!");
+		goto failure;
+	}
+
+	hash_set_destroy64(instance);
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+int test_function_7(hash_set64_t *const hash_set)
+{
+	size_t r, j, expected, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint64_t items[CHUNK_SIZE];
+	uint8_t *test, result[CHUNK_SIZE / 8U];
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(BATCH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, BATCH_COUNT * sizeof(uint8_t));
+
+		for (r = 0U, expected = 0U; r < 256U; ++r)
+		{
+			const int insert = (r < 16U) || (random_next(&random) & 1U);
+			errno_t error, error_expected = 0;
+
+			for (j = 0U; j < CHUNK_SIZE; ++j)
+			{
+				items[j] = random_next(&random) % BATCH_COUNT;
+			}
+
+			error = insert ? hash_set_insert_batch64(instance, items, CHUNK_SIZE, result) : hash_set_remove_batch64(instance, items, CHUNK_SIZE, result);
+
+			for (j = 0U; j < CHUNK_SIZE; ++j)
+			{
+				const int success = (int)((result[j / 8U] >> (j % 8U)) & 1U);
+				if (success != (insert ? (!test[items[j]]) : test[items[j]]))
+				{
+					puts("Batch operation has returned an invalid result!");
+					goto failure;
+				}
+				if (success)
+				{
+					INVERT(test[items[j]]);
+					expected = insert ? (expected + 1U) : (expected - 1U);
+				}
+				else
+				{
+					error_expected = insert ? EEXIST : ENOENT;
+				}
+			}
+
+			if (error != error_expected)
+			{
+				printf("Batch operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+
+			if (hash_set_size64(instance) != expected)
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+		}
+
+		for (j = 0U; j < BATCH_COUNT; ++j)
+		{
+			if ((hash_set_contains64(instance, j) == 0) != (test[j] != 0U))
+			{
+				puts("Contains operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (check_reinsert(&options) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 7, TEST_COUNT, engine, capacity, valid, deleted, limit);
+		}
+
+		hash_set_destroy64(instance);
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #8                                                                   */
+/* ========================================================================= */
+
+#define BUILD_COUNT 300007U
+
+int test_function_8(hash_set64_t *const hash_set)
+{
+	size_t j, threads, distinct, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint64_t *items;
+	uint8_t *test;
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	items = (uint64_t*) malloc(BUILD_COUNT * sizeof(uint64_t));
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if ((!items) || (!test))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+
+	for (j = 0U, distinct = 0U; j < BUILD_COUNT; ++j)
+	{
+		items[j] = random_next(&random) % HASH_COUNT;
+		if (!test[items[j]])
+		{
+			test[items[j]] = 1U;
+			++distinct;
+		}
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (threads = 1U; threads <= 4U; ++threads)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.thread_count = threads;
+			options.probe_strategy = (hash_probe_t)(threads - 1U); /*each of the probe strategies with a different number of threads*/
+
+			instance = hash_set_create_from_array64(items, BUILD_COUNT, -1.0, clock(), &options, HASHSET_DUPLICATES_FAIL);
+			if (instance)
+			{
+				puts("Duplicate items have not been detected!");
+				goto failure;
+			}
+
+			instance = hash_set_create_from_array64(items, BUILD_COUNT, -1.0, clock(), &options, HASHSET_DUPLICATES_IGNORE);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				return EXIT_FAILURE;
+			}
+
+			if (hash_set_size64(instance) != distinct)
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+
+			for (j = 0U; j < HASH_COUNT; ++j)
+			{
+				if ((hash_set_contains64(instance, j) == 0) != (test[j] != 0U))
+				{
+					puts("Contains operation has failed!");
+					goto failure;
+				}
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] engine: %d, threads: %zu, probe: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 8, TEST_COUNT, engine, threads, (int)options.probe_strategy, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+
+			for (j = 0U; j < BUILD_COUNT; ++j)
+			{
+				items[j] = (items[j] << 32) | j;
+			}
+
+			instance = hash_set_create_from_array64(items, BUILD_COUNT, -1.0, clock(), &options, HASHSET_DUPLICATES_FAIL);
+			for (j = 0U; j < BUILD_COUNT; ++j)
+			{
+				items[j] >>= 32;
+			}
+
+			if ((!instance) || (hash_set_size64(instance) != BUILD_COUNT))
+			{
+				puts("Creation from distinct items has failed!");
+				goto failure;
+			}
+
+			hash_set_destroy64(instance);
+		}
+	}
+
+	free(items);
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(items);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #9                                                                   */
+/* ========================================================================= */
+
+#define REBUILD_COUNT 393241U
+
+int test_function_9(hash_set64_t *const hash_set)
+{
+	size_t j, threads, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint64_t *items;
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	items = (uint64_t*) malloc(REBUILD_COUNT * sizeof(uint64_t));
+	if (!items)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (j = 0U; j < REBUILD_COUNT; ++j)
+	{
+		items[j] = (random_next(&random) << 20) | j;
+	}
+
+	items[0U] = 0U;
+	items[1U] = UINT64_MAX;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (threads = 1U; threads <= 4U; ++threads)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.thread_count = threads;
+			options.probe_strategy = (hash_probe_t)(threads - 1U); /*each of the probe strategies with a different number of threads*/
+
+			instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				free(items);
+				return EXIT_FAILURE;
+			}
+
+			for (j = 0U; j < REBUILD_COUNT; ++j)
+			{
+				if (hash_set_insert64(instance, items[j]))
+				{
+					puts("Insert operation has failed!");
+					goto failure;
+				}
+			}
+
+			for (j = 1U; j < REBUILD_COUNT; j += 2U)
+			{
+				if (hash_set_remove64(instance, items[j]))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+			}
+
+			for (j = 0U; j < REBUILD_COUNT; ++j)
+			{
+				if (hash_set_contains64(instance, items[j]) != ((j & 1U) ? ENOENT : 0))
+				{
+					puts("Contains operation has failed!");
+					goto failure;
+				}
+			}
+
+			if (hash_set_size64(instance) != ((REBUILD_COUNT + 1U) / 2U))
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] engine: %d, threads: %zu, probe: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 9, TEST_COUNT, engine, threads, (int)options.probe_strategy, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+		}
+	}
+
+	free(items);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(items);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #10                                                                  */
+/* ========================================================================= */
+
+#define RESIZE_STEPS 1048576U
+
+static int verify_contents(const hash_set64_t *const instance, const uint8_t *const test, const size_t count)
+{
+	size_t j, cursor = 0U;
+	uint64_t item;
+
+	for (j = 0U; j < HASH_COUNT; ++j)
+	{
+		if ((hash_set_contains64(instance, j) == 0) != (test[j] != 0U))
+		{
+			puts("Contains operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (j = 0U; !hash_set_iterate64(instance, &cursor, &item); ++j)
+	{
+		if ((item >= HASH_COUNT) || (!test[item]))
+		{
+			puts("Iteration has returned an unexpected item!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (j != count)
+	{
+		puts("Iteration has returned a wrong number of items!");
+		return EXIT_FAILURE;
+	}
+
+	if (hash_set_size64(instance) != count)
+	{
+		puts("Invalid size!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_10(hash_set64_t *const hash_set)
+{
+	size_t j, count, resizes, capacity, valid, deleted, limit, previous;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint64_t item;
+	uint8_t *test;
+	errno_t error;
+	int engine;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = (hash_engine_t)engine;
+		options.resize = HASHSET_RESIZE_INCREMENTAL;
+
+		instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			free(test);
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+		count = resizes = previous = 0U;
+
+		for (j = 0U; j < RESIZE_STEPS; ++j)
+		{
+			item = random_next(&random) % HASH_COUNT;
+			switch (random_next(&random) % 4U)
+			{
+			case 0U:
+				error = hash_set_remove64(instance, item);
+				if (error != (test[item] ? 0 : ENOENT))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+				if (!error)
+				{
+					test[item] = 0U;
+					--count;
+				}
+				break;
+			case 1U:
+				if (hash_set_contains64(instance, item) != (test[item] ? 0 : ENOENT))
+				{
+					puts("Contains operation has failed!");
+					goto failure;
+				}
+				break;
+			default:
+				error = hash_set_insert64(instance, item);
+				if (error != (test[item] ? EEXIST : 0))
+				{
+					puts("Insert operation has failed!");
+					goto failure;
+				}
+				if (!error)
+				{
+					test[item] = 1U;
+					++count;
+				}
+			}
+
+			if (hash_set_size64(instance) != count)
+			{
+				puts("Invalid size!");
+				goto failure;
+			}
+
+			if ((!hash_set_info64(instance, &capacity, &valid, &deleted, &limit)) && (capacity != previous))
+			{
+				if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+				{
+					goto failure;
+				}
+				previous = capacity;
+				++resizes;
+			}
+		}
+
+		if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] engine: %d, resizes: %zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 10, TEST_COUNT, engine, resizes, capacity, valid, deleted, limit);
+		}
+
+		hash_set_destroy64(instance);
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #11                                                                  */
+/* ========================================================================= */
+
+#define SIZING_COUNT 196613U
+
+static hash_set64_t *create_sizing(const int engine, const double growth_factor, const hash_shrink_t shrink, const double shrink_threshold)
+{
+	hash_options_t options;
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = (hash_engine_t)engine;
+	options.growth_factor = growth_factor;
+	options.shrink = shrink;
+	options.shrink_threshold = shrink_threshold;
+
+	return hash_set_create_ex64(0U, -1.0, clock(), &options);
+}
+
+static int insert_range(hash_set64_t *const instance, const size_t first, const size_t last, const size_t growth)
+{
+	size_t j, capacity, valid, deleted, limit, previous = 0U;
+
+	for (j = first; j < last; ++j)
+	{
+		if (hash_set_insert64(instance, j))
+		{
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			if (previous && (capacity != previous) && ((!growth) || (capacity < (previous * growth))))
+			{
+				puts("Capacity has changed unexpectedly!");
+				return EXIT_FAILURE;
+			}
+			previous = capacity;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_11(hash_set64_t *const hash_set)
+{
+	size_t j, capacity, valid, deleted, limit, peak;
+	hash_set64_t *instance = NULL;
+	int engine;
+
+	UNUSED(hash_set);
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		/* growth factor and keep-on-clear */
+		instance = create_sizing(engine, 4.0, HASHSET_SHRINK_KEEP_ON_CLEAR, 0.0);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 4U) != EXIT_SUCCESS) || hash_set_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		if (hash_set_clear64(instance) || hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak) || valid)
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		if ((insert_range(instance, 0U, SIZING_COUNT, 0U) != EXIT_SUCCESS) || hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak))
+		{
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+
+		/* no shrinking, explicit shrink_to_fit and reserve */
+		instance = create_sizing(engine, 0.0, HASHSET_SHRINK_NEVER, 0.0);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 2U) != EXIT_SUCCESS) || hash_set_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_set_remove64(instance, j))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != peak))
+		{
+			puts("Capacity has been reduced unexpectedly!");
+			goto failure;
+		}
+
+		if (hash_set_shrink_to_fit64(instance) || hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak) || deleted)
+		{
+			puts("Shrink operation has failed!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((hash_set_contains64(instance, j) == 0) != (!(j % 16U)))
+			{
+				puts("Contains operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_set_reserve64(instance, SIZING_COUNT) || hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (limit < SIZING_COUNT))
+		{
+			puts("Reserve operation has failed!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_set_insert64(instance, j))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_set_info64(instance, &peak, &valid, &deleted, &limit) || (peak != capacity) || (valid != SIZING_COUNT))
+		{
+			puts("Capacity has changed after reserve!");
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+
+		/* automatic shrinking with threshold */
+		instance = create_sizing(engine, 0.0, HASHSET_SHRINK_AUTO, 0.25);
+		if ((!instance) || (insert_range(instance, 0U, SIZING_COUNT, 2U) != EXIT_SUCCESS) || hash_set_info64(instance, &peak, &valid, &deleted, &limit))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((j % 16U) && hash_set_remove64(instance, j))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+
+		if (hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak) || (valid != ((SIZING_COUNT + 15U) / 16U)))
+		{
+			puts("Capacity has not been reduced!");
+			goto failure;
+		}
+
+		for (j = 0U; j < SIZING_COUNT; ++j)
+		{
+			if ((hash_set_contains64(instance, j) == 0) != (!(j % 16U)))
+			{
+				puts("Contains operation has failed!");
+				goto failure;
+			}
+		}
+
+		fprintf(stdout, "[SET %d/%d] engine: %d, peak: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 11, TEST_COUNT, engine, peak, capacity, valid, deleted, limit);
+
+		if (hash_set_clear64(instance) || hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity >= peak))
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #12                                                                  */
+/* ========================================================================= */
+
+#define PURGE_ROUNDS 8U
+
+static const hash_engine_t PURGE_ENGINES[] = { HASHSET_ENGINE_BITMAP, HASHSET_ENGINE_SWISS, HASHSET_ENGINE_SENTINEL }; /*the other engines never leave "deleted" slots behind*/
+
+int test_function_12(hash_set64_t *const hash_set)
+{
+	size_t j, k, round, count, purges, capacity, valid, deleted, limit, initial, previous;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint8_t *test;
+	int probe;
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (k = 0U; k < sizeof(PURGE_ENGINES) / sizeof(PURGE_ENGINES[0U]); ++k)
+	{
+		for (probe = HASHSET_PROBE_DEFAULT; probe <= HASHSET_PROBE_QUADRATIC; ++probe)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = PURGE_ENGINES[k];
+			options.probe_strategy = (hash_probe_t)probe;
+			options.shrink = HASHSET_SHRINK_NEVER;
+
+			/* high load factor, because the swiss engine only leaves "deleted" slots behind in full groups */
+			instance = hash_set_create_ex64(0U, 0.9375, clock(), &options);
+			if ((!instance) || hash_set_reserve64(instance, HASH_COUNT / 2U) || hash_set_info64(instance, &initial, &valid, &deleted, &limit))
+			{
+				puts("Allocation has failed!");
+				hash_set_destroy64(instance);
+				free(test);
+				return EXIT_FAILURE;
+			}
+
+			memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+			count = purges = 0U;
+
+			for (round = 0U; round < PURGE_ROUNDS; ++round)
+			{
+				/* fill the table right up to the limit, so that it does not grow */
+				for (j = 0U; (j < HASH_COUNT) && (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit)) && (valid + deleted + 1U < limit); ++j)
+				{
+					if ((!test[j]) && hash_set_insert64(instance, j))
+					{
+						puts("Insert operation has failed!");
+						goto failure;
+					}
+					test[j] = 1U;
+				}
+
+				/* the "deleted" slots are purged once they exceed half of the limit */
+				for (j = 0U, previous = deleted; j < HASH_COUNT; ++j)
+				{
+					if (test[j] && ((j % PURGE_ROUNDS) != round))
+					{
+						if (hash_set_remove64(instance, j))
+						{
+							puts("Remove operation has failed!");
+							goto failure;
+						}
+						test[j] = 0U;
+						if (hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (capacity != initial))
+						{
+							puts("Capacity has changed unexpectedly!");
+							goto failure;
+						}
+						if (deleted < previous)
+						{
+							++purges;
+						}
+						previous = deleted;
+					}
+				}
+
+				for (j = count = 0U; j < HASH_COUNT; ++j)
+				{
+					count += test[j];
+				}
+
+				if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+				{
+					goto failure;
+				}
+			}
+
+			if (hash_set_info64(instance, &capacity, &valid, &deleted, &limit) || (purges < PURGE_ROUNDS))
+			{
+				puts("Deleted slots have not been purged!");
+				goto failure;
+			}
+
+			fprintf(stdout, "[SET %d/%d] engine: %d, probe: %d, purges: %zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 12, TEST_COUNT, PURGE_ENGINES[k], probe, purges, capacity, valid, deleted, limit);
+			hash_set_destroy64(instance);
+		}
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #13                                                                  */
+/* ========================================================================= */
+
+int test_function_13(hash_set64_t *const hash_set)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint8_t *test;
+	int engine, memory, prefault;
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (memory = HASHSET_MEMORY_HEAP; memory <= HASHSET_MEMORY_HUGEPAGES; ++memory)
+	{
+		for (prefault = 0; prefault < 2; ++prefault)
+		{
+			for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+			{
+				memset(&options, 0, sizeof(hash_options_t));
+				options.engine = (hash_engine_t)engine;
+				options.memory = (hash_memory_t)memory;
+				options.prefault = prefault;
+
+				instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+				if (!instance)
+				{
+					puts("Allocation has failed!");
+					free(test);
+					return EXIT_FAILURE;
+				}
+
+				memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+
+				for (j = 0U; j < HASH_COUNT; ++j)
+				{
+					if (hash_set_insert64(instance, j))
+					{
+						puts("Insert operation has failed!");
+						goto failure;
+					}
+					test[j] = 1U;
+				}
+
+				for (j = count = 0U; j < HASH_COUNT; ++j)
+				{
+					if (j % 3U)
+					{
+						if (hash_set_remove64(instance, j))
+						{
+							puts("Remove operation has failed!");
+							goto failure;
+						}
+						test[j] = 0U;
+					}
+					else
+					{
+						++count;
+					}
+				}
+
+				if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+				{
+					goto failure;
+				}
+
+				if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+				{
+					fprintf(stdout, "[SET %d/%d] memory: %d, prefault: %d, engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 13, TEST_COUNT, memory, prefault, engine, capacity, valid, deleted, limit);
+				}
+
+				hash_set_destroy64(instance);
+			}
+		}
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #14                                                                  */
+/* ========================================================================= */
+
+#define BUFFER_SIZE 1048576U
+
+typedef struct
+{
+	size_t allocs, frees;
+}
+alloc_stats_t;
+
+static void *counting_alloc(void *const context, const size_t size)
+{
+	++((alloc_stats_t*)context)->allocs;
+	return malloc(size);
+}
+
+static void counting_free(void *const context, void *const addr)
+{
+	if (addr)
+	{
+		++((alloc_stats_t*)context)->frees;
+	}
+	free(addr);
+}
+
+int test_function_14(hash_set64_t *const hash_set)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_set64_t *instance = NULL;
+	hash_allocator_t allocator;
+	hash_options_t options;
+	alloc_stats_t stats;
+	void *buffer;
+	uint8_t *test;
+	int engine;
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	buffer = malloc(BUFFER_SIZE);
+	if ((!test) || (!buffer))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	memset(&allocator, 0, sizeof(hash_allocator_t));
+	allocator.free = counting_free;
+	memset(&options, 0, sizeof(hash_options_t));
+	options.allocator = &allocator;
+
+	if (hash_set_create_ex64(0U, -1.0, clock(), &options))
+	{
+		puts("Invalid allocator was accepted!");
+		goto failure;
+	}
+
+	allocator.alloc = counting_alloc;
+	allocator.context = &stats;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		memset(&stats, 0, sizeof(alloc_stats_t));
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			free(test);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+
+		for (j = 0U; j < HASH_COUNT; ++j)
+		{
+			if (hash_set_insert64(instance, j))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+			test[j] = 1U;
+		}
+
+		for (j = count = 0U; j < HASH_COUNT; ++j)
+		{
+			if (j % 3U)
+			{
+				if (hash_set_remove64(instance, j))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+				test[j] = 0U;
+			}
+			else
+			{
+				++count;
+			}
+		}
+
+		if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+		instance = NULL;
+
+		if ((stats.allocs < 2U) || (stats.allocs != stats.frees))
+		{
+			printf("Allocator mismatch: allocs=%zu, frees=%zu\n", stats.allocs, stats.frees);
+			free(test);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		fprintf(stdout, "[SET %d/%d] engine: %d, allocs: %010zu, frees: %010zu\n", 14, TEST_COUNT, engine, stats.allocs, stats.frees);
+	}
+
+	options.allocator = NULL;
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		options.engine = (hash_engine_t)engine;
+
+		if (hash_set_init_in_buffer64(buffer, 16U, -1.0, clock(), &options))
+		{
+			puts("Undersized buffer was accepted!");
+			goto failure;
+		}
+
+		instance = hash_set_init_in_buffer64(buffer, BUFFER_SIZE, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Initialization has failed!");
+			free(test);
+			free(buffer);
+			return EXIT_FAILURE;
+		}
+
+		memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+
+		for (j = count = 0U; j < HASH_COUNT; ++j, ++count)
+		{
+			if (hash_set_insert64(instance, j))
+			{
+				break;
+			}
+			test[j] = 1U;
+		}
+
+		if ((count < 1U) || (count >= HASH_COUNT) || (hash_set_info64(instance, &capacity, &valid, &deleted, &limit)) || (valid != count))
+		{
+			puts("Buffer-backed instance did not fill up as expected!");
+			goto failure;
+		}
+
+		if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < HASH_COUNT; j += 2U)
+		{
+			if (test[j])
+			{
+				if (hash_set_remove64(instance, j))
+				{
+					puts("Remove operation has failed!");
+					goto failure;
+				}
+				test[j] = 0U;
+				--count;
+			}
+		}
+
+		if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 14, TEST_COUNT, engine, capacity, valid, deleted, limit);
+		}
+
+		if (hash_set_clear64(instance) || hash_set_info64(instance, &j, &valid, &deleted, &limit) || (j != capacity) || valid)
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+	free(buffer);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	free(buffer);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #15                                                                  */
+/* ========================================================================= */
+
+int test_function_15(hash_set64_t *const hash_set)
+{
+	size_t j, count, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_options_t options;
+	uint8_t *test;
+	int engine, numa;
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (numa = HASHSET_NUMA_DEFAULT; numa <= HASHSET_NUMA_FIRST_TOUCH; ++numa)
+	{
+		for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+		{
+			memset(&options, 0, sizeof(hash_options_t));
+			options.engine = (hash_engine_t)engine;
+			options.numa = (hash_numa_t)numa;
+			options.thread_count = 4U;
+
+			instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				free(test);
+				return EXIT_FAILURE;
+			}
+
+			memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+
+			for (j = 0U; j < HASH_COUNT; ++j)
+			{
+				if (hash_set_insert64(instance, j))
+				{
+					puts("Insert operation has failed!");
+					goto failure;
+				}
+				test[j] = 1U;
+			}
+
+			for (j = count = 0U; j < HASH_COUNT; ++j)
+			{
+				if (j % 3U)
+				{
+					if (hash_set_remove64(instance, j))
+					{
+						puts("Remove operation has failed!");
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+				else
+				{
+					++count;
+				}
+			}
+
+			if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] numa: %d, engine: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 15, TEST_COUNT, numa, engine, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+		}
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #16                                                                  */
+/* ========================================================================= */
+
+#define READER_COUNT 4U
+#define STABLE_COUNT 65536U
+#define CHURN_COUNT 262144U
+#define CHURN_ROUNDS 8U
+
+typedef struct
+{
+	hash_set64_t *instance;
+	volatile int *stop;
+	size_t id, lookups, errors;
+}
+reader_t;
+
+/* the keys of the "stable" range must always be found, the keys beyond the "churn" range must never be found */
+#if defined(_WIN32)
+static DWORD WINAPI reader_thread(void *const param)
+#else
+static void *reader_thread(void *const param)
+#endif
+{
+	reader_t *const reader = (reader_t*) param;
+	hash_set_reader64_t *const handle = hash_set_reader_attach64(reader->instance);
+	size_t k;
+
+	if (!handle)
+	{
+		++reader->errors;
+	}
+	else
+	{
+		for (k = reader->id; !(*reader->stop); k += 7919U)
+		{
+			if (hash_set_reader_contains64(handle, k % STABLE_COUNT))
+			{
+				++reader->errors;
+			}
+			if (!hash_set_reader_contains64(handle, (STABLE_COUNT + CHURN_COUNT) + (k % STABLE_COUNT)))
+			{
+				++reader->errors;
+			}
+			reader->lookups += 2U;
+		}
+		hash_set_reader_detach64(handle);
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_readers(hash_set64_t *const instance, size_t *const lookups)
+{
+	reader_t readers[READER_COUNT];
+	size_t j, r, errors = 0U;
+	volatile int stop = 0;
+#if defined(_WIN32)
+	HANDLE threads[READER_COUNT];
+#else
+	pthread_t threads[READER_COUNT];
+#endif
+
+	for (j = 0U; j < STABLE_COUNT; ++j)
+	{
+		if (hash_set_insert64(instance, j))
+		{
+			puts("Insert operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (r = 0U; r < READER_COUNT; ++r)
+	{
+		memset(&readers[r], 0, sizeof(reader_t));
+		readers[r].instance = instance;
+		readers[r].stop = &stop;
+		readers[r].id = r;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, reader_thread, &readers[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, reader_thread, &readers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	/* the churn range grows the table, then the "deleted" slots force rebuilds at the same capacity */
+	for (r = 0U; r < CHURN_ROUNDS; ++r)
+	{
+		for (j = STABLE_COUNT; j < STABLE_COUNT + CHURN_COUNT; ++j)
+		{
+			if (hash_set_insert64(instance, j))
+			{
+				puts("Insert operation has failed!");
+				errors = 1U;
+			}
+		}
+		for (j = STABLE_COUNT; j < STABLE_COUNT + CHURN_COUNT; ++j)
+		{
+			if (hash_set_remove64(instance, j))
+			{
+				puts("Remove operation has failed!");
+				errors = 1U;
+			}
+		}
+	}
+
+	stop = 1;
+
+	for (r = 0U; r < READER_COUNT; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += readers[r].errors;
+		*lookups += readers[r].lookups;
+	}
+
+	if (errors)
+	{
+		puts("Concurrent lookup has failed!");
+		return EXIT_FAILURE;
+	}
+
+	return (hash_set_size64(instance) == STABLE_COUNT) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* a reader that stays attached, but is idle, must not hold back the release of the retired tables */
+static int check_idle_reader(const hash_options_t *const options)
+{
+	size_t j, r, live = 0U, allocs = 0U;
+	hash_set64_t *instance;
+	hash_set_reader64_t *reader;
+	hash_allocator_t allocator;
+	hash_options_t idle_options;
+	alloc_stats_t stats;
+
+	memset(&stats, 0, sizeof(alloc_stats_t));
+	memset(&allocator, 0, sizeof(hash_allocator_t));
+	allocator.alloc = counting_alloc;
+	allocator.free = counting_free;
+	allocator.context = &stats;
+	idle_options = *options;
+	idle_options.allocator = &allocator;
+
+	instance = hash_set_create_ex64(0U, -1.0, clock(), &idle_options);
+	if (!instance)
+	{
+		puts("Allocation has failed!");
+		return EXIT_FAILURE;
+	}
+
+	reader = hash_set_reader_attach64(instance);
+	if ((!reader) || (hash_set_reader_contains64(reader, 0U) != ENOENT))
+	{
+		puts("Concurrent lookup has failed!");
+		goto failure;
+	}
+
+	for (r = 0U; r < CHURN_ROUNDS; ++r)
+	{
+		for (j = 0U; j < CHURN_COUNT; ++j)
+		{
+			if (hash_set_insert64(instance, j))
+			{
+				puts("Insert operation has failed!");
+				goto failure;
+			}
+		}
+		for (j = 0U; j < CHURN_COUNT; ++j)
+		{
+			if (hash_set_remove64(instance, j))
+			{
+				puts("Remove operation has failed!");
+				goto failure;
+			}
+		}
+		if (!r)
+		{
+			live = stats.allocs - stats.frees;
+			allocs = stats.allocs;
+		}
+		else if (stats.allocs - stats.frees > live)
+		{
+			puts("Retired tables have not been released!");
+			goto failure;
+		}
+	}
+
+	if (stats.allocs == allocs)
+	{
+		puts("Table has not been re-built!");
+		goto failure;
+	}
+
+	hash_set_reader_detach64(reader);
+	hash_set_destroy64(instance);
+	return (stats.allocs == stats.frees) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+failure:
+	if (reader)
+	{
+		hash_set_reader_detach64(reader);
+	}
+	hash_set_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+int test_function_16(hash_set64_t *const hash_set)
+{
+	size_t lookups, capacity, valid, deleted, limit;
+	hash_set64_t *instance;
+	hash_set_reader64_t *readers[2U];
+	hash_options_t options;
+	int engine;
+
+	if (hash_set_reader_attach64(hash_set))
+	{
+		puts("Reader attached to an instance without concurrency support!");
+		return EXIT_FAILURE;
+	}
+
+	memset(&options, 0, sizeof(hash_options_t));
+	options.engine = HASHSET_ENGINE_ROBINHOOD;
+	options.concurrency = HASHSET_CONCURRENCY_READERS;
+
+	instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+	if (instance)
+	{
+		puts("Unsupported engine has been accepted!");
+		hash_set_destroy64(instance);
+		return EXIT_FAILURE;
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SWISS; ++engine)
+	{
+		options.engine = (hash_engine_t)engine;
+
+		instance = hash_set_create_ex64(0U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			return EXIT_FAILURE;
+		}
+
+		readers[0U] = hash_set_reader_attach64(instance);
+		readers[1U] = hash_set_reader_attach64(instance);
+		if ((!readers[0U]) || (!readers[1U]) || (readers[0U] == readers[1U]))
+		{
+			puts("Reader could not be attached!");
+			goto failure;
+		}
+
+		hash_set_reader_detach64(readers[0U]);
+		hash_set_reader_detach64(readers[1U]);
+
+		lookups = 0U;
+		if (run_readers(instance, &lookups) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (check_idle_reader(&options) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] engine: %d, lookups: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 16, TEST_COUNT, engine, lookups, capacity, valid, deleted, limit);
+		}
+
+		if (hash_set_clear64(instance) || hash_set_size64(instance) || (!hash_set_contains64(instance, 0U)))
+		{
+			puts("Clear operation has failed!");
+			goto failure;
+		}
+
+		hash_set_destroy64(instance);
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #17                                                                  */
+/* ========================================================================= */
+
+#define WRITER_COUNT 4U
+#define WRITER_ITEMS 262144U
+#define SHARED_ITEMS 65536U
+
+typedef struct
+{
+	hash_set_concurrent64_t *instance;
+	size_t id, inserted, errors;
+}
+writer_t;
+
+/* each writer inserts its own share of the items, then all writers race to insert the same items; finally, each writer removes every other item of its own share */
+#if defined(_WIN32)
+static DWORD WINAPI writer_thread(void *const param)
+#else
+static void *writer_thread(void *const param)
+#endif
+{
+	writer_t *const writer = (writer_t*) param;
+	size_t k;
+	errno_t error;
+
+	for (k = writer->id; k < WRITER_ITEMS; k += WRITER_COUNT)
+	{
+		if (hash_set_concurrent_insert64(writer->instance, k))
+		{
+			++writer->errors;
+		}
+	}
+
+	for (k = WRITER_ITEMS; k < WRITER_ITEMS + SHARED_ITEMS; ++k)
+	{
+		if (!(error = hash_set_concurrent_insert64(writer->instance, k)))
+		{
+			++writer->inserted;
+		}
+		else if (error != EEXIST)
+		{
+			++writer->errors;
+		}
+	}
+
+	for (k = writer->id; k < WRITER_ITEMS; k += WRITER_COUNT)
+	{
+		if (((k / WRITER_COUNT) & 1U) && hash_set_concurrent_remove64(writer->instance, k))
+		{
+			++writer->errors;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_writers(hash_set_concurrent64_t *const instance)
+{
+	writer_t writers[WRITER_COUNT];
+	size_t r, k, inserted = 0U, errors = 0U;
+#if defined(_WIN32)
+	HANDLE threads[WRITER_COUNT];
+#else
+	pthread_t threads[WRITER_COUNT];
+#endif
+
+	for (r = 0U; r < WRITER_COUNT; ++r)
+	{
+		memset(&writers[r], 0, sizeof(writer_t));
+		writers[r].instance = instance;
+		writers[r].id = r;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, writer_thread, &writers[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, writer_thread, &writers[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < WRITER_COUNT; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += writers[r].errors;
+		inserted += writers[r].inserted;
+	}
+
+	if (errors || (inserted != SHARED_ITEMS))
+	{
+		puts("Concurrent update has failed!");
+		return EXIT_FAILURE;
+	}
+
+	if (hash_set_concurrent_size64(instance) != (WRITER_ITEMS / 2U) + SHARED_ITEMS)
+	{
+		puts("Invalid size!");
+		return EXIT_FAILURE;
+	}
+
+	for (k = 0U; k < WRITER_ITEMS + SHARED_ITEMS; ++k)
+	{
+		const errno_t expected = ((k < WRITER_ITEMS) && ((k / WRITER_COUNT) & 1U)) ? ENOENT : 0;
+		if (hash_set_concurrent_contains64(instance, k) != expected)
+		{
+			puts("Lookup operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_17(hash_set64_t *const hash_set)
+{
+	static const size_t SHARD_COUNT[] = { 1U, 0U, 1000U };
+	hash_set_concurrent64_t *instance;
+	hash_options_t options;
+	size_t s;
+	int engine;
+
+	UNUSED(hash_set);
+	memset(&options, 0, sizeof(hash_options_t));
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (s = 0U; s < sizeof(SHARD_COUNT) / sizeof(SHARD_COUNT[0U]); ++s)
+		{
+			options.engine = (hash_engine_t)engine;
+			options.shard_count = SHARD_COUNT[s];
+
+			instance = hash_set_concurrent_create64(0U, -1.0, clock(), &options);
+			if (!instance)
+			{
+				puts("Allocation has failed!");
+				return EXIT_FAILURE;
+			}
+
+			if (run_writers(instance) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			fprintf(stdout, "[SET %d/%d] engine: %d, shards: %04zu, size: %010zu\n", 17, TEST_COUNT, engine, SHARD_COUNT[s], hash_set_concurrent_size64(instance));
+
+			if (hash_set_concurrent_clear64(instance) || hash_set_concurrent_size64(instance) || (!hash_set_concurrent_contains64(instance, 0U)) || (hash_set_concurrent_clear64(instance) != EAGAIN))
+			{
+				puts("Clear operation has failed!");
+				goto failure;
+			}
+
+			hash_set_concurrent_destroy64(instance);
+		}
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_concurrent_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #18                                                                  */
+/* ========================================================================= */
+
+#define INSERTER_COUNT 4U
+#define DISTINCT_ITEMS 524288U
+
+typedef struct
+{
+	hash_set_lockfree64_t *instance;
+	size_t id, inserted, errors;
+}
+inserter_t;
+
+/* all inserters insert the same items, starting at different offsets, so that exactly one of them must see each item as new */
+#if defined(_WIN32)
+static DWORD WINAPI inserter_thread(void *const param)
+#else
+static void *inserter_thread(void *const param)
+#endif
+{
+	inserter_t *const inserter = (inserter_t*) param;
+	size_t k;
+	errno_t error;
+
+	for (k = 0U; k < DISTINCT_ITEMS; ++k)
+	{
+		const uint64_t item = (((k + (inserter->id * (DISTINCT_ITEMS / INSERTER_COUNT))) % DISTINCT_ITEMS) * UINT64_C(0x9E3779B97F4A7C15)) - 1U;
+		if (!(error = hash_set_lockfree_insert64(inserter->instance, item)))
+		{
+			++inserter->inserted;
+		}
+		else if (error != EEXIST)
+		{
+			++inserter->errors;
+		}
+	}
+
+#if defined(_WIN32)
+	return 0U;
+#else
+	return NULL;
+#endif
+}
+
+static int run_inserters(hash_set_lockfree64_t *const instance)
+{
+	inserter_t inserters[INSERTER_COUNT];
+	size_t r, k, inserted = 0U, errors = 0U;
+#if defined(_WIN32)
+	HANDLE threads[INSERTER_COUNT];
+#else
+	pthread_t threads[INSERTER_COUNT];
+#endif
+
+	for (r = 0U; r < INSERTER_COUNT; ++r)
+	{
+		memset(&inserters[r], 0, sizeof(inserter_t));
+		inserters[r].instance = instance;
+		inserters[r].id = r;
+#if defined(_WIN32)
+		if (!(threads[r] = CreateThread(NULL, 0U, inserter_thread, &inserters[r], 0U, NULL)))
+#else
+		if (pthread_create(&threads[r], NULL, inserter_thread, &inserters[r]))
+#endif
+		{
+			abort(); /*thread creation has failed!*/
+		}
+	}
+
+	for (r = 0U; r < INSERTER_COUNT; ++r)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[r], INFINITE);
+		CloseHandle(threads[r]);
+#else
+		pthread_join(threads[r], NULL);
+#endif
+		errors += inserters[r].errors;
+		inserted += inserters[r].inserted;
+	}
+
+	if (errors || (inserted != DISTINCT_ITEMS) || (hash_set_lockfree_size64(instance) != DISTINCT_ITEMS))
+	{
+		puts("Concurrent insert has failed!");
+		return EXIT_FAILURE;
+	}
+
+	for (k = 0U; k < DISTINCT_ITEMS; ++k)
+	{
+		if (hash_set_lockfree_contains64(instance, (k * UINT64_C(0x9E3779B97F4A7C15)) - 1U) || (!hash_set_lockfree_contains64(instance, (k * UINT64_C(0x9E3779B97F4A7C15)) + 1U)))
+		{
+			puts("Lookup operation has failed!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_18(hash_set64_t *const hash_set)
+{
+	hash_set_lockfree64_t *instance;
+	hash_options_t options;
+	int probe;
+
+	UNUSED(hash_set);
+	memset(&options, 0, sizeof(hash_options_t));
+
+	for (probe = HASHSET_PROBE_DEFAULT; probe <= HASHSET_PROBE_QUADRATIC; ++probe)
+	{
+		options.probe_strategy = (hash_probe_t)probe;
+
+		instance = hash_set_lockfree_create64(1U, -1.0, clock(), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			return EXIT_FAILURE;
+		}
+
+		if (run_inserters(instance) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if ((hash_set_lockfree_insert64(instance, 0U) != 0) || (hash_set_lockfree_insert64(instance, 0U) != EEXIST) || hash_set_lockfree_contains64(instance, 0U) || (hash_set_lockfree_size64(instance) != DISTINCT_ITEMS + 1U))
+		{
+			puts("Sentinel item has failed!");
+			goto failure;
+		}
+
+		fprintf(stdout, "[SET %d/%d] probe: %d, size: %010zu\n", 18, TEST_COUNT, probe, hash_set_lockfree_size64(instance));
+		hash_set_lockfree_destroy64(instance);
+	}
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	hash_set_lockfree_destroy64(instance);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #19                                                                  */
+/* ========================================================================= */
+
+#define EXPORT_SIZE 262144U
+
+#define EXPORT_ITEM(X) (((uint64_t)(X)) - 1U) /*the first two items are the sentinel values*/
+
+static const size_t EXPORT_CHUNKS[] = { 1U, 7U, 64U, 4093U, EXPORT_SIZE };
+
+static int verify_export(const hash_set64_t *const instance, const uint8_t *const test, uint64_t *const expected, uint64_t *const actual)
+{
+	size_t k, cursor, count, total, chunk;
+	uint64_t item;
+	errno_t error;
+
+	for (cursor = 0U, count = 0U; !hash_set_iterate64(instance, &cursor, &item); ++count)
+	{
+		if ((count >= EXPORT_SIZE) || (!test[(size_t)(item + 1U)]))
+		{
+			puts("Iteration has returned an unexpected item!");
+			return EXIT_FAILURE;
+		}
+		expected[count] = item;
+	}
+
+	if (count != hash_set_size64(instance))
+	{
+		puts("Iteration has returned a wrong number of items!");
+		return EXIT_FAILURE;
+	}
+
+	for (k = 0U; k < sizeof(EXPORT_CHUNKS) / sizeof(EXPORT_CHUNKS[0U]); ++k)
+	{
+		for (cursor = 0U, total = 0U; !(error = hash_set_iterate_batch64(instance, &cursor, actual + total, EXPORT_CHUNKS[k], &chunk)); total += chunk)
+		{
+			if ((!chunk) || (chunk > EXPORT_CHUNKS[k]) || (total + chunk > count))
+			{
+				puts("Batch iteration has returned a wrong number of items!");
+				return EXIT_FAILURE;
+			}
+		}
+		if ((error != ENOENT) || (cursor != SIZE_MAX) || (total != count) || memcmp(expected, actual, count * sizeof(uint64_t)))
+		{
+			puts("Batch iteration has returned unexpected items!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_19(hash_set64_t *const hash_set)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_set64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected, *actual;
+	uint8_t *test;
+	int engine, resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(EXPORT_SIZE * sizeof(uint8_t));
+	expected = (uint64_t*) malloc(EXPORT_SIZE * sizeof(uint64_t));
+	actual = (uint64_t*) malloc(EXPORT_SIZE * sizeof(uint64_t));
+	if ((!test) || (!expected) || (!actual))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, test, EXPORT_SIZE, EXPORT_SIZE / 4U)))
+			{
+				goto failure;
+			}
+
+			if (verify_export(instance, test, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			/* remove most of the items, so that the table is sparse */
+			for (j = 0U; j < EXPORT_SIZE; ++j)
+			{
+				if (test[j] && (random_next(&random) % 16U))
+				{
+					if ((error = hash_set_remove64(instance, EXPORT_ITEM(j))))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+			}
+
+			if (verify_export(instance, test, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 19, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+			instance = NULL;
+		}
+	}
+
+	free(test);
+	free(expected);
+	free(actual);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_set_destroy64(instance);
+	}
+	free(test);
+	free(expected);
+	free(actual);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #20                                                                  */
+/* ========================================================================= */
+
+#define SCAN_SIZE 524288U
+#define SCAN_CHUNK 1000U
+#define SCAN_THREADS 4U
+#define SCAN_PARTS 64U
+
+#define SCAN_ITEM(X) (((uint64_t)(X)) - 1U) /*the first two items are the sentinel values*/
+
+static const size_t SCAN_SPLITS[] = { 1U, 3U, 8U, 61U };
+
+typedef struct
+{
+	size_t count[SCAN_PARTS];
+	uint64_t checksum[SCAN_PARTS];
+	size_t calls, limit;
+}
+scan_state_t;
+
+static int scan_callback(const uint64_t *const items, const size_t count, const size_t part, void *const context)
+{
+	scan_state_t *const state = (scan_state_t*) context;
+	size_t i;
+
+	if ((part >= SCAN_PARTS) || (!count))
+	{
+		abort(); /*this should never happen!*/
+	}
+
+	for (i = 0U; i < count; ++i)
+	{
+		state->checksum[part] += items[i] ^ (items[i] >> 7);
+	}
+
+	state->count[part] += count;
+	return (state->limit == SIZE_MAX) || (++state->calls < state->limit); /*the calls are counted only in single-threaded scans*/
+}
+
+static int verify_scan(const hash_set64_t *const instance, uint64_t *const expected, uint64_t *const actual)
+{
+	size_t j, k, cursor, count, total, chunk;
+	size_t bounds[SCAN_PARTS + 1U];
+	uint64_t item, checksum = 0U;
+	scan_state_t state;
+	errno_t error;
+
+	for (cursor = 0U, count = 0U; !hash_set_iterate64(instance, &cursor, &item); ++count)
+	{
+		expected[count] = item;
+		checksum += item ^ (item >> 7);
+	}
+
+	/* the ranges, concatenated in order, must yield the same sequence as the plain iteration */
+	for (k = 0U; k < sizeof(SCAN_SPLITS) / sizeof(SCAN_SPLITS[0U]); ++k)
+	{
+		if (hash_set_split64(instance, SCAN_SPLITS[k], bounds) || bounds[0U])
+		{
+			puts("Split operation has failed!");
+			return EXIT_FAILURE;
+		}
+		for (j = 0U, total = 0U; j < SCAN_SPLITS[k]; ++j)
+		{
+			if (bounds[j] > bounds[j + 1U])
+			{
+				puts("Split operation has returned overlapping ranges!");
+				return EXIT_FAILURE;
+			}
+			for (cursor = bounds[j]; !(error = hash_set_iterate_range64(instance, &cursor, bounds[j + 1U], actual + total, SCAN_CHUNK, &chunk)); total += chunk)
+			{
+				if ((!chunk) || (chunk > SCAN_CHUNK) || (total + chunk > count) || (cursor > bounds[j + 1U]))
+				{
+					puts("Range iteration has returned a wrong number of items!");
+					return EXIT_FAILURE;
+				}
+			}
+			if (error != ENOENT)
+			{
+				printf("Range iteration has failed! (error: %d)\n", error);
+				return EXIT_FAILURE;
+			}
+		}
+		if ((total != count) || memcmp(expected, actual, count * sizeof(uint64_t)))
+		{
+			puts("Range iteration has returned unexpected items!");
+			return EXIT_FAILURE;
+		}
+	}
+
+	memset(&state, 0, sizeof(scan_state_t));
+	state.limit = SIZE_MAX;
+	if ((error = hash_set_parallel_for64(instance, SCAN_THREADS, scan_callback, &state)))
+	{
+		printf("Parallel scan has failed! (error: %d)\n", error);
+		return EXIT_FAILURE;
+	}
+
+	for (j = 0U, total = 0U, item = 0U; j < SCAN_PARTS; ++j)
+	{
+		total += state.count[j];
+		item += state.checksum[j];
+	}
+
+	if ((total != count) || (item != checksum))
+	{
+		puts("Parallel scan has returned unexpected items!");
+		return EXIT_FAILURE;
+	}
+
+	memset(&state, 0, sizeof(scan_state_t));
+	state.limit = 1U;
+	if ((error = hash_set_parallel_for64(instance, 1U, scan_callback, &state)) != ECANCELED)
+	{
+		printf("Parallel scan was not cancelled! (error: %d)\n", error);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_20(hash_set64_t *const hash_set)
+{
+	size_t capacity, valid, deleted, limit;
+	hash_set64_t *instance = NULL;
+	hash_options_t options;
+	uint64_t *expected, *actual;
+	int engine, resize;
+
+	UNUSED(hash_set);
+
+	expected = (uint64_t*) malloc(SCAN_SIZE * sizeof(uint64_t));
+	actual = (uint64_t*) malloc(SCAN_SIZE * sizeof(uint64_t));
+	if ((!expected) || (!actual))
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, NULL, SCAN_SIZE, SCAN_SIZE / 2U)))
+			{
+				goto failure;
+			}
+
+			if (verify_scan(instance, expected, actual) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 20, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+			instance = NULL;
+		}
+	}
+
+	free(expected);
+	free(actual);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_set_destroy64(instance);
+	}
+	free(expected);
+	free(actual);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #21                                                                  */
+/* ========================================================================= */
+
+#define SAVE_SIZE 262144U
+
+#define SAVE_ITEM(X) (((uint64_t)(X)) - 1U) /*the first two items are the sentinel values*/
+
+static int verify_load(const hash_set64_t *const instance, const uint8_t *const test)
+{
+	size_t j, count;
+	errno_t error;
+
+	for (j = 0U, count = 0U; j < SAVE_SIZE; ++j)
+	{
+		if ((error = hash_set_contains64(instance, SAVE_ITEM(j))) != (test[j] ? 0 : ENOENT))
+		{
+			printf("Loaded set has returned a wrong result! (error: %d)\n", error);
+			return EXIT_FAILURE;
+		}
+		count += test[j];
+	}
+
+	if (hash_set_size64(instance) != count)
+	{
+		puts("Loaded set has a wrong size!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int test_function_21(hash_set64_t *const hash_set)
+{
+	size_t j, capacity, valid, deleted, limit;
+	hash_set64_t *instance = NULL;
+	hash_options_t options;
+	FILE *file = NULL;
+	uint8_t *test;
+	int engine, resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(SAVE_SIZE * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (engine = HASHSET_ENGINE_DEFAULT; engine <= HASHSET_ENGINE_SENTINEL; ++engine)
+	{
+		for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+		{
+			if (!(instance = fill_until_grown(&options, engine, resize, test, SAVE_SIZE, SAVE_SIZE / 4U)))
+			{
+				goto failure;
+			}
+
+			for (j = 0U; j < SAVE_SIZE; ++j)
+			{
+				if (test[j] && (!(random_next(&random) % 4U)))
+				{
+					if ((error = hash_set_remove64(instance, SAVE_ITEM(j))))
+					{
+						printf("Remove operation has failed! (error: %d)\n", error);
+						goto failure;
+					}
+					test[j] = 0U;
+				}
+			}
+
+			if (!(file = tmpfile()))
+			{
+				puts("Failed to create the temporary file!");
+				goto failure;
+			}
+
+			if ((error = hash_set_save64(instance, fileno(file))))
+			{
+				printf("Save operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+
+			hash_set_destroy64(instance);
+			instance = NULL;
+
+			/* the table of the mapped set is modified, which must not affect the file */
+			fseek(file, 0L, SEEK_SET);
+			if (!(instance = hash_set_load64(fileno(file), HASHSET_LOAD_MMAP, &options)))
+			{
+				puts("Load operation has failed!");
+				goto failure;
+			}
+
+			if (verify_load(instance, test) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			for (j = 0U; j < SAVE_SIZE; ++j)
+			{
+				error = test[j] ? hash_set_remove64(instance, SAVE_ITEM(j)) : hash_set_insert64(instance, SAVE_ITEM(j));
+				if (error)
+				{
+					printf("Update of the loaded set has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				INVERT(test[j]);
+			}
+
+			if (verify_load(instance, test) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			hash_set_destroy64(instance);
+			instance = NULL;
+
+			for (j = 0U; j < SAVE_SIZE; ++j)
+			{
+				INVERT(test[j]);
+			}
+
+			fseek(file, 0L, SEEK_SET);
+			if (!(instance = hash_set_load64(fileno(file), HASHSET_LOAD_READ, &options)))
+			{
+				puts("Load operation has failed!");
+				goto failure;
+			}
+
+			if (verify_load(instance, test) != EXIT_SUCCESS)
+			{
+				goto failure;
+			}
+
+			if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+			{
+				fprintf(stdout, "[SET %d/%d] engine: %d, resize: %d, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 21, TEST_COUNT, engine, resize, capacity, valid, deleted, limit);
+			}
+
+			hash_set_destroy64(instance);
+			instance = NULL;
+
+			/* a file that was written for a different item size must be rejected */
+			fseek(file, 0L, SEEK_SET);
+			if (hash_set_load32(fileno(file), HASHSET_LOAD_READ, &options))
+			{
+				puts("Mismatching file has been loaded!");
+				goto failure;
+			}
+
+			fclose(file);
+			file = NULL;
+		}
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_set_destroy64(instance);
+	}
+	if (file)
+	{
+		fclose(file);
+	}
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #22                                                                  */
+/* ========================================================================= */
+
+#define STASH_SIZE 8U
+#define STASH_ITEMS 4096U
+#define STASH_ATTEMPTS 4096U
+
+/* the stash of the cuckoo engine is located right after the last bucket, i.e., it starts at the capacity */
+static size_t stash_count(const hash_set64_t *const instance)
+{
+	uint64_t items[STASH_SIZE];
+	size_t capacity, cursor, count;
+
+	if (hash_set_info64(instance, &capacity, NULL, NULL, NULL))
+	{
+		return 0U;
+	}
+
+	cursor = capacity;
+	return hash_set_iterate_range64(instance, &cursor, capacity + STASH_SIZE, items, STASH_SIZE, &count) ? 0U : count;
+}
+
+static int remove_random(hash_set64_t *const instance, uint8_t *const test, size_t *const count, random_t *const random)
+{
+	size_t j;
+	errno_t error;
+
+	for (j = 0U; j < HASH_COUNT; ++j)
+	{
+		if (test[j] && (!(random_next(random) % 2U)))
+		{
+			if ((error = hash_set_remove64(instance, (uint64_t)j)))
+			{
+				printf("Remove operation has failed! (error: %d)\n", error);
+				return EXIT_FAILURE;
+			}
+			test[j] = 0U;
+			--*count;
+		}
+	}
+
+	return verify_contents(instance, test, *count);
+}
+
+int test_function_22(hash_set64_t *const hash_set)
+{
+	size_t j, count, attempt, capacity, valid, deleted, limit, initial, stashed;
+	hash_set64_t *instance = NULL;
+	hash_options_t options;
+	uint8_t *test;
+	int resize;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = HASHSET_ENGINE_CUCKOO;
+		options.resize = (hash_resize_t)resize;
+
+		/* at this load factor, a small table often runs out of room in both buckets of an item before it grows, so that the item ends up in the stash; retry with a different seed otherwise */
+		for (attempt = 0U, stashed = 0U; (attempt < STASH_ATTEMPTS) && (!stashed); ++attempt)
+		{
+			if (instance)
+			{
+				hash_set_destroy64(instance);
+			}
+
+			instance = hash_set_create_ex64(1U, 0.95, random_next(&random), &options);
+			if ((!instance) || hash_set_info64(instance, &initial, NULL, NULL, NULL))
+			{
+				puts("Allocation has failed!");
+				goto failure;
+			}
+
+			memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+			for (count = 0U; (count < STASH_ITEMS) && (!stashed); ++count)
+			{
+				if ((error = hash_set_insert64(instance, (uint64_t)count)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[count] = 1U;
+				if (hash_set_info64(instance, &capacity, NULL, NULL, NULL) || (capacity != initial))
+				{
+					break;
+				}
+				stashed = stash_count(instance);
+			}
+		}
+
+		if (!stashed)
+		{
+			puts("The stash has not been used!");
+			goto failure;
+		}
+
+		/* the items in the stash must remain reachable, while other items are removed and the table grows */
+		if ((verify_contents(instance, test, count) != EXIT_SUCCESS) || (remove_random(instance, test, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < STASH_ITEMS; ++j)
+		{
+			if (!test[j])
+			{
+				if ((error = hash_set_insert64(instance, (uint64_t)j)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[j] = 1U;
+				++count;
+			}
+		}
+
+		if (hash_set_info64(instance, &capacity, NULL, NULL, NULL) || (capacity == initial))
+		{
+			puts("The table has not grown!");
+			goto failure;
+		}
+
+		if ((verify_contents(instance, test, count) != EXIT_SUCCESS) || (remove_random(instance, test, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] resize: %d, attempts: %04zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 22, TEST_COUNT, resize, attempt, capacity, valid, deleted, limit);
+		}
+
+		hash_set_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_set_destroy64(instance);
+	}
+	free(test);
+	return EXIT_FAILURE;
+}
+
+/* ========================================================================= */
+/* TEST #23                                                                  */
+/* ========================================================================= */
+
+int test_function_23(hash_set64_t *const hash_set)
+{
+	size_t j, count, inserted, capacity, valid, deleted, limit, previous[3U];
+	hash_set64_t *instance = NULL;
+	hash_options_t options;
+	uint8_t *test;
+	int resize, overflow;
+	errno_t error;
+
+	random_t random;
+	random_init(&random);
+
+	UNUSED(hash_set);
+
+	test = (uint8_t*) malloc(HASH_COUNT * sizeof(uint8_t));
+	if (!test)
+	{
+		abort(); /*malloc has failed!*/
+	}
+
+	for (resize = HASHSET_RESIZE_BLOCKING; resize <= HASHSET_RESIZE_INCREMENTAL; ++resize)
+	{
+		memset(&options, 0, sizeof(hash_options_t));
+		options.engine = HASHSET_ENGINE_ROBINHOOD;
+		options.resize = (hash_resize_t)resize;
+
+		/* at this load factor, the probe distance of some item exceeds DIST_MAX long before the table is full */
+		instance = hash_set_create_ex64(1U, 1.0, random_next(&random), &options);
+		if (!instance)
+		{
+			puts("Allocation has failed!");
+			goto failure;
+		}
+
+		/* a table that grows before its limit has been reached can only have run out of probe distance */
+		memset(test, 0, HASH_COUNT * sizeof(uint8_t));
+		memset(previous, 0, sizeof(previous));
+		for (inserted = 0U, overflow = 0; (inserted < HASH_COUNT) && (!overflow); ++inserted)
+		{
+			if ((error = hash_set_insert64(instance, (uint64_t)inserted)))
+			{
+				printf("Insert operation has failed! (error: %d)\n", error);
+				goto failure;
+			}
+			test[inserted] = 1U;
+			if (!hash_set_info64(instance, &capacity, &valid, NULL, &limit))
+			{
+				overflow = previous[0U] && (capacity != previous[0U]) && (previous[1U] + 1U < previous[2U]);
+				previous[0U] = capacity;
+				previous[1U] = valid;
+				previous[2U] = limit;
+			}
+		}
+
+		if (!overflow)
+		{
+			puts("The probe distance has not overflowed!");
+			goto failure;
+		}
+
+		count = inserted;
+		if ((verify_contents(instance, test, count) != EXIT_SUCCESS) || (remove_random(instance, test, &count, &random) != EXIT_SUCCESS))
+		{
+			goto failure;
+		}
+
+		for (j = 0U; j < inserted; ++j)
+		{
+			if (!test[j])
+			{
+				if ((error = hash_set_insert64(instance, (uint64_t)j)))
+				{
+					printf("Insert operation has failed! (error: %d)\n", error);
+					goto failure;
+				}
+				test[j] = 1U;
+				++count;
+			}
+		}
+
+		if (verify_contents(instance, test, count) != EXIT_SUCCESS)
+		{
+			goto failure;
+		}
+
+		if (!hash_set_info64(instance, &capacity, &valid, &deleted, &limit))
+		{
+			fprintf(stdout, "[SET %d/%d] resize: %d, inserted: %010zu, capacity: %010zu, valid: %010zu, deleted: %010zu, limit: %010zu\n", 23, TEST_COUNT, resize, inserted, capacity, valid, deleted, limit);
+		}
+
+		hash_set_destroy64(instance);
+		instance = NULL;
+	}
+
+	free(test);
+
+	puts("---------");
+	return EXIT_SUCCESS;
+
+failure:
+	if (instance)
+	{
+		hash_set_destroy64(instance);
+	}
+	free(test);
+	return EXIT_FAILURE;
+}
@@ -24,7 +24,7 @@ uint64_t clock_query(void)
     struct timespec spec;
     if (!clock_gettime(CLOCK_MONOTONIC, &spec))
     {
-        return (((uint64_t)spec.tv_sec) * UINT64_C(1000000)) + (((uint64_t)spec.tv_nsec) / UINT64_C(10000));
+        return (((uint64_t)spec.tv_sec) * UINT64_C(1000000)) + (((uint64_t)spec.tv_nsec) / UINT64_C(1000));
     }
 #endif
     abort();